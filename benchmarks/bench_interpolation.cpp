@@ -0,0 +1,104 @@
+/**
+ * Throughput of PolarTable<double> interpolation against the number of dimensions
+ *
+ * For each number of dimensions, the compile time dimension interpolator (up to 6 dimensions) and the runtime
+ * dimension interpolator Interpolator<double, 0> are run on the same table and the same random points, as well as the
+ * tensor product cubic interpolation (CUBIC, slopes computed beforehand).
+ *
+ * Usage: bench_interpolation [n_points]
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <fmt/format.h>
+
+#include "poem/poem.h"
+
+using namespace poem;
+
+std::shared_ptr<PolarTable<double>> make_polar_table(size_t ndims, size_t n_values) {
+  std::vector<std::shared_ptr<Dimension>> dimensions;
+  for (size_t idim = 0; idim < ndims; ++idim) {
+    dimensions.push_back(make_dimension("DIM_" + std::to_string(idim), "-", "Dimension"));
+  }
+  auto dimension_grid = make_dimension_grid(make_dimension_set(dimensions));
+  std::vector<double> values(n_values);
+  for (size_t i = 0; i < n_values; ++i) {
+    values[i] = (double) i * (double) i;  // Non uniform sampling
+  }
+  for (size_t idim = 0; idim < ndims; ++idim) {
+    dimension_grid->set_values("DIM_" + std::to_string(idim), values);
+  }
+
+  auto polar_table = make_polar_table_double("BENCH", "-", "Benchmark", dimension_grid);
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> distribution(0., 1.);
+  for (size_t idx = 0; idx < polar_table->size(); ++idx) {
+    polar_table->set_value(idx, distribution(generator));
+  }
+  return polar_table;
+}
+
+template<class Func>
+double timeit(Func &&func) {
+  auto start = std::chrono::steady_clock::now();
+  func();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char *argv[]) {
+  size_t n_points = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+  fmt::print("{:>5} {:>10} {:>12} {:>16} {:>16} {:>16}\n",
+             "ndims", "size", "n_points", "fixed (Mpts/s)", "runtime (Mpts/s)", "cubic (Mpts/s)");
+
+  for (size_t ndims = 1; ndims <= 9; ++ndims) {
+    // Keeping tables of reasonable size
+    size_t n_values = ndims <= 3 ? 20 : ndims <= 6 ? 8 : 4;
+    auto polar_table = make_polar_table(ndims, n_values);
+    double max = (double) (n_values - 1) * (double) (n_values - 1);
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> distribution(0., max);
+    std::vector<std::vector<double>> coords(ndims, std::vector<double>(n_points));
+    std::vector<const double *> coords_ptr(ndims);
+    for (size_t idim = 0; idim < ndims; ++idim) {
+      for (auto &coord: coords[idim]) {
+        coord = distribution(generator);
+      }
+      coords_ptr[idim] = coords[idim].data();
+    }
+    std::vector<double> results(n_points);
+
+    std::string fixed = "-";
+    std::string cubic = "-";
+    if (ndims <= 6) {
+      polar_table->warm_up();
+      double elapsed = timeit([&]() {
+        polar_table->interp_batch(coords_ptr, n_points, results.data(), ERROR);
+      });
+      fixed = fmt::format("{:.2f}", 1e-6 * (double) n_points / elapsed);
+
+      polar_table->set_interpolation_method(CUBIC);
+      polar_table->warm_up();
+      elapsed = timeit([&]() {
+        polar_table->interp_batch(coords_ptr, n_points, results.data(), ERROR);
+      });
+      cubic = fmt::format("{:.2f}", 1e-6 * (double) n_points / elapsed);
+    }
+
+    Interpolator<double, 0> interpolator(polar_table.get());
+    interpolator.build();
+    double elapsed = timeit([&]() {
+      interpolator.interp_batch(coords_ptr, n_points, results.data(), ERROR);
+    });
+
+    fmt::print("{:>5} {:>10} {:>12} {:>16} {:>16.2f} {:>16}\n",
+               ndims, polar_table->size(), n_points, fixed, 1e-6 * (double) n_points / elapsed, cubic);
+  }
+
+  return 0;
+}
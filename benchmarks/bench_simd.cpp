@@ -0,0 +1,93 @@
+/**
+ * Throughput of PolarTable<double>::interp_batch for each instruction set supported by the CPU
+ *
+ * Tables have the 5-D shape of MPPP/HPPP polars (STW, TWS, TWA, WA, Hs), with a coarse and a fine sampling. The
+ * maximum difference with the scalar kernel is reported, it must be 0.
+ *
+ * Usage: bench_simd [n_points]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <fmt/format.h>
+#include <MathUtils/VectorGeneration.h>
+
+#include "poem/poem.h"
+
+using namespace poem;
+
+std::shared_ptr<PolarTable<double>> make_polar_table(size_t n_STW, size_t n_TWS, size_t n_TWA, size_t n_WA,
+                                                     size_t n_Hs) {
+  auto STW = make_dimension("STW", "kt", "Speed Through Water");
+  auto TWS = make_dimension("TWS", "kt", "True Wind Speed");
+  auto TWA = make_dimension("TWA", "deg", "True Wind Angle");
+  auto WA = make_dimension("WA", "deg", "Mean Waves Angle");
+  auto Hs = make_dimension("Hs", "m", "Wave Significant Height");
+
+  auto dimension_grid = make_dimension_grid(make_dimension_set({STW, TWS, TWA, WA, Hs}));
+  dimension_grid->set_values("STW", mathutils::linspace<double>(8, 20, n_STW));
+  dimension_grid->set_values("TWS", mathutils::linspace<double>(0, 40, n_TWS));
+  dimension_grid->set_values("TWA", mathutils::linspace<double>(0, 180, n_TWA));
+  dimension_grid->set_values("WA", mathutils::linspace<double>(0, 180, n_WA));
+  dimension_grid->set_values("Hs", mathutils::linspace<double>(0, 8, n_Hs));
+
+  auto polar_table = make_polar_table_double("TOTAL_POWER", "kW", "Total Power Consumption", dimension_grid);
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> distribution(0., 10000.);
+  for (size_t idx = 0; idx < polar_table->size(); ++idx) {
+    polar_table->set_value(idx, distribution(generator));
+  }
+  return polar_table;
+}
+
+int main(int argc, char *argv[]) {
+  size_t n_points = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+  fmt::print("Detected instruction set: {}\n\n", simd_instruction_set_to_string(simd_detected_instruction_set()));
+  fmt::print("{:>16} {:>10} {:>8} {:>10} {:>10}\n", "shape", "size", "isa", "Mpts/s", "max diff");
+
+  for (const auto &shape: std::vector<std::array<size_t, 5>>{{13, 9, 13, 13, 9}, {25, 21, 37, 37, 17}}) {
+    auto polar_table = make_polar_table(shape[0], shape[1], shape[2], shape[3], shape[4]);
+    auto dimension_grid = polar_table->dimension_grid();
+
+    std::mt19937 generator(0);
+    std::vector<std::vector<double>> coords(5, std::vector<double>(n_points));
+    std::vector<const double *> coords_ptr(5);
+    for (size_t idim = 0; idim < 5; ++idim) {
+      std::uniform_real_distribution<double> distribution(dimension_grid->min(idim), dimension_grid->max(idim));
+      for (auto &coord: coords[idim]) {
+        coord = distribution(generator);
+      }
+      coords_ptr[idim] = coords[idim].data();
+    }
+
+    std::vector<double> reference(n_points);
+    std::vector<double> results(n_points);
+    polar_table->warm_up();
+
+    for (auto instruction_set: {SIMD_SCALAR, SIMD_AVX2, SIMD_AVX512}) {
+      if (!simd_supported(instruction_set)) continue;
+      set_simd_instruction_set(instruction_set);
+
+      auto &values = instruction_set == SIMD_SCALAR ? reference : results;
+      auto start = std::chrono::steady_clock::now();
+      polar_table->interp_batch(coords_ptr, n_points, values.data(), ERROR);
+      double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      double max_diff = 0.;
+      for (size_t i = 0; i < n_points; ++i) {
+        max_diff = std::max(max_diff, std::abs(values[i] - reference[i]));
+      }
+
+      fmt::print("{:>16} {:>10} {:>8} {:>10.2f} {:>10}\n",
+                 fmt::format("{}x{}x{}x{}x{}", shape[0], shape[1], shape[2], shape[3], shape[4]),
+                 polar_table->size(), simd_instruction_set_to_string(instruction_set),
+                 1e-6 * (double) n_points / elapsed, max_diff);
+    }
+  }
+
+  set_simd_instruction_set(simd_detected_instruction_set());
+  return 0;
+}
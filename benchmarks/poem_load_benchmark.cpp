@@ -0,0 +1,91 @@
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+#include <argparse/argparse.hpp>
+#include <poem/poem.h>
+#include <poem/parallel.h>
+
+using namespace poem;
+
+/**
+ * Cold start time of load, PolarTable values being read by the netCDF library or by parallel chunk decompression, and
+ * of load_snapshot on a snapshot of the same file
+ */
+int main(int argc, char *argv[]) {
+
+  argparse::ArgumentParser program("poem_load_benchmark", git::version_full());
+
+  program.add_argument("input_file").help("input POEM File");
+  program.add_argument("-n", "--n_threads")
+      .help("number of threads inflating chunks, 0 for one thread per hardware core")
+      .default_value(size_t(0))
+      .scan<'u', size_t>();
+  program.add_argument("-r", "--repeat")
+      .help("number of loads of each path")
+      .default_value(size_t(3))
+      .scan<'u', size_t>();
+
+  // Parsing command line arguments
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    std::exit(1);
+  }
+
+  std::string filename = fs::canonical(fs::path(program.get<std::string>("input_file")));
+  auto n_threads = program.get<size_t>("--n_threads");
+  auto repeat = program.get<size_t>("--repeat");
+
+  auto best_time = [&](size_t n_threads_, std::shared_ptr<PolarNode> &polar_node) {
+    double best = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < repeat; ++i) {
+      auto start = std::chrono::steady_clock::now();
+      polar_node = load(filename, false, false, false, false, n_threads_);
+      std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+      best = std::min(best, elapsed.count());
+    }
+    return best;
+  };
+
+  std::shared_ptr<PolarNode> netcdf_node, chunk_node;
+  double netcdf_time = best_time(1, netcdf_node);
+  double chunk_time = best_time(n_threads, chunk_node);
+
+  std::cout << "netCDF library:               " << netcdf_time << " ms" << std::endl;
+  std::cout << "Parallel chunk decompression: " << chunk_time << " ms (" << get_n_threads(n_threads) << " threads)"
+            << std::endl;
+  std::cout << "Speedup:                      " << netcdf_time / chunk_time << std::endl;
+
+  auto snapshot_filename = (fs::temp_directory_path() / (fs::path(filename).stem().string() + ".poem")).string();
+  to_snapshot(netcdf_node, snapshot_filename);
+  std::shared_ptr<PolarNode> snapshot_node;
+  double snapshot_time = std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < repeat; ++i) {
+    snapshot_node.reset();
+    auto start = std::chrono::steady_clock::now();
+    snapshot_node = load_snapshot(snapshot_filename, false, false);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    snapshot_time = std::min(snapshot_time, elapsed.count());
+  }
+  std::cout << "Memory mapped snapshot:       " << snapshot_time << " ms (" << fs::file_size(snapshot_filename)
+            << " bytes)" << std::endl;
+
+  bool equal = *netcdf_node == *chunk_node;
+  std::vector<std::shared_ptr<PolarTableBase>> netcdf_tables, snapshot_tables;
+  netcdf_node->polar_tables(netcdf_tables);
+  snapshot_node->polar_tables(snapshot_tables);
+  equal &= netcdf_tables.size() == snapshot_tables.size();
+  for (size_t i = 0; equal && i < netcdf_tables.size(); ++i) {
+    equal &= *netcdf_tables[i] == *snapshot_tables[i];
+  }
+  fs::remove(snapshot_filename);
+  if (!equal) {
+    std::cerr << "Values differ between the paths" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,199 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include <argparse/argparse.hpp>
+#include <poem/poem.h>
+
+using namespace poem;
+
+namespace {
+
+  std::vector<double> linspace(double start, double stop, size_t n) {
+    std::vector<double> values(n);
+    for (size_t i = 0; i < n; ++i) {
+      values[i] = start + (stop - start) * (double) i / (double) (n - 1);
+    }
+    return values;
+  }
+
+  /**
+   * PolarSet with a MPPP Polar over STW, TWS, TWA, WA and Hs, holding smooth power and leeway tables with some noise
+   */
+  std::shared_ptr<PolarSet> make_5d_polar_set(size_t n_stw) {
+    auto dimension_set = make_dimension_set({make_dimension("STW_dim", "kt", "Speed Through Water"),
+                                             make_dimension("TWS_dim", "kt", "True Wind Speed"),
+                                             make_dimension("TWA_dim", "deg", "True Wind Angle"),
+                                             make_dimension("WA_dim", "deg", "Waves Angle"),
+                                             make_dimension("Hs_dim", "m", "Waves Significant Height")});
+    auto dimension_grid = make_dimension_grid(dimension_set);
+    dimension_grid->set_values("STW_dim", linspace(0, 20, n_stw));
+    dimension_grid->set_values("TWS_dim", linspace(0, 60, 16));
+    dimension_grid->set_values("TWA_dim", linspace(0, 180, 37));
+    dimension_grid->set_values("WA_dim", linspace(0, 180, 13));
+    dimension_grid->set_values("Hs_dim", linspace(0, 8, 9));
+
+    auto polar_set = make_polar_set("vessel", "Synthetic 5D polar");
+    polar_set->create_polar(MPPP, dimension_grid);
+    auto polar = polar_set->polar(MPPP);
+    auto total_power = polar->create_polar_table<double>("TOTAL_POWER", "kW", "Total Power", POEM_DOUBLE);
+    auto leeway = polar->create_polar_table<double>("LEEWAY", "deg", "Leeway", POEM_DOUBLE);
+    auto solver_status = polar->create_polar_table<int>("SOLVER_STATUS", "-", "Solver Status", POEM_INT);
+
+    std::mt19937 generator(42);
+    std::normal_distribution<double> noise(0., 1e-3);
+
+    std::vector<double> total_power_values(dimension_grid->size());
+    std::vector<double> leeway_values(dimension_grid->size());
+    std::vector<int> solver_status_values(dimension_grid->size());
+    const auto &dimension_points = dimension_grid->dimension_points();
+    for (size_t i = 0; i < dimension_grid->size(); ++i) {
+      auto point = dimension_points[i];
+      double stw = point[0], tws = point[1], twa = point[2] * M_PI / 180, wa = point[3] * M_PI / 180, hs = point[4];
+      total_power_values[i] = 5 * std::pow(stw, 3) * (1 + 0.05 * hs * std::cos(wa)) - 20 * tws * std::cos(twa)
+                              + noise(generator);
+      leeway_values[i] = 0.1 * tws * std::sin(twa) / (1 + stw) + noise(generator);
+      solver_status_values[i] = total_power_values[i] < 0 ? -1 : 1;
+    }
+    total_power->set_values(total_power_values);
+    leeway->set_values(leeway_values);
+    solver_status->set_values(solver_status_values);
+
+    return polar_set;
+  }
+
+  template<class F>
+  double best_time(size_t repeat, F &&f) {
+    double best = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < repeat; ++i) {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+      best = std::min(best, elapsed.count());
+    }
+    return best;
+  }
+
+}  // namespace
+
+/**
+ * File size and read latencies of a 5D polar written with different chunk shapes and compressions
+ */
+int main(int argc, char *argv[]) {
+
+  argparse::ArgumentParser program("poem_write_benchmark", git::version_full());
+
+  program.add_argument("-o", "--output_dir")
+      .help("directory where benchmark files are written")
+      .default_value(std::string("."));
+  program.add_argument("--n_stw")
+      .help("number of STW values of the synthetic polar, scaling its size")
+      .default_value(size_t(41))
+      .scan<'u', size_t>();
+  program.add_argument("-n", "--n_threads")
+      .help("number of threads inflating chunks for the parallel full load, 0 for one thread per hardware core")
+      .default_value(size_t(0))
+      .scan<'u', size_t>();
+  program.add_argument("-r", "--repeat")
+      .help("number of repetitions of each measure")
+      .default_value(size_t(3))
+      .scan<'u', size_t>();
+
+  // Parsing command line arguments
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    std::exit(1);
+  }
+
+  fs::path output_dir(program.get<std::string>("--output_dir"));
+  auto n_threads = program.get<size_t>("--n_threads");
+  auto repeat = program.get<size_t>("--repeat");
+
+  auto polar_set = make_5d_polar_set(program.get<size_t>("--n_stw"));
+  auto dimension_grid = polar_set->polar(MPPP)->dimension_grid();
+  auto shape = dimension_grid->shape();
+
+  std::vector<std::pair<std::string, WriteOptions>> configurations;
+  configurations.emplace_back("default", WriteOptions());
+  {
+    WriteOptions write_options;
+    write_options.polar_tables = StorageOptions::whole({"STW_dim", "TWA_dim"});
+    configurations.emplace_back("STWxTWA planes, level 5", write_options);
+  }
+  {
+    WriteOptions write_options;
+    write_options.polar_tables = StorageOptions::whole({"STW_dim", "TWA_dim"}, 1);
+    configurations.emplace_back("STWxTWA planes, level 1", write_options);
+  }
+  {
+    WriteOptions write_options;
+    write_options.polar_tables = StorageOptions::whole({"STW_dim", "TWA_dim"}, 5, false);
+    configurations.emplace_back("STWxTWA planes, no shuffle", write_options);
+  }
+  {
+    WriteOptions write_options;
+    write_options.polar_tables = StorageOptions::whole({"STW_dim", "TWS_dim", "TWA_dim"});
+    configurations.emplace_back("STWxTWSxTWA volumes", write_options);
+  }
+  {
+    WriteOptions write_options;
+    write_options.polar_tables = StorageOptions::uncompressed();
+    write_options.coordinates = StorageOptions::uncompressed();
+    configurations.emplace_back("uncompressed", write_options);
+  }
+
+  std::cout << "5D polar of shape";
+  for (auto size: shape) std::cout << " " << size;
+  std::cout << ", " << dimension_grid->size() * (2 * sizeof(double) + sizeof(int)) / (1 << 20) << " MiB of values"
+            << std::endl << std::endl;
+
+  std::cout << std::left << std::setw(30) << "configuration" << std::right
+            << std::setw(12) << "size (KiB)"
+            << std::setw(14) << "write (ms)"
+            << std::setw(14) << "load (ms)"
+            << std::setw(18) << "load par. (ms)"
+            << std::setw(18) << "plane read (ms)" << std::endl;
+
+  // Planes of TOTAL_POWER read by partial reads, along STW and TWA at given TWS, WA and Hs
+  std::vector<size_t> start(shape.size(), 0), count(shape);
+  count[1] = count[3] = count[4] = 1;
+  std::vector<double> plane(count[0] * count[2]);
+  std::mt19937 generator(0);
+
+  for (size_t iconfiguration = 0; iconfiguration < configurations.size(); ++iconfiguration) {
+    const auto &[name, write_options] = configurations[iconfiguration];
+    auto filename = (output_dir / ("poem_write_benchmark_" + std::to_string(iconfiguration) + ".nc")).string();
+
+    double write_time = best_time(repeat, [&]() {
+      to_netcdf(polar_set, "vessel", filename, false, write_options);
+    });
+    double load_time = best_time(repeat, [&]() { load(filename, false, false, false, false, 1); });
+    double parallel_load_time = best_time(repeat, [&]() { load(filename, false, false, false, false, n_threads); });
+
+    double plane_time = best_time(repeat, [&]() {
+      netCDF::NcFile data_file(filename, netCDF::NcFile::read);
+      auto nc_var = data_file.getGroup("MPPP").getVar("TOTAL_POWER");
+      start[1] = generator() % shape[1];
+      start[3] = generator() % shape[3];
+      start[4] = generator() % shape[4];
+      nc_var.getVar(start, count, plane.data());
+    });
+
+    std::cout << std::left << std::setw(30) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << (double) fs::file_size(filename) / 1024
+              << std::setw(14) << write_time
+              << std::setw(14) << load_time
+              << std::setw(18) << parallel_load_time
+              << std::setw(18) << plane_time << std::endl;
+
+    fs::remove(filename);
+  }
+
+  return 0;
+}
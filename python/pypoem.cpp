@@ -5,6 +5,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
+#include <optional>
 #include "poem/poem.h"
 
 #define STRINGIFY(x) #x
@@ -45,6 +46,100 @@ inline py::memoryview vector2memoryview(std::vector<T> &vector, const std::vecto
   );
 }
 
+using PointsDict = std::unordered_map<std::string, py::array_t<double, py::array::c_style | py::array::forcecast>>;
+
+/**
+ * Gather the arrays of a batch of points given as a dictionary of arrays (one per dimension name) in the DimensionSet
+ * order of dimension_grid. Returns the number of points. name is the name of the queried object, for error messages.
+ */
+inline size_t points_dict2coords(const std::string &name,
+                                 const poem::DimensionGrid &dimension_grid,
+                                 const PointsDict &points_dict,
+                                 std::vector<const double *> &coords,
+                                 const std::string &function_name) {
+  if (points_dict.size() != dimension_grid.ndims()) {
+    LogCriticalError("In {} of dimension {}, {} function called with incorrect number of arrays {}",
+                     name, dimension_grid.ndims(), function_name, points_dict.size());
+    CRITICAL_ERROR_POEM
+  }
+
+  coords.clear();
+  coords.reserve(dimension_grid.ndims());
+  py::ssize_t n_points = -1;
+  for (const auto &dimension: *dimension_grid.dimension_set()) {
+    const auto &array = points_dict.at(dimension->name());
+    if (n_points >= 0 && array.size() != n_points) {
+      LogCriticalError("In {}, {} function called with arrays of different sizes", name, function_name);
+      CRITICAL_ERROR_POEM
+    }
+    n_points = array.size();
+    coords.push_back(array.data());
+  }
+  return n_points < 0 ? 0 : n_points;
+}
+
+using OutOfBoundDict = std::unordered_map<std::string, std::string>;
+
+/**
+ * Out of bound policy from a dictionary of out of bound methods (one per dimension name) and a default method
+ */
+inline poem::OutOfBoundPolicy oob_dict2policy(const OutOfBoundDict &oob_dict, const std::string &default_oob_method) {
+  poem::OutOfBoundPolicy oob_policy(poem::string_to_outofbound_method(default_oob_method));
+  for (const auto &pair: oob_dict) {
+    oob_policy.set(pair.first, poem::string_to_outofbound_method(pair.second));
+  }
+  return oob_policy;
+}
+
+/**
+ * Non throwing query of a PolarTable at a point given as a dictionary. Returns the value and the status.
+ */
+template<typename T>
+inline std::pair<T, poem::QUERY_STATUS> polar_table_query(const poem::PolarTable<T> &self,
+                                                          const std::unordered_map<std::string, double> &point_dict,
+                                                          const OutOfBoundDict &oob_dict,
+                                                          const std::string &default_oob_method) {
+  if (point_dict.size() != self.dim()) {
+    LogCriticalError("In PolarTable {} of dimension {}, query function called with incorrect number of values {}",
+                     self.name(), self.dim(), point_dict.size());
+    CRITICAL_ERROR_POEM
+  }
+
+  auto dimension_set = self.dimension_grid()->dimension_set();
+  std::vector<double> array(self.dim());
+  size_t i = 0;
+  for (const auto &dimension: *dimension_set) {
+    array[i] = point_dict.at(dimension->name());
+    i++;
+  }
+
+  T value;
+  auto status = self.query(poem::DimensionPoint(dimension_set, array), oob_dict2policy(oob_dict, default_oob_method),
+                           value);
+  return {value, status};
+}
+
+/**
+ * Non throwing query of a PolarTable at a batch of points given as a dictionary of arrays. Returns the values and the
+ * statuses (as QUERY_STATUS integer values).
+ */
+template<typename T>
+inline std::pair<py::array_t<T>, py::array_t<int>> polar_table_query_batch(const poem::PolarTable<T> &self,
+                                                                            const PointsDict &points_dict,
+                                                                            const OutOfBoundDict &oob_dict,
+                                                                            const std::string &default_oob_method) {
+  std::vector<const double *> coords;
+  size_t n_points = points_dict2coords(self.name(), *self.dimension_grid(), points_dict, coords, "query_batch");
+
+  py::array_t<T> values(n_points);
+  std::vector<poem::QUERY_STATUS> statuses(n_points);
+  self.query_batch(coords, n_points, values.mutable_data(), statuses.data(),
+                   oob_dict2policy(oob_dict, default_oob_method));
+
+  py::array_t<int> statuses_array(n_points);
+  std::copy(statuses.begin(), statuses.end(), statuses_array.mutable_data());
+  return {values, statuses_array};
+}
 
 // ===================================================================================================================
 // Python module definition
@@ -80,10 +175,22 @@ PYBIND11_MODULE(pypoem, m) {
   Dimension.doc() = R"pbdoc(A Dimension is a named coordinate for a DimensionGrid)pbdoc";
   Dimension.def(py::init<const std::string &, const std::string &, const std::string &>());
   Dimension.def("name", &poem::Dimension::name, R"pbdoc(Get the name of the Dimension)pbdoc");
+  Dimension.def("periodicity", [](const poem::Dimension &self) -> std::string {
+                  return poem::dimension_periodicity_to_string(self.periodicity());
+                },
+                R"pbdoc(Get the periodicity of the Dimension (non_periodic, periodic or symmetric))pbdoc");
+  Dimension.def("period", &poem::Dimension::period, R"pbdoc(Get the period of a periodic Dimension)pbdoc");
 
-  m.def("make_dimension", &poem::make_dimension,
-        R"pbdoc(Build a Dimension)pbdoc",
-        "name"_a, "unit"_a, "description"_a);
+  m.def("make_dimension", [](const std::string &name,
+                             const std::string &unit,
+                             const std::string &description,
+                             const std::string &periodicity,
+                             double period) -> std::shared_ptr<poem::Dimension> {
+          return poem::make_dimension(name, unit, description, poem::string_to_dimension_periodicity(periodicity),
+                                      period);
+        },
+        R"pbdoc(Build a Dimension, periodicity being non_periodic, periodic or symmetric)pbdoc",
+        "name"_a, "unit"_a, "description"_a, "periodicity"_a = "non_periodic", "period"_a = 360.);
 
   // ===================================================================================================================
   // DimensionSet
@@ -103,7 +210,9 @@ PYBIND11_MODULE(pypoem, m) {
   py::class_<poem::DimensionGrid, std::shared_ptr<poem::DimensionGrid>> DimensionGrid(m, "DimensionGrid");
   DimensionGrid.doc() = R"pbdoc("A DimensionGrid is a numerical realisation of a DimensionSet.
                                  Each Dimension of the associated DimensionSet is given a numerical sampling.")pbdoc";
-  DimensionGrid.def("set_values", &poem::DimensionGrid::set_values,
+  DimensionGrid.def("set_values",
+                    py::overload_cast<const std::string &, const std::vector<double> &>(
+                        &poem::DimensionGrid::set_values),
                     R"pbdoc("Set a values vector for the specified Dimension")pbdoc",
                     "dimension_name"_a, "sampling_vector"_a);
   DimensionGrid.def("ndims", &poem::DimensionGrid::ndims,
@@ -158,6 +267,28 @@ PYBIND11_MODULE(pypoem, m) {
                       R"pbdoc(int datatype)pbdoc");
   POEM_DATATYPE.export_values();
 
+  py::enum_<poem::QUERY_STATUS> QUERY_STATUS(m, "QUERY_STATUS");
+  QUERY_STATUS.value("IN_RANGE", poem::IN_RANGE,
+                     R"pbdoc(Every coordinate is in range)pbdoc");
+  QUERY_STATUS.value("SATURATED", poem::SATURATED,
+                     R"pbdoc(At least one coordinate has been saturated)pbdoc");
+  QUERY_STATUS.value("EXTRAPOLATED", poem::EXTRAPOLATED,
+                     R"pbdoc(At least one coordinate has been extrapolated)pbdoc");
+  QUERY_STATUS.value("REJECTED", poem::REJECTED,
+                     R"pbdoc(At least one coordinate is out of range with error method, or is NaN)pbdoc");
+  QUERY_STATUS.export_values();
+
+  py::enum_<poem::VELOCITY_INVERSION_STATUS> VELOCITY_INVERSION_STATUS(m, "VELOCITY_INVERSION_STATUS");
+  VELOCITY_INVERSION_STATUS.value("INVERSION_SUCCESS", poem::INVERSION_SUCCESS,
+                                  R"pbdoc(The power is reached within the STW range)pbdoc");
+  VELOCITY_INVERSION_STATUS.value("POWER_BELOW_RANGE", poem::POWER_BELOW_RANGE,
+                                  R"pbdoc(The power is lower than the power at the lowest valid STW)pbdoc");
+  VELOCITY_INVERSION_STATUS.value("POWER_ABOVE_RANGE", poem::POWER_ABOVE_RANGE,
+                                  R"pbdoc(The power is higher than the power at the highest valid STW)pbdoc");
+  VELOCITY_INVERSION_STATUS.value("NO_VALID_POINT", poem::NO_VALID_POINT,
+                                  R"pbdoc(No valid point along STW)pbdoc");
+  VELOCITY_INVERSION_STATUS.export_values();
+
   py::enum_<poem::POLAR_MODE> POLAR_MODE(m, "POLAR_MODE");
 //  POLAR_MODE.doc() =
 //      R"pbdoc("A POLAR_MODE is a specific type of POLAR that define the type prediction used to build the polar data")pbdoc";
@@ -274,6 +405,13 @@ PYBIND11_MODULE(pypoem, m) {
                 R"pbdoc(Returns a json string as a layout for the tree starting at current PolarNode)pbdoc",
                 "indent"_a = -1);
 
+  PolarNode.def("prepare", &poem::PolarNode::prepare,
+                R"pbdoc(Builds interpolators of every PolarTable of the tree, in parallel)pbdoc",
+                "n_threads"_a = 0);
+  PolarNode.def("pack", &poem::PolarNode::pack,
+                R"pbdoc(Interleaves the values of the PolarTableDouble of every Polar of the tree per grid node,
+                        for fused queries)pbdoc");
+
   PolarNode.def("attributes", py::overload_cast<>(&poem::PolarNode::attributes),
                 py::return_value_policy::reference,
                 R"pbdoc(Get a PolarNode from path)pbdoc");
@@ -287,6 +425,26 @@ PYBIND11_MODULE(pypoem, m) {
         R"pbdoc("Build a PolarNode")pbdoc",
         "name"_a, "description"_a);
 
+  // ===================================================================================================================
+  // QueryCache
+  // ===================================================================================================================
+  py::class_<poem::QueryCache, std::shared_ptr<poem::QueryCache>> QueryCache(m, "QueryCache");
+  QueryCache.doc() = R"pbdoc("Bounded memoization cache of queries keyed by quantized coordinates")pbdoc";
+  QueryCache.def("capacity", &poem::QueryCache::capacity,
+                 R"pbdoc("Maximum number of entries")pbdoc");
+  QueryCache.def("size", &poem::QueryCache::size,
+                 R"pbdoc("Number of entries held")pbdoc");
+  QueryCache.def("hits", &poem::QueryCache::hits,
+                 R"pbdoc("Number of queries served by the cache")pbdoc");
+  QueryCache.def("misses", &poem::QueryCache::misses,
+                 R"pbdoc("Number of queries computed")pbdoc");
+  QueryCache.def("hit_rate", &poem::QueryCache::hit_rate,
+                 R"pbdoc("Fraction of the queries served by the cache")pbdoc");
+  QueryCache.def("reset_counters", &poem::QueryCache::reset_counters,
+                 R"pbdoc("Reset the hit and miss counters")pbdoc");
+  QueryCache.def("clear", &poem::QueryCache::clear,
+                 R"pbdoc("Remove every entry")pbdoc");
+
   // ===================================================================================================================
   // PolarTable<T>
   // ===================================================================================================================
@@ -310,6 +468,16 @@ PYBIND11_MODULE(pypoem, m) {
                          self.set_values(ndarray2stdvector<double>(array));
                        },
                        R"pbdoc()pbdoc");
+  PolarTableDouble.def("jit_load", &poem::PolarTable<double>::jit_load,
+                     R"pbdoc(Fetches the values of the PolarTableDouble from its file if not resident)pbdoc");
+  PolarTableDouble.def("jit_unload", &poem::PolarTable<double>::jit_unload,
+                     R"pbdoc(Releases the values and interpolators of a PolarTableDouble loaded with jit, to be fetched back at next access)pbdoc");
+  PolarTableDouble.def("is_loaded", &poem::PolarTable<double>::is_loaded,
+                     R"pbdoc(Tells if the values of the PolarTableDouble are resident)pbdoc");
+  PolarTableDouble.def("has_jit_loader", &poem::PolarTable<double>::has_jit_loader,
+                     R"pbdoc(Tells if the values of the PolarTableDouble can be fetched back from its file)pbdoc");
+  PolarTableDouble.def("memsize", &poem::PolarTable<double>::memsize,
+                     R"pbdoc(Resident memory of the PolarTableDouble in bytes)pbdoc");
   PolarTableDouble.def("set_value",
                        py::overload_cast<std::vector<size_t>, const double &>(&poem::PolarTable<double>::set_value));
   PolarTableDouble.def("array",
@@ -356,7 +524,8 @@ PYBIND11_MODULE(pypoem, m) {
                        "point_dict"_a, "oob_method"_a = "error");
   PolarTableDouble.def("interp", [](const poem::PolarTable<double> &self,
                                     const std::unordered_map<std::string, double> &point_dict,
-                                    const std::string &oob_method) -> double {
+                                    const std::string &oob_method,
+                                    const std::optional<std::string> &interpolation_method) -> double {
                          // TODO: tester les bornes des valeurs
                          if (point_dict.size() != self.dim()) {
                            LogCriticalError("In PolarTableDouble {} of dimension {}, "
@@ -373,10 +542,132 @@ PYBIND11_MODULE(pypoem, m) {
                            i++;
                          }
                          return self.interp(poem::DimensionPoint(dimension_set, array),
-                                            poem::string_to_outofbound_method(oob_method));
+                                            poem::string_to_outofbound_method(oob_method),
+                                            interpolation_method ?
+                                            poem::string_to_interpolation_method(*interpolation_method) :
+                                            self.interpolation_method());
                        },
                        R"pbdoc("Get an interpolated value at point_dict")pbdoc",
-                       "point_dict"_a, "oob_method"_a = "error");
+                       "point_dict"_a, "oob_method"_a = "error", "interpolation_method"_a = py::none());
+  PolarTableDouble.def("interp_batch", [](const poem::PolarTable<double> &self,
+                                          const PointsDict &points_dict,
+                                          const std::string &oob_method,
+                                          const std::optional<std::string> &interpolation_method)
+                           -> py::array_t<double> {
+                         std::vector<const double *> coords;
+                         size_t n_points = points_dict2coords(self.name(), *self.dimension_grid(), points_dict, coords,
+                                                              "interp_batch");
+
+                         py::array_t<double> values(n_points);
+                         self.interp_batch(coords, n_points, values.mutable_data(),
+                                           poem::string_to_outofbound_method(oob_method),
+                                           interpolation_method ?
+                                           poem::string_to_interpolation_method(*interpolation_method) :
+                                           self.interpolation_method());
+                         return values;
+                       },
+                       R"pbdoc("Get interpolated values at a batch of points given as a dictionary of arrays")pbdoc",
+                       "points_dict"_a, "oob_method"_a = "error", "interpolation_method"_a = py::none());
+  PolarTableDouble.def("interp_with_gradient", [](const poem::PolarTable<double> &self,
+                                                  const std::unordered_map<std::string, double> &point_dict,
+                                                  const std::string &oob_method,
+                                                  const std::optional<std::string> &interpolation_method)
+                           -> std::pair<double, std::unordered_map<std::string, double>> {
+                         if (point_dict.size() != self.dim()) {
+                           LogCriticalError("In PolarTableDouble {} of dimension {}, "
+                                            "interp_with_gradient function called with incorrect number of values {}",
+                                            self.name(), self.dim(), point_dict.size());
+                           CRITICAL_ERROR_POEM
+                         }
+
+                         auto dimension_set = self.dimension_grid()->dimension_set();
+                         std::vector<double> array(self.dim());
+                         size_t i = 0;
+                         for (const auto &dimension: *dimension_set) {
+                           array[i] = point_dict.at(dimension->name());
+                           i++;
+                         }
+                         std::vector<double> gradient(self.dim());
+                         double value = self.interp_with_gradient(poem::DimensionPoint(dimension_set, array),
+                                                                  gradient.data(),
+                                                                  poem::string_to_outofbound_method(oob_method),
+                                                                  interpolation_method ?
+                                                                  poem::string_to_interpolation_method(
+                                                                      *interpolation_method) :
+                                                                  self.interpolation_method());
+
+                         std::unordered_map<std::string, double> gradient_dict;
+                         for (size_t idim = 0; idim < self.dim(); ++idim) {
+                           gradient_dict[dimension_set->name(idim)] = gradient[idim];
+                         }
+                         return {value, gradient_dict};
+                       },
+                       R"pbdoc("Get an interpolated value at point_dict and its partial derivatives, returns (value, gradient_dict)")pbdoc",
+                       "point_dict"_a, "oob_method"_a = "error", "interpolation_method"_a = py::none());
+  PolarTableDouble.def("interp_with_gradient_batch", [](const poem::PolarTable<double> &self,
+                                                        const PointsDict &points_dict,
+                                                        const std::string &oob_method,
+                                                        const std::optional<std::string> &interpolation_method)
+                           -> std::pair<py::array_t<double>, std::unordered_map<std::string, py::array_t<double>>> {
+                         std::vector<const double *> coords;
+                         size_t n_points = points_dict2coords(self.name(), *self.dimension_grid(), points_dict, coords,
+                                                              "interp_with_gradient_batch");
+
+                         py::array_t<double> values(n_points);
+                         auto dimension_set = self.dimension_grid()->dimension_set();
+                         std::unordered_map<std::string, py::array_t<double>> gradients_dict;
+                         std::vector<double *> gradients;
+                         for (size_t idim = 0; idim < self.dim(); ++idim) {
+                           py::array_t<double> gradient(n_points);
+                           gradients.push_back(gradient.mutable_data());
+                           gradients_dict[dimension_set->name(idim)] = gradient;
+                         }
+                         self.interp_with_gradient_batch(coords, n_points, values.mutable_data(), gradients,
+                                                         poem::string_to_outofbound_method(oob_method),
+                                                         interpolation_method ?
+                                                         poem::string_to_interpolation_method(*interpolation_method) :
+                                                         self.interpolation_method());
+                         return {values, gradients_dict};
+                       },
+                       R"pbdoc("Get interpolated values and partial derivatives at a batch of points, returns (values, gradients_dict)")pbdoc",
+                       "points_dict"_a, "oob_method"_a = "error", "interpolation_method"_a = py::none());
+  PolarTableDouble.def("enable_cache", &poem::PolarTable<double>::enable_cache,
+                       R"pbdoc("Put a memoization cache in front of interp, coordinates being quantized to resolutions given per dimension name")pbdoc",
+                       "capacity"_a, "resolutions"_a = std::unordered_map<std::string, double>());
+  PolarTableDouble.def("disable_cache", &poem::PolarTable<double>::disable_cache,
+                       R"pbdoc("Remove the memoization cache")pbdoc");
+  PolarTableDouble.def("cache", &poem::PolarTable<double>::cache,
+                       R"pbdoc("Get the memoization cache, None if not enabled")pbdoc");
+  PolarTableDouble.def("interpolation_method", [](const poem::PolarTable<double> &self) -> std::string {
+                         return poem::interpolation_method_to_string(self.interpolation_method());
+                       },
+                       R"pbdoc("Get the interpolation method of the table")pbdoc");
+  PolarTableDouble.def("set_interpolation_method", [](poem::PolarTable<double> &self, const std::string &method) {
+                         self.set_interpolation_method(poem::string_to_interpolation_method(method));
+                       },
+                       R"pbdoc("Set the interpolation method of the table (linear, cubic, pchip or akima)")pbdoc",
+                       "interpolation_method"_a);
+  PolarTableDouble.def("nearest_batch", [](const poem::PolarTable<double> &self,
+                                           const PointsDict &points_dict,
+                                           const std::string &oob_method) -> py::array_t<double> {
+                         std::vector<const double *> coords;
+                         size_t n_points = points_dict2coords(self.name(), *self.dimension_grid(), points_dict, coords,
+                                                              "nearest_batch");
+
+                         py::array_t<double> values(n_points);
+                         self.nearest_batch(coords, n_points, values.mutable_data(),
+                                            poem::string_to_outofbound_method(oob_method));
+                         return values;
+                       },
+                       R"pbdoc("Get the nearest values at a batch of points given as a dictionary of arrays")pbdoc",
+                       "points_dict"_a, "oob_method"_a = "error");
+
+  PolarTableDouble.def("query", &polar_table_query<double>,
+                       R"pbdoc("Non throwing query at point_dict with per dimension out of bound methods, returns (value, status)")pbdoc",
+                       "point_dict"_a, "oob_policy"_a = OutOfBoundDict(), "default_oob_method"_a = "error");
+  PolarTableDouble.def("query_batch", &polar_table_query_batch<double>,
+                       R"pbdoc("Non throwing query at a batch of points, returns (values, statuses)")pbdoc",
+                       "points_dict"_a, "oob_policy"_a = OutOfBoundDict(), "default_oob_method"_a = "error");
 
   m.def("make_polar_table_double", &poem::make_polar_table_double,
         R"pbdoc("Build a PolarTable containing double values")pbdoc",
@@ -401,6 +692,16 @@ PYBIND11_MODULE(pypoem, m) {
                       self.set_values(ndarray2stdvector<int>(array));
                     },
                     R"pbdoc()pbdoc");
+  PolarTableInt.def("jit_load", &poem::PolarTable<int>::jit_load,
+                  R"pbdoc(Fetches the values of the PolarTableInt from its file if not resident)pbdoc");
+  PolarTableInt.def("jit_unload", &poem::PolarTable<int>::jit_unload,
+                  R"pbdoc(Releases the values and interpolators of a PolarTableInt loaded with jit, to be fetched back at next access)pbdoc");
+  PolarTableInt.def("is_loaded", &poem::PolarTable<int>::is_loaded,
+                  R"pbdoc(Tells if the values of the PolarTableInt are resident)pbdoc");
+  PolarTableInt.def("has_jit_loader", &poem::PolarTable<int>::has_jit_loader,
+                  R"pbdoc(Tells if the values of the PolarTableInt can be fetched back from its file)pbdoc");
+  PolarTableInt.def("memsize", &poem::PolarTable<int>::memsize,
+                  R"pbdoc(Resident memory of the PolarTableInt in bytes)pbdoc");
   PolarTableInt.def("set_value",
                     py::overload_cast<std::vector<size_t>, const int &>(&poem::PolarTable<int>::set_value));
   PolarTableInt.def("array",
@@ -468,7 +769,42 @@ PYBIND11_MODULE(pypoem, m) {
                     },
                     R"pbdoc("Get an interpolated value at point_dict")pbdoc",
                     "point_dict"_a, "oob_method"_a = "error");
+  PolarTableInt.def("nearest_batch", [](const poem::PolarTable<int> &self,
+                                        const PointsDict &points_dict,
+                                        const std::string &oob_method) -> py::array_t<int> {
+                      std::vector<const double *> coords;
+                      size_t n_points = points_dict2coords(self.name(), *self.dimension_grid(), points_dict, coords,
+                                                           "nearest_batch");
 
+                      py::array_t<int> values(n_points);
+                      self.nearest_batch(coords, n_points, values.mutable_data(),
+                                         poem::string_to_outofbound_method(oob_method));
+                      return values;
+                    },
+                    R"pbdoc("Get the nearest values at a batch of points given as a dictionary of arrays")pbdoc",
+                    "points_dict"_a, "oob_method"_a = "error");
+  PolarTableInt.def("interp_batch", [](const poem::PolarTable<int> &self,
+                                       const PointsDict &points_dict,
+                                       const std::string &oob_method) -> py::array_t<int> {
+                      std::vector<const double *> coords;
+                      size_t n_points = points_dict2coords(self.name(), *self.dimension_grid(), points_dict, coords,
+                                                           "interp_batch");
+
+                      py::array_t<int> values(n_points);
+                      self.interp_batch(coords, n_points, values.mutable_data(),
+                                        poem::string_to_outofbound_method(oob_method));
+                      return values;
+                    },
+                    R"pbdoc("Same as nearest_batch for PolarTableInt")pbdoc",
+                    "points_dict"_a, "oob_method"_a = "error");
+
+
+  PolarTableInt.def("query", &polar_table_query<int>,
+                    R"pbdoc("Non throwing query at point_dict with per dimension out of bound methods, returns (value, status)")pbdoc",
+                    "point_dict"_a, "oob_policy"_a = OutOfBoundDict(), "default_oob_method"_a = "error");
+  PolarTableInt.def("query_batch", &polar_table_query_batch<int>,
+                    R"pbdoc("Non throwing query at a batch of points, returns (values, statuses)")pbdoc",
+                    "points_dict"_a, "oob_policy"_a = OutOfBoundDict(), "default_oob_method"_a = "error");
 
   m.def("make_polar_table_int", &poem::make_polar_table_int,
         R"pbdoc(Build a PolarTable containing int values)pbdoc"
@@ -507,13 +843,129 @@ PYBIND11_MODULE(pypoem, m) {
               return self.create_polar_table<int>(name, unit, description, poem::POEM_INT);
             },
             R"pbdoc("Create a new PolarTable with type int from a Polar")pbdoc");
+  Polar.def("interp", [](const poem::Polar &self,
+                         const std::unordered_map<std::string, double> &point_dict,
+                         const std::vector<std::string> &polar_table_names,
+                         const std::string &oob_method) -> std::unordered_map<std::string, double> {
+              auto dimension_set = self.dimension_grid()->dimension_set();
+              if (point_dict.size() != dimension_set->size()) {
+                LogCriticalError("In Polar {} of dimension {}, interp function called with incorrect number of "
+                                 "values {}", self.name(), dimension_set->size(), point_dict.size());
+                CRITICAL_ERROR_POEM
+              }
+
+              std::vector<double> array(dimension_set->size());
+              size_t i = 0;
+              for (const auto &dimension: *dimension_set) {
+                array[i] = point_dict.at(dimension->name());
+                i++;
+              }
+
+              auto values = self.interp(poem::DimensionPoint(dimension_set, array), polar_table_names,
+                                        poem::string_to_outofbound_method(oob_method));
+
+              std::unordered_map<std::string, double> results;
+              for (size_t itable = 0; itable < polar_table_names.size(); ++itable) {
+                results[polar_table_names[itable]] = values[itable];
+              }
+              return results;
+            },
+            R"pbdoc("Get the values of several PolarTables at point_dict, computing the interpolation weights once.
+                     Int tables are resolved by nearest.")pbdoc",
+            "point_dict"_a, "polar_table_names"_a, "oob_method"_a = "error");
+  Polar.def("interp_batch", [](const poem::Polar &self,
+                               const PointsDict &points_dict,
+                               const std::vector<std::string> &polar_table_names,
+                               const std::string &oob_method) -> std::unordered_map<std::string, py::array_t<double>> {
+              std::vector<const double *> coords;
+              size_t n_points = points_dict2coords(self.name(), *self.dimension_grid(), points_dict, coords,
+                                                   "interp_batch");
+
+              std::unordered_map<std::string, py::array_t<double>> results;
+              std::vector<double *> values;
+              values.reserve(polar_table_names.size());
+              for (const auto &name: polar_table_names) {
+                py::array_t<double> array(n_points);
+                values.push_back(array.mutable_data());
+                results[name] = array;
+              }
+
+              self.interp_batch(coords, n_points, polar_table_names, values,
+                                poem::string_to_outofbound_method(oob_method));
+              return results;
+            },
+            R"pbdoc("Get the values of several PolarTables at a batch of points given as a dictionary of arrays,
+                     computing the interpolation weights once per point. Int tables are resolved by nearest.")pbdoc",
+            "points_dict"_a, "polar_table_names"_a, "oob_method"_a = "error");
+  Polar.def("update_vmg_envelope", &poem::Polar::update_vmg_envelope,
+            R"pbdoc("Build the optimal upwind and downwind VMG envelope along TWA_dim into UPWIND_* and DOWNWIND_* PolarTables, if not up to date")pbdoc",
+            "n_threads"_a = 0);
+  Polar.def("is_vmg_envelope_up_to_date", &poem::Polar::is_vmg_envelope_up_to_date,
+            R"pbdoc("Tells if the VMG envelope is up to date with the STW and SOLVER_STATUS PolarTables")pbdoc");
+  Polar.def("curve", &poem::Polar::curve,
+            R"pbdoc("Build a 1D view of several PolarTables along a free dimension, to be bound to an environment")pbdoc",
+            "polar_table_names"_a, "free_dimension_name"_a);
+  Polar.def("unpack", &poem::Polar::unpack,
+            R"pbdoc("Get back to one contiguous array per PolarTable")pbdoc");
+  Polar.def("is_packed", &poem::Polar::is_packed,
+            R"pbdoc("Tells if some PolarTable of the Polar are packed")pbdoc");
   Polar.def("remove_polar_table", &poem::Polar::remove_polar_table,
             R"pbdoc("Remove a PolarTable for the Polar")pbdoc",
             "name"_a);
 
+  // -------------------------------------------- PolarCurve -----------------------------------------------------------
+  py::class_<poem::PolarCurve> PolarCurve(m, "PolarCurve");
+  PolarCurve.doc() = R"pbdoc("1D view of several PolarTables of a Polar along a free dimension, the other dimensions being bound")pbdoc";
+  PolarCurve.def("size", &poem::PolarCurve::size,
+                 R"pbdoc("Number of PolarTables in the curve")pbdoc");
+  PolarCurve.def("polar_table_names", &poem::PolarCurve::polar_table_names,
+                 R"pbdoc("Names of the PolarTables in the curve")pbdoc");
+  PolarCurve.def("free_dimension_name", &poem::PolarCurve::free_dimension_name,
+                 R"pbdoc("Name of the free dimension")pbdoc");
+  PolarCurve.def("bind", [](poem::PolarCurve &self,
+                            const std::unordered_map<std::string, double> &environment,
+                            const std::string &oob_method) {
+                   self.bind(environment, poem::string_to_outofbound_method(oob_method));
+                 },
+                 R"pbdoc("Bind the environment dimensions to values given as a dictionary")pbdoc",
+                 "environment"_a, "oob_method"_a = "error");
+  PolarCurve.def("is_bound", &poem::PolarCurve::is_bound,
+                 R"pbdoc("Tells if the curve is bound to an environment")pbdoc");
+  PolarCurve.def("interp", [](const poem::PolarCurve &self, double coord, const std::string &oob_method)
+                     -> std::unordered_map<std::string, double> {
+                   auto values = self.interp(coord, poem::string_to_outofbound_method(oob_method));
+                   std::unordered_map<std::string, double> results;
+                   for (size_t itable = 0; itable < self.size(); ++itable) {
+                     results[self.polar_table_names()[itable]] = values[itable];
+                   }
+                   return results;
+                 },
+                 R"pbdoc("Get the values of the PolarTables at coord along the free dimension")pbdoc",
+                 "coord"_a, "oob_method"_a = "error");
+  PolarCurve.def("interp_batch", [](const poem::PolarCurve &self,
+                                    const py::array_t<double, py::array::c_style | py::array::forcecast> &coords,
+                                    const std::string &oob_method)
+                     -> std::unordered_map<std::string, py::array_t<double>> {
+                   size_t n_points = coords.size();
+                   std::unordered_map<std::string, py::array_t<double>> results;
+                   std::vector<double *> values;
+                   for (const auto &name: self.polar_table_names()) {
+                     py::array_t<double> array(n_points);
+                     values.push_back(array.mutable_data());
+                     results[name] = array;
+                   }
+                   self.interp_batch(coords.data(), n_points, values, poem::string_to_outofbound_method(oob_method));
+                   return results;
+                 },
+                 R"pbdoc("Get the values of the PolarTables at an array of coordinates along the free dimension")pbdoc",
+                 "coords"_a, "oob_method"_a = "error");
+
   m.def("make_polar", &poem::make_polar,
         R"pbdoc("Make a Polar")pbdoc",
         "name"_a, "polar_mode"_a, "dimension_grid"_a);
+  m.def("make_velocity_polar", &poem::make_velocity_polar,
+        R"pbdoc("Build the MVPP or HVPP Polar of a MPPP or HPPP Polar by inversion of TOTAL_POWER along STW_dim")pbdoc",
+        "power_polar"_a, "power_values"_a, "n_threads"_a = 0);
 
   // ===================================================================================================================
   // PolarSet
@@ -533,22 +985,105 @@ PYBIND11_MODULE(pypoem, m) {
         R"pbdoc("Build a PolarSet")pbdoc",
         "name"_a, "description"_a);
 
+  // -------------------------------------------- PolarSetQuery --------------------------------------------------------
+  py::class_<poem::PolarSetQuery> PolarSetQuery(m, "PolarSetQuery");
+  PolarSetQuery.doc() = R"pbdoc("Batched selection of the optimal operating mode among the Polar of a PolarSet")pbdoc";
+  PolarSetQuery.def(py::init<poem::PolarSet &>(), "polar_set"_a);
+  PolarSetQuery.def("environment_dimension_names", &poem::PolarSetQuery::environment_dimension_names,
+                    R"pbdoc("Names of the environment dimensions")pbdoc");
+  PolarSetQuery.def("speed_modes", &poem::PolarSetQuery::speed_modes,
+                    R"pbdoc("Modes evaluated at a target STW")pbdoc");
+  PolarSetQuery.def("power_modes", &poem::PolarSetQuery::power_modes,
+                    R"pbdoc("Modes evaluated at a power budget")pbdoc");
+
+  auto polar_set_select = [](const poem::PolarSetQuery &self,
+                             const PointsDict &environment,
+                             const py::array_t<double, py::array::c_style | py::array::forcecast> &target,
+                             const std::string &oob_method,
+                             size_t n_threads,
+                             bool at_speed) -> std::pair<py::array_t<int>, py::array_t<double>> {
+    size_t n_points = target.size();
+    std::vector<const double *> coords;
+    for (const auto &name: self.environment_dimension_names()) {
+      const auto &array = environment.at(name);
+      if ((size_t) array.size() != n_points) {
+        LogCriticalError("PolarSetQuery called with arrays of different sizes");
+        CRITICAL_ERROR_POEM
+      }
+      coords.push_back(array.data());
+    }
+
+    py::array_t<int> modes(n_points);
+    py::array_t<double> values(n_points);
+    auto oob_method_ = poem::string_to_outofbound_method(oob_method);
+    if (at_speed) {
+      self.select_at_speed(coords, target.data(), n_points, modes.mutable_data(), values.mutable_data(), oob_method_,
+                           n_threads);
+    } else {
+      self.select_at_power(coords, target.data(), n_points, modes.mutable_data(), values.mutable_data(), oob_method_,
+                           n_threads);
+    }
+    return {modes, values};
+  };
+  PolarSetQuery.def("select_at_speed", [polar_set_select](const poem::PolarSetQuery &self,
+                                                          const PointsDict &environment,
+                                                          const py::array_t<double, py::array::c_style | py::array::forcecast> &STW,
+                                                          const std::string &oob_method,
+                                                          size_t n_threads) {
+                      return polar_set_select(self, environment, STW, oob_method, n_threads, true);
+                    },
+                    R"pbdoc("Mode of least power at target STW, given with environment as a dictionary of arrays. Returns the modes (-1 if no feasible mode) and the powers")pbdoc",
+                    "environment"_a, "STW"_a, "oob_method"_a = "error", "n_threads"_a = 1);
+  PolarSetQuery.def("select_at_power", [polar_set_select](const poem::PolarSetQuery &self,
+                                                          const PointsDict &environment,
+                                                          const py::array_t<double, py::array::c_style | py::array::forcecast> &power,
+                                                          const std::string &oob_method,
+                                                          size_t n_threads) {
+                      return polar_set_select(self, environment, power, oob_method, n_threads, false);
+                    },
+                    R"pbdoc("Mode of highest STW at power budget, given with environment as a dictionary of arrays. Returns the modes (-1 if no feasible mode) and the STW")pbdoc",
+                    "environment"_a, "power"_a, "oob_method"_a = "error", "n_threads"_a = 1);
+
   // ===================================================================================================================
   // Writer
   // ===================================================================================================================
+  py::class_<poem::StorageOptions> StorageOptions(m, "StorageOptions");
+  StorageOptions.doc() = R"pbdoc("Storage of a netCDF variable written by to_netcdf")pbdoc";
+  StorageOptions.def(py::init<>());
+  StorageOptions.def_readwrite("chunk_lengths", &poem::StorageOptions::chunk_lengths,
+                               R"pbdoc(Chunk length along Dimensions given by name, 0 for the whole Dimension, 1 for the Dimensions not given. Empty for chunks chosen by the netCDF library)pbdoc");
+  StorageOptions.def_readwrite("compression_level", &poem::StorageOptions::compression_level,
+                               R"pbdoc(Deflate level from 1 to 9, 0 for no compression)pbdoc");
+  StorageOptions.def_readwrite("shuffle", &poem::StorageOptions::shuffle);
+  StorageOptions.def_static("whole", &poem::StorageOptions::whole,
+                            R"pbdoc(Chunks made of whole planes along the given Dimensions)pbdoc",
+                            "dimension_names"_a, "compression_level"_a = 5, "shuffle"_a = true);
+  StorageOptions.def_static("uncompressed", &poem::StorageOptions::uncompressed,
+                            R"pbdoc(Contiguous storage without any filter)pbdoc");
+
+  py::class_<poem::WriteOptions> WriteOptions(m, "WriteOptions");
+  WriteOptions.doc() = R"pbdoc("Chunking and compression of the variables written by to_netcdf")pbdoc";
+  WriteOptions.def(py::init<>());
+  WriteOptions.def_readwrite("polar_tables", &poem::WriteOptions::polar_tables);
+  WriteOptions.def_readwrite("per_polar_table", &poem::WriteOptions::per_polar_table);
+  WriteOptions.def_readwrite("coordinates", &poem::WriteOptions::coordinates);
+  WriteOptions.def("storage", &poem::WriteOptions::storage, "polar_table_name"_a);
+
   m.def("to_netcdf", [](std::shared_ptr<poem::PolarNode> polar_node,
                         const std::string &vessel_name,
                         const std::string &filename,
-                        bool verbose) -> void {
-          poem::to_netcdf(polar_node, vessel_name, filename, verbose);
+                        bool verbose,
+                        const poem::WriteOptions &write_options) -> void {
+          poem::to_netcdf(polar_node, vessel_name, filename, verbose, write_options);
         },
         R"pbdoc(Writes a PolarNode, PolarSet, Polar or PolarTable to a netCDF file)pbdoc",
-        "polar_node"_a, "vessel_name"_a, "filename"_a, "verbose"_a = true);
+        "polar_node"_a, "vessel_name"_a, "filename"_a, "verbose"_a = true,
+        "write_options"_a = poem::WriteOptions());
 
   // ===================================================================================================================
   // Checker
   // ===================================================================================================================
-  m.def("get_version", &poem::get_version,
+  m.def("get_version", py::overload_cast<const std::string &>(&poem::get_version),
         R"pbdoc(Get the version of a POEM File)pbdoc",
         "filename"_a);
 
@@ -560,12 +1095,77 @@ PYBIND11_MODULE(pypoem, m) {
         "filename"_a
   );
 
+  py::class_<poem::v1::Violation> Violation(m, "Violation");
+  Violation.doc() = R"pbdoc("Violation of a rule of the POEM specification v1")pbdoc";
+  Violation.def_readonly("rule", &poem::v1::Violation::rule, R"pbdoc(Rule number, from 1 to 7)pbdoc");
+  Violation.def_readonly("group", &poem::v1::Violation::group,
+                         R"pbdoc(Full path of the group, "root" for the root group)pbdoc");
+  Violation.def_readonly("variable", &poem::v1::Violation::variable,
+                         R"pbdoc(Variable concerned, empty for the group itself)pbdoc");
+  Violation.def_readonly("message", &poem::v1::Violation::message);
+  Violation.def("__repr__", [](const poem::v1::Violation &violation) {
+    return "<Violation V1/R" + std::to_string(violation.rule) + " in " + violation.group +
+           (violation.variable.empty() ? "" : "/" + violation.variable) + ">";
+  });
+
+  m.def("spec_check_report", [](const std::string &filename) -> std::vector<poem::v1::Violation> {
+          auto version = poem::get_version(filename);
+          if (version != 1) {
+            LogCriticalError("Violation reports are only available for POEM specification v1, file {} is v{}",
+                             filename, version);
+            CRITICAL_ERROR_POEM
+          }
+          return poem::check_v1_report(filename).violations;
+        },
+        R"pbdoc(Every violation of the rules of the POEM specification v1 found in the file, empty if compliant. Nothing is logged)pbdoc",
+        "filename"_a
+  );
+
   // ===================================================================================================================
   // Reader
   // ===================================================================================================================
 
   m.def("load", &poem::load,
         R"pbdoc(Writes a PolarNode, PolarSet, Polar or PolarTable to a netCDF file)pbdoc",
-        "filename"_a, "spec_checking"_a = true, "verbose"_a = true);
+        "filename"_a, "spec_checking"_a = true, "verbose"_a = true, "pack"_a = false, "jit"_a = false,
+        "n_threads"_a = 1);
+
+  m.def("to_snapshot", &poem::to_snapshot,
+        R"pbdoc(Writes a PolarNode to a memory mappable binary snapshot, to be opened by load_snapshot)pbdoc",
+        "polar_node"_a, "filename"_a);
+
+  m.def("load_snapshot", &poem::load_snapshot,
+        R"pbdoc(Opens a snapshot written by to_snapshot, PolarTable values being read in place from a memory mapping of the file)pbdoc",
+        "filename"_a, "verify_hash"_a = false, "verbose"_a = true);
+
+  m.def("snapshot_hash", &poem::snapshot_hash,
+        R"pbdoc(Content hash recorded in the header of a snapshot)pbdoc",
+        "filename"_a);
+
+  // ===================================================================================================================
+  // Memory budget
+  // ===================================================================================================================
+  py::class_<poem::MemoryStatistics> MemoryStatistics(m, "MemoryStatistics");
+  MemoryStatistics.doc() = R"pbdoc("Residency statistics of the PolarTables loaded from one file")pbdoc";
+  MemoryStatistics.def_readonly("n_tables", &poem::MemoryStatistics::n_tables);
+  MemoryStatistics.def_readonly("n_resident", &poem::MemoryStatistics::n_resident);
+  MemoryStatistics.def_readonly("resident_size", &poem::MemoryStatistics::resident_size);
+  MemoryStatistics.def_readonly("n_loads", &poem::MemoryStatistics::n_loads);
+  MemoryStatistics.def_readonly("n_reloads", &poem::MemoryStatistics::n_reloads);
+  MemoryStatistics.def_readonly("n_evictions", &poem::MemoryStatistics::n_evictions);
+
+  m.def("set_memory_budget", [](size_t budget) { poem::MemoryManager::instance().set_budget(budget); },
+        R"pbdoc(Sets the memory budget in bytes of the loaded files (0 for no budget), least recently queried jit tables being evicted beyond)pbdoc",
+        "budget"_a);
+  m.def("memory_budget", []() { return poem::MemoryManager::instance().budget(); },
+        R"pbdoc(Memory budget in bytes, 0 for no budget)pbdoc");
+  m.def("resident_size", []() { return poem::MemoryManager::instance().resident_size(); },
+        R"pbdoc(Resident size in bytes of the loaded files)pbdoc");
+  m.def("enforce_memory_budget", []() { return poem::MemoryManager::instance().enforce(); },
+        R"pbdoc(Evicts least recently queried jit tables until the memory budget is met. Returns the number of evicted tables)pbdoc");
+  m.def("memory_statistics", []() { return poem::MemoryManager::instance().statistics(); },
+        R"pbdoc(Residency statistics per loaded file)pbdoc");
+  m.def("reset_memory_statistics", []() { poem::MemoryManager::instance().reset_statistics(); },
+        R"pbdoc(Resets the load, reload and eviction counters)pbdoc");
 
 }  // PYBIND11_MODULE(pypoem, m)
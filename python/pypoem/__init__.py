@@ -26,5 +26,7 @@ __all__ = ["__doc__",
            "to_netcdf",
            "get_version",
            "spec_check",
+           "Violation",
+           "spec_check_report",
            "load",
            ]
@@ -2,6 +2,8 @@
 #  -*- coding: utf-8 -*-
 
 import argparse
+import json
+import sys
 from pypoem import pypoem
 
 
@@ -12,6 +14,8 @@ def get_parser():
     )
     parser.add_argument('infilename',
                         help='The file we want to check against POEM specifications')
+    parser.add_argument('--json', action='store_true',
+                        help='Prints every violation of the rules as a JSON list (POEM specification v1 only)')
 
     return parser
 
@@ -20,8 +24,29 @@ def main():
     parser = get_parser()
     args = parser.parse_args()
 
-    if pypoem.spec_check(args.infilename):
-        print("Specification version %i OK" % pypoem.get_version(args.infilename))
+    version = pypoem.get_version(args.infilename)
+
+    if version != 1:
+        if pypoem.spec_check(args.infilename):
+            print("Specification version %i OK" % version)
+            return
+        sys.exit(1)
+
+    violations = pypoem.spec_check_report(args.infilename)
+
+    if args.json:
+        print(json.dumps([{"rule": violation.rule,
+                           "group": violation.group,
+                           "variable": violation.variable,
+                           "message": violation.message} for violation in violations], indent=2))
+    elif not violations:
+        print("Specification version %i OK" % version)
+    else:
+        for violation in violations:
+            print("V1/R%i\t%s\t%s\t%s" % (violation.rule, violation.group, violation.variable, violation.message))
+
+    if violations:
+        sys.exit(1)
 
 
 if __name__ == '__main__':
@@ -0,0 +1,347 @@
+#include "ChunkReader.h"
+
+#include <cstring>
+#include <future>
+#include <vector>
+
+#include <hdf5.h>
+#include <zlib.h>
+
+#include "exceptions.h"
+#include "IO.h"
+#include "parallel.h"
+
+namespace poem {
+
+  namespace {
+    // Name given by netCDF to the dataset of a variable sharing the name of a Dimension without being its coordinate
+    // variable
+    constexpr const char *non_coord_prefix = "_nc4_non_coord_";
+
+    /**
+     * Silences the HDF5 error stack for the scope, failures being managed by the caller
+     */
+    class SilentErrors {
+     public:
+      SilentErrors() {
+        H5Eget_auto2(H5E_DEFAULT, &m_func, &m_data);
+        H5Eset_auto2(H5E_DEFAULT, nullptr, nullptr);
+      }
+
+      ~SilentErrors() {
+        H5Eset_auto2(H5E_DEFAULT, m_func, m_data);
+      }
+
+     private:
+      H5E_auto2_t m_func;
+      void *m_data;
+    };
+
+    size_t product(const std::vector<hsize_t> &dims) {
+      size_t n = 1;
+      for (auto dim: dims) n *= dim;
+      return n;
+    }
+
+  }  // namespace
+
+  struct ChunkReader::Impl {
+
+    struct Request {
+      std::string path;
+      bool is_double;
+      unsigned char *values;
+      size_t size;
+      std::function<void()> fallback;
+    };
+
+    struct Variable {
+      const Request *request;
+      hid_t dataset;
+      size_t type_size;
+      std::vector<hsize_t> dims;
+      std::vector<hsize_t> chunk_dims;
+      // Filters of the pipeline, in writing order
+      std::vector<H5Z_filter_t> filters;
+      std::vector<unsigned char> fill_value;
+    };
+
+    struct Chunk {
+      const Variable *variable;
+      std::vector<hsize_t> offset;
+      uint32_t filter_mask;
+      // Empty for a chunk never written, holding the fill value
+      std::vector<unsigned char> data;
+    };
+
+    std::string filename;
+    size_t n_threads;
+    size_t batch_size;
+    std::vector<Request> requests;
+
+    /**
+     * Opens the dataset of request and checks that it can be read by chunks
+     */
+    bool open(hid_t file, const Request &request, Variable &variable) const;
+
+    /**
+     * Inflates chunk and copies it into the values of its variable
+     */
+    void decode(const Chunk &chunk) const;
+  };
+
+  ChunkReader::ChunkReader(const std::string &filename, size_t n_threads, size_t batch_size) :
+      m_impl(std::make_unique<Impl>()) {
+    m_impl->filename = filename;
+    m_impl->n_threads = n_threads;
+    m_impl->batch_size = batch_size;
+  }
+
+  ChunkReader::~ChunkReader() = default;
+
+  const std::string &ChunkReader::filename() const {
+    return m_impl->filename;
+  }
+
+  void ChunkReader::schedule(const std::string &path, double *values, size_t size, std::function<void()> fallback) {
+    m_impl->requests.push_back({path, true, reinterpret_cast<unsigned char *>(values), size, std::move(fallback)});
+  }
+
+  void ChunkReader::schedule(const std::string &path, int *values, size_t size, std::function<void()> fallback) {
+    m_impl->requests.push_back({path, false, reinterpret_cast<unsigned char *>(values), size, std::move(fallback)});
+  }
+
+  bool ChunkReader::Impl::open(hid_t file, const Request &request, Variable &variable) const {
+    SilentErrors silent_errors;
+
+    variable.request = &request;
+    variable.dataset = H5Dopen2(file, request.path.c_str(), H5P_DEFAULT);
+    if (variable.dataset < 0) {
+      auto pos = request.path.rfind('/');
+      auto path = request.path.substr(0, pos + 1) + non_coord_prefix + request.path.substr(pos + 1);
+      variable.dataset = H5Dopen2(file, path.c_str(), H5P_DEFAULT);
+    }
+    if (variable.dataset < 0) return false;
+
+    hid_t native_type = request.is_double ? H5T_NATIVE_DOUBLE : H5T_NATIVE_INT;
+    variable.type_size = H5Tget_size(native_type);
+    hid_t type = H5Dget_type(variable.dataset);
+    bool supported = type >= 0 && H5Tequal(type, native_type) > 0;
+    if (type >= 0) H5Tclose(type);
+
+    if (supported) {
+      hid_t space = H5Dget_space(variable.dataset);
+      int rank = H5Sget_simple_extent_ndims(space);
+      supported = rank > 0;
+      if (supported) {
+        variable.dims.resize(rank);
+        H5Sget_simple_extent_dims(space, variable.dims.data(), nullptr);
+        supported = product(variable.dims) == request.size;
+      }
+      H5Sclose(space);
+    }
+
+    if (supported) {
+      hid_t dcpl = H5Dget_create_plist(variable.dataset);
+      supported = H5Pget_layout(dcpl) == H5D_CHUNKED;
+      if (supported) {
+        variable.chunk_dims.resize(variable.dims.size());
+        supported = H5Pget_chunk(dcpl, (int) variable.dims.size(), variable.chunk_dims.data()) ==
+                    (int) variable.dims.size();
+      }
+      int n_filters = supported ? H5Pget_nfilters(dcpl) : 0;
+      for (int ifilter = 0; ifilter < n_filters && supported; ++ifilter) {
+        unsigned int flags, filter_config;
+        size_t n_values = 0;
+        auto filter = H5Pget_filter2(dcpl, ifilter, &flags, &n_values, nullptr, 0, nullptr, &filter_config);
+        supported = filter == H5Z_FILTER_DEFLATE || filter == H5Z_FILTER_SHUFFLE;
+        variable.filters.push_back(filter);
+      }
+      if (supported) {
+        variable.fill_value.resize(variable.type_size);
+        supported = H5Pget_fill_value(dcpl, native_type, variable.fill_value.data()) >= 0;
+      }
+      H5Pclose(dcpl);
+    }
+
+    if (!supported) H5Dclose(variable.dataset);
+    return supported;
+  }
+
+  void ChunkReader::Impl::decode(const Chunk &chunk) const {
+    const auto &variable = *chunk.variable;
+    const size_t rank = variable.dims.size();
+    const size_t type_size = variable.type_size;
+    const size_t chunk_bytes = product(variable.chunk_dims) * type_size;
+
+    // Filters are undone in reverse order, filters skipped at writing being flagged in the mask
+    std::vector<unsigned char> buffers[2];
+    const unsigned char *data = chunk.data.data();
+    size_t data_size = chunk.data.size();
+    if (chunk.data.empty()) {
+      buffers[0].resize(chunk_bytes);
+      for (size_t i = 0; i < chunk_bytes; i += type_size) {
+        std::memcpy(buffers[0].data() + i, variable.fill_value.data(), type_size);
+      }
+      data = buffers[0].data();
+      data_size = chunk_bytes;
+    } else {
+      for (int ifilter = (int) variable.filters.size() - 1, ibuffer = 0; ifilter >= 0; --ifilter) {
+        if (chunk.filter_mask & (1u << ifilter)) continue;
+        auto &out = buffers[ibuffer];
+        ibuffer = 1 - ibuffer;
+
+        if (variable.filters[ifilter] == H5Z_FILTER_DEFLATE) {
+          out.resize(chunk_bytes);
+          uLongf out_size = chunk_bytes;
+          if (uncompress(out.data(), &out_size, data, data_size) != Z_OK) {
+            LogCriticalError("In file {}, corrupted chunk in variable {}", filename, variable.request->path);
+            CRITICAL_ERROR_POEM
+          }
+          out.resize(out_size);
+        } else {
+          // Shuffle: byte j of every value is stored in the j-th block
+          out.resize(data_size);
+          const size_t n_values = data_size / type_size;
+          for (size_t ibyte = 0; ibyte < type_size; ++ibyte) {
+            const unsigned char *block = data + ibyte * n_values;
+            for (size_t ivalue = 0; ivalue < n_values; ++ivalue) {
+              out[ivalue * type_size + ibyte] = block[ivalue];
+            }
+          }
+          // Trailing bytes not making a value are left in place
+          size_t n_bytes = n_values * type_size;
+          std::memcpy(out.data() + n_bytes, data + n_bytes, data_size - n_bytes);
+        }
+        data = out.data();
+        data_size = out.size();
+      }
+    }
+
+    if (data_size != chunk_bytes) {
+      LogCriticalError("In file {}, chunk of {} bytes found in variable {}, expected {}",
+                       filename, data_size, variable.request->path, chunk_bytes);
+      CRITICAL_ERROR_POEM
+    }
+
+    // Copy of the rows along the last dimension, edge chunks overlapping the end of the variable
+    const auto &dims = variable.dims;
+    const auto &chunk_dims = variable.chunk_dims;
+    const size_t row_size = chunk_dims[rank - 1];
+    const size_t n_row_values = std::min<size_t>(row_size, dims[rank - 1] - chunk.offset[rank - 1]);
+    const size_t n_rows = product(chunk_dims) / row_size;
+    for (size_t irow = 0; irow < n_rows; ++irow) {
+      size_t index = chunk.offset[rank - 1];
+      size_t stride = dims[rank - 1];
+      bool inside = true;
+      for (size_t i = irow, idim = rank - 1; idim-- > 0;) {
+        size_t position = chunk.offset[idim] + i % chunk_dims[idim];
+        i /= chunk_dims[idim];
+        inside &= position < dims[idim];
+        index += position * stride;
+        stride *= dims[idim];
+      }
+      if (!inside) continue;
+      std::memcpy(variable.request->values + index * type_size, data + irow * row_size * type_size,
+                  n_row_values * type_size);
+    }
+  }
+
+  void ChunkReader::read() {
+    // Every HDF5 call being made by this thread, fallbacks included
+    std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+    std::vector<const Impl::Request *> fallbacks;
+    {
+      hid_t file;
+      {
+        SilentErrors silent_errors;
+        file = H5Fopen(m_impl->filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+      }
+      if (file < 0) {
+        LogCriticalError("Cannot open file {} to read chunks", m_impl->filename);
+        CRITICAL_ERROR_POEM
+      }
+
+      std::vector<Impl::Variable> variables;
+      // Closes the handles however the reading ends, pending decoding being waited for before
+      struct Closer {
+        hid_t file;
+        std::vector<Impl::Variable> &variables;
+
+        ~Closer() {
+          for (const auto &variable: variables) H5Dclose(variable.dataset);
+          H5Fclose(file);
+        }
+      } closer{file, variables};
+
+      variables.reserve(m_impl->requests.size());
+      for (const auto &request: m_impl->requests) {
+        Impl::Variable variable;
+        if (m_impl->open(file, request, variable)) {
+          variables.push_back(std::move(variable));
+        } else {
+          fallbacks.push_back(&request);
+        }
+      }
+
+      std::vector<Impl::Chunk> batch;
+      size_t batch_bytes = 0;
+      std::future<void> decoding;
+      auto flush = [&]() {
+        if (decoding.valid()) decoding.get();
+        decoding = std::async(std::launch::async, [this, chunks = std::move(batch)]() {
+          parallel_for(chunks.size(), [&](size_t ichunk) { m_impl->decode(chunks[ichunk]); }, m_impl->n_threads);
+        });
+        batch.clear();
+        batch_bytes = 0;
+      };
+
+      bool failed = false;
+      for (const auto &variable: variables) {
+        const size_t rank = variable.dims.size();
+        std::vector<hsize_t> offset(rank, 0);
+        // Walks the chunk grid in row major order
+        while (!failed) {
+          Impl::Chunk chunk{&variable, offset, 0, {}};
+          hsize_t chunk_size = 0;
+          {
+            SilentErrors silent_errors;
+            // Chunks never written have no storage
+            H5Dget_chunk_storage_size(variable.dataset, offset.data(), &chunk_size);
+          }
+          if (chunk_size > 0) {
+            chunk.data.resize(chunk_size);
+            failed = H5Dread_chunk(variable.dataset, H5P_DEFAULT, offset.data(), &chunk.filter_mask,
+                                   chunk.data.data()) < 0;
+            batch_bytes += chunk_size;
+          }
+          batch.push_back(std::move(chunk));
+          if (batch_bytes >= m_impl->batch_size) flush();
+
+          size_t idim = rank;
+          while (idim-- > 0) {
+            offset[idim] += variable.chunk_dims[idim];
+            if (offset[idim] < variable.dims[idim]) break;
+            offset[idim] = 0;
+          }
+          if (idim == (size_t) -1) break;
+        }
+        if (failed) {
+          LogCriticalError("In file {}, failed to read the chunks of variable {}", m_impl->filename,
+                           variable.request->path);
+          break;
+        }
+      }
+      flush();
+      decoding.get();
+      if (failed) CRITICAL_ERROR_POEM
+    }
+
+    // The file being closed by HDF5, may be read by the netCDF library
+    for (auto request: fallbacks) {
+      request->fallback();
+    }
+    m_impl->requests.clear();
+  }
+
+}  // poem
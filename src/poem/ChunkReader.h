@@ -0,0 +1,64 @@
+#ifndef POEM_CHUNKREADER_H
+#define POEM_CHUNKREADER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace poem {
+
+  /**
+   * Parallel reader of the values of netCDF-4 variables from their raw compressed chunks
+   *
+   * The netCDF library inflates the chunks of a variable serially on one core, which dominates the loading of large
+   * files. Here, compressed chunks are read as is from the HDF5 file (direct chunk read), then inflated and scattered
+   * into the values by a pool of threads. Chunks are processed by batches, a batch being decoded while the next one is
+   * read.
+   *
+   * Every HDF5 call is made by the calling thread under netcdf_mutex, threads of the pool only running zlib and copies.
+   *
+   * Only chunked variables of native double or int type, compressed with the shuffle and deflate filters (as written by
+   * to_netcdf), are read by chunks. The others are read by a fallback given at schedule, called once the file is closed
+   * by HDF5 so that it can be opened by the netCDF library.
+   */
+  class ChunkReader {
+   public:
+    // Compressed bytes of a batch of chunks, decoded while the next batch is read
+    static constexpr size_t default_batch_size = 32 << 20;
+
+    /**
+     * @param n_threads number of threads inflating chunks. 0 means one thread per hardware core
+     * @param batch_size compressed bytes read before a batch is handed to the threads
+     */
+    ChunkReader(const std::string &filename, size_t n_threads, size_t batch_size = default_batch_size);
+
+    ~ChunkReader();
+
+    ChunkReader(const ChunkReader &) = delete;
+
+    ChunkReader &operator=(const ChunkReader &) = delete;
+
+    [[nodiscard]] const std::string &filename() const;
+
+    /**
+     * Schedules the reading of the variable at path (from the root group) into values, of size elements
+     */
+    void schedule(const std::string &path, double *values, size_t size, std::function<void()> fallback);
+
+    void schedule(const std::string &path, int *values, size_t size, std::function<void()> fallback);
+
+    /**
+     * Reads every scheduled variable, the file being opened by HDF5 for the time of the call. values given to schedule
+     * must be alive until then.
+     */
+    void read();
+
+   private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+
+  };
+
+}  // poem
+
+#endif //POEM_CHUNKREADER_H
@@ -6,10 +6,54 @@
 
 namespace poem {
 
-  Dimension::Dimension(const std::string &name, const std::string &unit, const std::string &description) :
+  DIMENSION_PERIODICITY string_to_dimension_periodicity(const std::string &periodicity_str) {
+    DIMENSION_PERIODICITY periodicity;
+    if (periodicity_str == "non_periodic") {
+      periodicity = NON_PERIODIC;
+    } else if (periodicity_str == "periodic") {
+      periodicity = PERIODIC;
+    } else if (periodicity_str == "symmetric") {
+      periodicity = SYMMETRIC;
+    } else {
+      LogCriticalError("Unknown dimension periodicity {}. "
+                       "Available values are non_periodic, periodic or symmetric", periodicity_str);
+      CRITICAL_ERROR_POEM
+    }
+    return periodicity;
+  }
+
+  std::string dimension_periodicity_to_string(DIMENSION_PERIODICITY periodicity) {
+    std::string periodicity_str;
+    switch (periodicity) {
+      case NON_PERIODIC:
+        periodicity_str = "non_periodic";
+        break;
+      case PERIODIC:
+        periodicity_str = "periodic";
+        break;
+      case SYMMETRIC:
+        periodicity_str = "symmetric";
+        break;
+    }
+    return periodicity_str;
+  }
+
+  Dimension::Dimension(const std::string &name,
+                       const std::string &unit,
+                       const std::string &description,
+                       DIMENSION_PERIODICITY periodicity,
+                       double period) :
       Dimensional(unit),
       m_description(description),
-      m_name(name) {}
+      m_name(name),
+      m_periodicity(periodicity),
+      m_period(period) {
+    if (m_periodicity != NON_PERIODIC && !(m_period > 0.)) {
+      LogCriticalError("Dimension {} declared {} with a non positive period {}",
+                       name, dimension_periodicity_to_string(periodicity), period);
+      CRITICAL_ERROR_POEM
+    }
+  }
 
   const std::string &Dimension::name() const {
     return m_name;
@@ -27,4 +71,16 @@ namespace poem {
     m_description = description;
   }
 
+  DIMENSION_PERIODICITY Dimension::periodicity() const {
+    return m_periodicity;
+  }
+
+  bool Dimension::is_periodic() const {
+    return m_periodicity != NON_PERIODIC;
+  }
+
+  double Dimension::period() const {
+    return m_period;
+  }
+
 }  // poem
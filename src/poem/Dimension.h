@@ -5,6 +5,7 @@
 #ifndef POEM_DIMENSION_H
 #define POEM_DIMENSION_H
 
+#include <cmath>
 #include <string>
 #include <memory>
 
@@ -12,14 +13,74 @@
 
 namespace poem {
 
+  /**
+   * Periodicity of a Dimension, used for angles such as TWA_dim or WA_dim
+   */
+  enum DIMENSION_PERIODICITY {
+    /// Plain bounded dimension
+    NON_PERIODIC,
+    /// Coordinates are wrapped into one period from the first sampling value
+    PERIODIC,
+    /// Periodic and mirror symmetric about 0, only half a period from 0 being sampled (e.g. 0..180 deg)
+    SYMMETRIC
+  };
+
+  DIMENSION_PERIODICITY string_to_dimension_periodicity(const std::string &periodicity_str);
+
+  std::string dimension_periodicity_to_string(DIMENSION_PERIODICITY periodicity);
+
+  /**
+   * Wraps coord into [origin, origin + period) for PERIODIC, origin being the first sampling value. For SYMMETRIC, coord
+   * is wrapped into [0, period), then mirrored about 0 into [0, period / 2], whatever origin. derivative is set to the
+   * derivative of the wrapped coordinate with respect to coord (-1 where mirrored, 1 otherwise). coord is left
+   * unchanged for NON_PERIODIC.
+   */
+  inline double wrap_coordinate(double coord,
+                                DIMENSION_PERIODICITY periodicity,
+                                double origin,
+                                double period,
+                                double &derivative) {
+    derivative = 1.;
+    if (periodicity == NON_PERIODIC) return coord;
+    if (periodicity == SYMMETRIC) origin = 0.;
+
+    double x = coord - origin;
+    x -= period * std::floor(x / period);
+    if (periodicity == SYMMETRIC && x > 0.5 * period) {
+      x = period - x;
+      derivative = -1.;
+    }
+    return origin + x;
+  }
+
+  /**
+   * Same as above, without the derivative
+   */
+  inline double wrap_coordinate(double coord, DIMENSION_PERIODICITY periodicity, double origin, double period) {
+    double derivative;
+    return wrap_coordinate(coord, periodicity, origin, period, derivative);
+  }
+
   /**
    * Declares a polar table dimension with name, unit and description
+   *
+   * Angular dimensions may be declared PERIODIC or SYMMETRIC with a period (360 by default, in the unit of the
+   * Dimension). Queries (interp, nearest, batches and non throwing queries) then wrap the coordinates before any out of
+   * bound management, so that raw relative angles may be given. A SYMMETRIC dimension is mirrored about 0 and sampled
+   * within half a period from 0 only (e.g. TWA from 30 to 180 deg for a symmetric hull). A PERIODIC dimension is
+   * interpolated over the full period: if its sampling is not closed (e.g. 0 to 350 deg), the wrap cell between the
+   * last value and the first value plus the period interpolates between the last and the first values, so that no
+   * closing sample duplicating the first one is required.
+   *
+   * The periodicity is fixed at construction.
    */
   class Dimension : public Dimensional {
    public:
     Dimension(const std::string &name,
               const std::string &unit,
-              const std::string &description);
+              const std::string &description,
+              DIMENSION_PERIODICITY periodicity = NON_PERIODIC,
+              double period = 360.);
 
     const std::string &name() const;
 
@@ -29,9 +90,20 @@ namespace poem {
 
     void change_description(const std::string &description);
 
+    DIMENSION_PERIODICITY periodicity() const;
+
+    bool is_periodic() const;
+
+    /**
+     * Period of the Dimension, meaningful for PERIODIC and SYMMETRIC dimensions only
+     */
+    double period() const;
+
    private:
     std::string m_description;
     std::string m_name;
+    DIMENSION_PERIODICITY m_periodicity;
+    double m_period;
   };
 
   /**
@@ -39,12 +111,16 @@ namespace poem {
    * @param name
    * @param unit
    * @param description
+   * @param periodicity
+   * @param period
    * @return
    */
   inline std::shared_ptr<Dimension> make_dimension(const std::string &name,
                                                    const std::string &unit,
-                                                   const std::string &description) {
-    return std::make_shared<Dimension>(name, unit, description);
+                                                   const std::string &description,
+                                                   DIMENSION_PERIODICITY periodicity = NON_PERIODIC,
+                                                   double period = 360.) {
+    return std::make_shared<Dimension>(name, unit, description, periodicity, period);
   }
 
 }  // poem
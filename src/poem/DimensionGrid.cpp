@@ -8,6 +8,20 @@
 
 namespace poem {
 
+  DimensionGrid::DimensionGrid(const std::shared_ptr<DimensionSet> &dimension_set) :
+      m_dimension_set(dimension_set),
+      m_dimensions_values(dimension_set->size()),
+      m_axis_locators(dimension_set->size()),
+      m_wrap_widths(dimension_set->size(), 0.),
+      m_is_initialized(false) {
+    m_periodicities.reserve(dimension_set->size());
+    m_periods.reserve(dimension_set->size());
+    for (const auto &dimension: *dimension_set) {
+      m_periodicities.push_back(dimension->periodicity());
+      m_periods.push_back(dimension->period());
+    }
+  }
+
   void poem::DimensionGrid::set_values(const std::string &name, const std::vector<double> &values) {
 
     if (!m_dimension_set->contains(name)) {
@@ -20,6 +34,17 @@ namespace poem {
       CRITICAL_ERROR_POEM
     }
 
+    set_values(m_dimension_set->index(name), values);
+  }
+
+  void DimensionGrid::set_values(size_t idim, const std::vector<double> &values) {
+    if (idim >= m_dimension_set->size()) {
+      LogCriticalError("In DimensionGrid, attempting to set values of dimension {} while there are {} dimensions",
+                       idim, m_dimension_set->size());
+      CRITICAL_ERROR_POEM
+    }
+    const auto &name = m_dimension_set->name(idim);
+
     // Check that the values are in ascending order
     double prec = values.front() - 1.;
     for (const auto &val: values) {
@@ -30,7 +55,22 @@ namespace poem {
       prec = val;
     }
 
-    m_dimensions_values.at(m_dimension_set->index(name)) = values;
+    // A periodic sampling must not exceed one period. A symmetric one, mirrored about 0, must lie within half a period
+    // from 0.
+    if (m_periodicities[idim] == PERIODIC && values.back() - values.front() > m_periods[idim]) {
+      LogCriticalError("In DimensionGrid, sampling of periodic dimension {} spans {}, more than its period {}",
+                       name, values.back() - values.front(), m_periods[idim]);
+      CRITICAL_ERROR_POEM
+    }
+    if (m_periodicities[idim] == SYMMETRIC && (values.front() < 0. || values.back() > 0.5 * m_periods[idim])) {
+      LogCriticalError("In DimensionGrid, sampling of symmetric dimension {} must be between 0 and half its period {}. "
+                       "Found {} to {}", name, 0.5 * m_periods[idim], values.front(), values.back());
+      CRITICAL_ERROR_POEM
+    }
+
+    m_dimensions_values.at(idim) = values;
+    m_axis_locators.at(idim) = AxisLocator(values);
+    m_wrap_widths[idim] = m_periodicities[idim] == PERIODIC ? values.front() + m_periods[idim] - values.back() : 0.;
     m_is_initialized = false;
   }
 
@@ -38,16 +78,38 @@ namespace poem {
     return m_dimensions_values.at(idx);
   }
 
-  std::vector<double> &DimensionGrid::values(size_t idx) {
-    return m_dimensions_values.at(idx);
-  }
-
   const std::vector<double> &DimensionGrid::values(const std::string &name) const {
     return m_dimensions_values.at(m_dimension_set->index(name));
   }
 
+  bool DimensionGrid::is_uniform(size_t idim) const {
+    return m_axis_locators.at(idim).is_uniform();
+  }
+
+  bool DimensionGrid::is_closed(size_t idim) const {
+    return m_periodicities.at(idim) == PERIODIC && m_wrap_widths[idim] == 0.;
+  }
+
+  DIMENSION_PERIODICITY DimensionGrid::periodicity(size_t idim) const {
+    return m_periodicities.at(idim);
+  }
+
+  double DimensionGrid::period(size_t idim) const {
+    return m_periods.at(idim);
+  }
+
   size_t DimensionGrid::size() const {
-    return dimension_points().size();
+    if (!is_filled()) {
+      LogCriticalError("DimensionGrid is not fully filled");
+      CRITICAL_ERROR_POEM
+    }
+
+    // Computed from the sampling sizes, it does not require the DimensionPoint vector to be built
+    size_t size = 1;
+    for (const auto &values: m_dimensions_values) {
+      size *= values.size();
+    }
+    return size;
   }
 
   size_t DimensionGrid::size(size_t idx) const {
@@ -93,7 +155,7 @@ namespace poem {
       auto other_values = other.m_dimensions_values[i];
       equal &= this_values == other_values;
     }
-    equal &= m_dimension_points == other.m_dimension_points;
+    // Dimension points follow from the values, being materialized on demand only
     return equal;
   }
 
@@ -110,6 +172,21 @@ namespace poem {
     return m_dimension_points;
   }
 
+  size_t DimensionGrid::memsize() const {
+    size_t size = sizeof(*this);
+    for (size_t idim = 0; idim < m_dimensions_values.size(); ++idim) {
+      size += m_dimensions_values[idim].capacity() * sizeof(double);
+    }
+    for (const auto &axis_locator: m_axis_locators) {
+      size += axis_locator.memsize();
+    }
+    size += m_dimension_points.capacity() * sizeof(DimensionPoint);
+    for (const auto &dimension_point: m_dimension_points) {
+      size += dimension_point.size() * sizeof(double);
+    }
+    return size;
+  }
+
   bool DimensionGrid::is_filled() const {
     struct IsEmpty {
       bool operator()(const std::vector<double> &values) {
@@ -5,10 +5,14 @@
 #ifndef POEM_DIMENSIONGRID_H
 #define POEM_DIMENSIONGRID_H
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <memory>
 #include <vector>
 
 #include "exceptions.h"
+#include "Dimension.h"
 #include "DimensionPoint.h"
 
 namespace poem {
@@ -16,25 +20,286 @@ namespace poem {
   // Forward declaration
   class DimensionSet;
 
+  /**
+   * Search structure used to locate a coordinate into the sampling values of a dimension
+   *
+   * Uniformly spaced samplings (detected at construction) are located with arithmetic only, from the origin and the
+   * inverse step. Non uniform samplings are located with a branch free search into a copy of the values stored in
+   * Eytzinger (breadth first) order, which keeps the first levels of the search in the same cache lines.
+   *
+   * Both paths give the same result as a std::upper_bound into the sampling values.
+   */
+  class AxisLocator {
+   public:
+    AxisLocator() = default;
+
+    explicit AxisLocator(const std::vector<double> &values) : m_size(values.size()) {
+      if (m_size < 2) {
+        return;
+      }
+
+      // Uniform spacing detection
+      double step = (values.back() - values.front()) / (double) (m_size - 1);
+      m_is_uniform = true;
+      for (size_t i = 1; i < m_size; ++i) {
+        if (std::abs(values[i] - values.front() - (double) i * step) > 1e-6 * step) {
+          m_is_uniform = false;
+          break;
+        }
+      }
+
+      if (m_is_uniform) {
+        m_origin = values.front();
+        m_inv_step = 1. / step;
+      } else {
+        m_eytzinger.resize(m_size + 1);
+        m_ranks.resize(m_size + 1);
+        m_ranks[0] = m_size;  // Eytzinger index 0 stands for "no value greater than coord"
+        size_t i = 0;
+        build_eytzinger(values, i, 1);
+      }
+    }
+
+    [[nodiscard]] bool is_uniform() const { return m_is_uniform; }
+
+    [[nodiscard]] size_t memsize() const {
+      return sizeof(*this) + m_eytzinger.capacity() * sizeof(double) + m_ranks.capacity() * sizeof(size_t);
+    }
+
+    /**
+     * Index i of the cell [values[i], values[i+1]] containing coord, in [0, size-2] (0 for a singleton sampling)
+     *
+     * Coordinates out of the sampling range are given the first or the last cell.
+     */
+    [[nodiscard]] inline size_t cell_index(const double *values, double coord) const {
+      if (m_size < 2) {
+        return 0;
+      }
+
+      size_t index;
+      if (m_is_uniform) {
+        // Arithmetic guess, corrected against the actual values to account for rounding
+        double pos = (coord - m_origin) * m_inv_step;
+        index = pos > 0. ? (size_t) std::min(pos, (double) (m_size - 2)) : 0;
+        index += (index < m_size - 2) & (values[index + 1] <= coord);
+        index -= (index > 0) & (values[index] > coord);
+
+      } else {
+        // Branch free search of the first value greater than coord
+        size_t k = 1;
+        while (k <= m_size) {
+          k = 2 * k + (m_eytzinger[k] <= coord);
+        }
+        k >>= std::countr_one(k) + 1;
+        // Number of values lower or equal to coord
+        size_t count = m_ranks[k];
+        index = std::min(std::max(count, (size_t) 1), m_size - 1) - 1;
+      }
+
+      return index;
+    }
+
+    /**
+     * Index of the sampling value the nearest to coord. On equal distances, the lower value is chosen.
+     */
+    [[nodiscard]] inline size_t nearest_index(const double *values, double coord) const {
+      if (m_size < 2) {
+        return 0;
+      }
+      size_t index = cell_index(values, coord);
+      return index + (std::abs(values[index] - coord) > std::abs(values[index + 1] - coord));
+    }
+
+   private:
+    void build_eytzinger(const std::vector<double> &values, size_t &i, size_t k) {
+      if (k <= m_size) {
+        build_eytzinger(values, i, 2 * k);
+        m_eytzinger[k] = values[i];
+        m_ranks[k] = i;
+        i++;
+        build_eytzinger(values, i, 2 * k + 1);
+      }
+    }
+
+   private:
+    size_t m_size = 0;
+    bool m_is_uniform = false;
+    double m_origin = 0.;
+    double m_inv_step = 0.;
+    std::vector<double> m_eytzinger;
+    std::vector<size_t> m_ranks;
+  };
+
   /**
    * Defines a numerical sampling for each of Dimension object in a DimensionSet
    */
   class DimensionGrid {
    public:
-    explicit DimensionGrid(const std::shared_ptr<DimensionSet> &dimension_set) :
-        m_dimension_set(dimension_set),
-        m_dimensions_values(dimension_set->size()),
-        m_is_initialized(false) {
-    }
+    explicit DimensionGrid(const std::shared_ptr<DimensionSet> &dimension_set);
 
     void set_values(const std::string &name, const std::vector<double> &values);
 
-    const std::vector<double> &values(size_t idx) const;
+    void set_values(size_t idx, const std::vector<double> &values);
 
-    std::vector<double> &values(size_t idx);
+    /**
+     * Sampling of dimension idx
+     *
+     * Read only: the former mutable accessor values(idx) is replaced by set_values(idx, values), which checks the
+     * sampling and keeps the cell location (see AxisLocator) in sync with it.
+     */
+    const std::vector<double> &values(size_t idx) const;
 
     const std::vector<double> &values(const std::string &name) const;
 
+    /**
+     * Tells if the sampling of dimension idim is uniformly spaced
+     */
+    bool is_uniform(size_t idim) const;
+
+    /**
+     * Wraps coord for PERIODIC dimensions from the first sampling value and mirrors it about 0 for SYMMETRIC
+     * dimensions (see wrap_coordinate). Queries must wrap coordinates before any out of bound management.
+     */
+    inline double wrap(size_t idim, double coord) const {
+      return wrap_coordinate(coord, m_periodicities[idim], m_dimensions_values[idim].front(), m_periods[idim]);
+    }
+
+    /**
+     * Same as above, also giving the derivative of the wrapped coordinate with respect to coord
+     */
+    inline double wrap(size_t idim, double coord, double &derivative) const {
+      return wrap_coordinate(coord, m_periodicities[idim], m_dimensions_values[idim].front(), m_periods[idim],
+                             derivative);
+    }
+
+    /**
+     * Index i of the cell [values[i], values[i+1]] of dimension idim containing coord
+     *
+     * O(1) for uniform samplings, branch free O(log n) search otherwise. The result is in [0, size(idim)-2], 0 for a
+     * singleton dimension. Coordinates out of range are given the first or the last cell.
+     *
+     * On a PERIODIC dimension whose sampling is not closed, wrapped coordinates above the last value are in the wrap
+     * cell, between the last value and the first value plus the period: its index is size(idim)-1 (see upper_index).
+     */
+    inline size_t cell_index(size_t idim, double coord) const {
+      const auto &values = m_dimensions_values[idim];
+      if (m_wrap_widths[idim] > 0. && coord > values.back()) return values.size() - 1;
+      return m_axis_locators[idim].cell_index(values.data(), coord);
+    }
+
+    /**
+     * Same as cell_index, also giving the normalized position of coord in the cell (0 for non periodic singleton
+     * dimensions)
+     */
+    inline size_t locate(size_t idim, double coord, double &weight) const {
+      const auto &values = m_dimensions_values[idim];
+      if (m_wrap_widths[idim] > 0. && coord > values.back()) {
+        weight = (coord - values.back()) / m_wrap_widths[idim];
+        return values.size() - 1;
+      }
+      size_t index = m_axis_locators[idim].cell_index(values.data(), coord);
+      weight = values.size() > 1 ? (coord - values[index]) / (values[index + 1] - values[index]) : 0.;
+      return index;
+    }
+
+    /**
+     * Index of the upper node of cell index of dimension idim: index + 1, or 0 for the wrap cell of a PERIODIC
+     * dimension and for a singleton dimension
+     */
+    inline size_t upper_index(size_t idim, size_t index) const {
+      return index + 1 < m_dimensions_values[idim].size() ? index + 1 : 0;
+    }
+
+    /**
+     * Coordinate of the upper node of cell index of dimension idim, the first value plus the period for the wrap cell
+     */
+    inline double upper_value(size_t idim, size_t index) const {
+      const auto &values = m_dimensions_values[idim];
+      return index + 1 < values.size() ? values[index + 1] : values.back() + m_wrap_widths[idim];
+    }
+
+    /**
+     * Width of cell index of dimension idim, that of the wrap cell being the first value plus the period minus the
+     * last value (null for a non periodic singleton dimension)
+     */
+    inline double cell_width(size_t idim, size_t index) const {
+      const auto &values = m_dimensions_values[idim];
+      return index + 1 < values.size() ? values[index + 1] - values[index] : m_wrap_widths[idim];
+    }
+
+    /**
+     * Indices of the nodes before and after node index of dimension idim, returning the distance between them (for
+     * centered differences). At the ends of a PERIODIC dimension, they are taken across the seam, the closing value of
+     * a closed sampling being skipped. At the ends of other dimensions, the node itself is given (null distance for a
+     * singleton).
+     */
+    inline double neighbours(size_t idim, size_t index, size_t &previous, size_t &next) const {
+      const auto &values = m_dimensions_values[idim];
+      const size_t n = values.size();
+      const bool is_periodic = m_periodicities[idim] == PERIODIC;
+      const bool is_closed_ = is_periodic && m_wrap_widths[idim] == 0.;
+
+      double lower = values[index];
+      if (index > 0) {
+        previous = index - 1;
+        lower = values[previous];
+      } else if (is_periodic) {
+        previous = is_closed_ ? n - 2 : n - 1;
+        lower = values[previous] - m_periods[idim];
+      } else {
+        previous = index;
+      }
+
+      double upper = values[index];
+      if (index + 1 < n) {
+        next = index + 1;
+        upper = values[next];
+      } else if (is_periodic) {
+        next = is_closed_ ? 1 : 0;
+        upper = values[next] + m_periods[idim];
+      } else {
+        next = index;
+      }
+      return upper - lower;
+    }
+
+    /**
+     * Index of the node of cell index of dimension idim the nearest to coord. On equal distances, the lower node is
+     * chosen.
+     */
+    inline size_t nearest_in_cell(size_t idim, size_t index, double coord) const {
+      double lower_distance = std::abs(m_dimensions_values[idim][index] - coord);
+      return lower_distance > std::abs(upper_value(idim, index) - coord) ? upper_index(idim, index) : index;
+    }
+
+    /**
+     * Index of the sampling value of dimension idim the nearest to coord, across the wrap cell of a PERIODIC dimension
+     */
+    inline size_t nearest_index(size_t idim, double coord) const {
+      const auto &values = m_dimensions_values[idim];
+      if (m_wrap_widths[idim] > 0. && coord > values.back()) {
+        return nearest_in_cell(idim, values.size() - 1, coord);
+      }
+      return m_axis_locators[idim].nearest_index(values.data(), coord);
+    }
+
+    /**
+     * Upper bound of the wrapped coordinates of dimension idim, for out of bound management: the first value plus the
+     * period for a PERIODIC dimension, every wrapped coordinate being then in range, the last value otherwise
+     */
+    inline double range_max(size_t idim) const {
+      return m_dimensions_values[idim].back() + m_wrap_widths[idim];
+    }
+
+    /**
+     * Tells if dimension idim is PERIODIC with a closed sampling (last value = first value + period)
+     */
+    bool is_closed(size_t idim) const;
+
+    DIMENSION_PERIODICITY periodicity(size_t idim) const;
+
+    double period(size_t idim) const;
+
     /**
      * Number of points in the grid
      * @return
@@ -65,6 +330,11 @@ namespace poem {
 
     const std::vector<DimensionPoint> &dimension_points() const;
 
+    /**
+     * Memory held by the grid in bytes, sampling values, locators and materialized dimension points included
+     */
+    size_t memsize() const;
+
     bool is_filled() const;
 
     std::shared_ptr<DimensionGrid> copy() const;
@@ -79,6 +349,12 @@ namespace poem {
    private:
     std::shared_ptr<DimensionSet> m_dimension_set;
     std::vector<std::vector<double>> m_dimensions_values;
+    std::vector<AxisLocator> m_axis_locators;
+    // Periodicity of the dimensions, copied from the DimensionSet for the query kernels
+    std::vector<DIMENSION_PERIODICITY> m_periodicities;
+    std::vector<double> m_periods;
+    // Width of the wrap cell of PERIODIC dimensions whose sampling is not closed, 0 otherwise
+    std::vector<double> m_wrap_widths;
     bool m_is_initialized;
     std::vector<DimensionPoint> m_dimension_points;
 
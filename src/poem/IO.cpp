@@ -5,12 +5,18 @@
 #include "IO.h"
 
 #include <semver/semver.hpp>
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <ctime>
+#include <mutex>
+#include <sstream>
 
 #include <cools/string/StringUtils.h>
 #include <dunits/dunits.h>
 
+#include "ChunkReader.h"
+#include "MemoryManager.h"
 #include "PolarTable.h"
 #include "Polar.h"
 #include "PolarSet.h"
@@ -18,6 +24,11 @@
 
 namespace poem {
 
+  std::recursive_mutex &netcdf_mutex() {
+    static std::recursive_mutex mutex;
+    return mutex;
+  }
+
   // ===================================================================================================================
   // WRITERS
   // ===================================================================================================================
@@ -26,8 +37,61 @@ namespace poem {
     return git::version_major();
   }
 
+  StorageOptions StorageOptions::whole(const std::vector<std::string> &dimension_names,
+                                       int compression_level,
+                                       bool shuffle) {
+    StorageOptions storage;
+    for (const auto &dimension_name: dimension_names) {
+      storage.chunk_lengths[dimension_name] = 0;
+    }
+    storage.compression_level = compression_level;
+    storage.shuffle = shuffle;
+    return storage;
+  }
+
+  StorageOptions StorageOptions::uncompressed() {
+    StorageOptions storage;
+    storage.compression_level = 0;
+    storage.shuffle = false;
+    return storage;
+  }
+
+  const StorageOptions &WriteOptions::storage(const std::string &polar_table_name) const {
+    auto it = per_polar_table.find(polar_table_name);
+    return it == per_polar_table.end() ? polar_tables : it->second;
+  }
+
+  void set_storage(netCDF::NcVar &nc_var, const std::vector<netCDF::NcDim> &dims, const StorageOptions &storage) {
+    if (storage.compression_level < 0 || storage.compression_level > 9) {
+      LogCriticalError("Compression level of variable {} must be between 0 and 9, found {}",
+                       nc_var.getName(), storage.compression_level);
+      CRITICAL_ERROR_POEM
+    }
+
+    if (!storage.chunk_lengths.empty()) {
+      std::vector<size_t> chunk_lengths;
+      chunk_lengths.reserve(dims.size());
+      for (const auto &dim: dims) {
+        size_t chunk_length = 1;
+        auto it = storage.chunk_lengths.find(dim.getName());
+        if (it != storage.chunk_lengths.end()) {
+          chunk_length = it->second == 0 ? dim.getSize() : std::min(it->second, dim.getSize());
+        }
+        chunk_lengths.push_back(std::max<size_t>(chunk_length, 1));
+      }
+      nc_var.setChunking(netCDF::NcVar::nc_CHUNKED, chunk_lengths);
+    }
+
+    // Without any filter nor chunk shape, the variable is stored contiguously
+    bool deflate = storage.compression_level > 0;
+    if (deflate || storage.shuffle) {
+      nc_var.setCompression(storage.shuffle, deflate, storage.compression_level);
+    }
+  }
+
   std::vector<netCDF::NcDim> to_netcdf(std::shared_ptr<DimensionGrid> dimension_grid,
-                                       netCDF::NcGroup &group) {
+                                       netCDF::NcGroup &group,
+                                       const WriteOptions &write_options) {
     // Does the group has already these dimensions (and only these dimensions with the same data)
 
     std::vector<netCDF::NcDim> dims;
@@ -43,11 +107,17 @@ namespace poem {
 
         // Write variables to the group
         auto nc_var = group.addVar(dim_name, netCDF::ncDouble, dim);
-        nc_var.setCompression(true, true, 5);
+        auto storage = write_options.coordinates;
+        storage.chunk_lengths.clear();
+        set_storage(nc_var, {dim}, storage);
         nc_var.putVar(dimension_grid->values(dim_name).data());
 
         nc_var.putAtt("unit", dimension->unit());
         nc_var.putAtt("description", dimension->description());
+        if (dimension->is_periodic()) {
+          nc_var.putAtt("periodicity", dimension_periodicity_to_string(dimension->periodicity()));
+          nc_var.putAtt("period", netCDF::ncDouble, dimension->period());
+        }
         nc_var.putAtt("POEM_NODE_TYPE", "POLAR_DIMENSION");
       }
 
@@ -144,9 +214,9 @@ namespace poem {
     }
   }
 
-  void to_netcdf(std::shared_ptr<Polar> polar, netCDF::NcGroup &group) {
+  void to_netcdf(std::shared_ptr<Polar> polar, netCDF::NcGroup &group, const WriteOptions &write_options) {
     for (const auto &polar_table: polar->children<PolarTableBase>()) {
-      to_netcdf(polar_table, group);
+      to_netcdf(polar_table, group, write_options);
     }
 
     to_netcdf(polar->attributes(), group);
@@ -155,24 +225,24 @@ namespace poem {
     group.putAtt("description", polar->description());
   }
 
-  void to_netcdf(std::shared_ptr<PolarSet> polar_set, netCDF::NcGroup &group) {
+  void to_netcdf(std::shared_ptr<PolarSet> polar_set, netCDF::NcGroup &group, const WriteOptions &write_options) {
     for (const auto &polar: polar_set->children<Polar>()) {
       auto new_group = group.addGroup(polar_mode_to_string(polar->mode()));
-      to_netcdf(polar, new_group);
+      to_netcdf(polar, new_group, write_options);
     }
     to_netcdf(polar_set->attributes(), group);
     group.putAtt("POEM_NODE_TYPE", "POLAR_SET");
     group.putAtt("description", polar_set->description());
   }
 
-  void to_netcdf(std::shared_ptr<PolarNode> polar_node, netCDF::NcGroup &group) {
+  void to_netcdf(std::shared_ptr<PolarNode> polar_node, netCDF::NcGroup &group, const WriteOptions &write_options) {
 
     switch (polar_node->polar_node_type()) {
 
       case POLAR_NODE: {
         for (const auto &next_polar_node: polar_node->children<PolarNode>()) {
           auto new_group = group.addGroup(next_polar_node->name());
-          to_netcdf(next_polar_node, new_group);
+          to_netcdf(next_polar_node, new_group, write_options);
         }
         to_netcdf(polar_node->attributes(), group);
         group.putAtt("POEM_NODE_TYPE", "POLAR_NODE");
@@ -181,12 +251,12 @@ namespace poem {
       }
 
       case POLAR_SET: {
-        to_netcdf(polar_node->as_polar_set(), group);
+        to_netcdf(polar_node->as_polar_set(), group, write_options);
         break;
       }
 
       case POLAR: {
-        to_netcdf(polar_node->as_polar(), group);
+        to_netcdf(polar_node->as_polar(), group, write_options);
         break;
       }
 
@@ -196,11 +266,11 @@ namespace poem {
 
         switch (type) {
           case POEM_DOUBLE:
-            to_netcdf(polar_table->as_polar_table_double(), netCDF::ncDouble, group);
+            to_netcdf(polar_table->as_polar_table_double(), netCDF::ncDouble, group, write_options);
             break;
 
           case POEM_INT:
-            to_netcdf(polar_table->as_polar_table_int(), netCDF::ncInt, group);
+            to_netcdf(polar_table->as_polar_table_int(), netCDF::ncInt, group, write_options);
             break;
 
           default:
@@ -217,14 +287,16 @@ namespace poem {
   void to_netcdf(std::shared_ptr<PolarNode> polar_node,
                  const std::string &vessel_name,
                  const std::string &filename,
-                 bool verbose) {
+                 bool verbose,
+                 const WriteOptions &write_options) {
+    std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
     if (verbose)
       LogNormalInfo("Writing file <v{}>: {}",
                     current_poem_standard_version(),
                     fs::absolute(filename).string());
 
     netCDF::NcFile root_group(filename, netCDF::NcFile::replace);
-    to_netcdf(polar_node, root_group);
+    to_netcdf(polar_node, root_group, write_options);
     root_group.putAtt("POEM_LIBRARY_VERSION", git::version_full());
     root_group.putAtt("POEM_SPECIFICATION_VERSION", "v" + std::to_string(current_poem_standard_version()));
     auto now = time(nullptr) ;
@@ -257,17 +329,26 @@ namespace poem {
       CRITICAL_ERROR_POEM
     }
 
+    std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
     netCDF::NcFile datafile(std::string(filename), netCDF::NcFile::read);
+    int major_version = get_version(datafile);
+    datafile.close();
+
+    return major_version;
+  }
+
+  int get_version(const netCDF::NcGroup &root_group) {
+    auto atts = root_group.getAtts();
 
     int major_version;
-    if (datafile.getAtts().contains("polar_type")) {
+    if (atts.contains("polar_type")) {
       major_version = 0;
 
     } else {
       // POEM spec version >= 1
-      if (datafile.getAtts().contains("POEM_SPECIFICATION_VERSION")) {
+      if (atts.contains("POEM_SPECIFICATION_VERSION")) {
         std::string spec_version;
-        datafile.getAtt("POEM_SPECIFICATION_VERSION").getValues(spec_version);
+        atts.find("POEM_SPECIFICATION_VERSION")->second.getValues(spec_version);
         major_version = (int) semver::version::parse(spec_version, false).major();
 
       } else {
@@ -277,8 +358,6 @@ namespace poem {
       }
     }
 
-    datafile.close();
-
     return major_version;
   }
 
@@ -299,15 +378,13 @@ namespace poem {
           excluded_attributes.end())
         continue;
 
-      try {
-        std::string val;
-        nc_object.getAtt(att.first).getValues(val);
-        polar_node->attributes().add_attribute(att.first, val);
-      } catch (const std::exception &e) {
-        continue;
-//        LogWarningError("Skip reading attribute {}", att.first);
-      }
+      // Only text attributes are kept
+      auto type_class = att.second.getType().getTypeClass();
+      if (type_class != netCDF::NcType::nc_CHAR && type_class != netCDF::NcType::nc_STRING) continue;
 
+      std::string val;
+      att.second.getValues(val);
+      polar_node->attributes().add_attribute(att.first, val);
     }
   }
 
@@ -316,7 +393,61 @@ namespace poem {
     return std::equal(ending.rbegin(), ending.rend(), value.rbegin());
   }
 
-  std::shared_ptr<PolarNode> load_v0(const netCDF::NcGroup &root_group) {
+  /**
+   * Loader reading the values of nc_var from the file filename, opened again at each call
+   */
+  template<typename T>
+  std::function<void(T *)> netcdf_loader(const netCDF::NcVar &nc_var, const std::string &filename) {
+    // Path of the variable from the root group
+    std::vector<std::string> group_names;
+    std::istringstream group_path(nc_var.getParentGroup().getName(true));
+    std::string group_name;
+    while (std::getline(group_path, group_name, '/')) {
+      if (!group_name.empty()) group_names.push_back(group_name);
+    }
+    return [filename, group_names, var_name = nc_var.getName()](T *values) {
+      std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+      netCDF::NcFile file(filename, netCDF::NcFile::read);
+      netCDF::NcGroup group = file;
+      for (const auto &group_name: group_names) {
+        group = group.getGroup(group_name);
+      }
+      group.getVar(var_name).getVar(values);
+    };
+  }
+
+  /**
+   * Reads the values of polar_table from nc_var, or makes them fetched from the file jit_filename at first access if
+   * not empty (see PolarTable::set_jit_loader), or schedules them in chunk_reader if not null
+   */
+  template<typename T>
+  void read_values(const netCDF::NcVar &nc_var,
+                   PolarTable<T> &polar_table,
+                   const std::string &jit_filename,
+                   ChunkReader *chunk_reader) {
+    if (!jit_filename.empty()) {
+      polar_table.set_jit_loader(netcdf_loader<T>(nc_var, jit_filename));
+      return;
+    }
+
+    if (chunk_reader) {
+      std::string path = nc_var.getParentGroup().getName(true);
+      if (!path.ends_with('/')) path += '/';
+      path += nc_var.getName();
+      T *values = polar_table.values().data();
+      chunk_reader->schedule(path, values, polar_table.size(),
+                             [loader = netcdf_loader<T>(nc_var, chunk_reader->filename()), values]() {
+                               loader(values);
+                             });
+      return;
+    }
+
+    nc_var.getVar(polar_table.values().data());
+  }
+
+  std::shared_ptr<PolarNode> load_v0(const netCDF::NcGroup &root_group,
+                                     const std::string &jit_filename,
+                                     ChunkReader *chunk_reader) {
 
     std::unordered_map<std::string, std::string> dimension_map{
         {"STW_kt",  "STW_dim"},
@@ -428,11 +559,11 @@ namespace poem {
         switch (nc_var.second.getType().getTypeClass()) {
           case netCDF::NcType::nc_DOUBLE:
             polar_table = make_polar_table_double(nc_var.first, unit, description, dimension_grid);
-            nc_var.second.getVar(polar_table->as_polar_table_double()->values().data());
+            read_values(nc_var.second, *polar_table->as_polar_table_double(), jit_filename, chunk_reader);
             break;
           case netCDF::NcType::nc_INT:
             polar_table = make_polar_table_int(nc_var.first, unit, description, dimension_grid);
-            nc_var.second.getVar(polar_table->as_polar_table_int()->values().data());
+            read_values(nc_var.second, *polar_table->as_polar_table_int(), jit_filename, chunk_reader);
             break;
           default:
             LogWarningError("In group {}, PolarTable {} of type {} not managed by POEM. Skip...",
@@ -477,182 +608,234 @@ namespace poem {
     return polar;
   }
 
-  std::shared_ptr<PolarNode> load_group(const netCDF::NcGroup &group) {
+  /**
+   * Attributes of a POEM object other than the ones managed by POEM
+   */
+  void read_attributes(const std::map<std::string, std::string> &attributes, std::shared_ptr<PolarNode> polar_node) {
+    for (const auto &[name, value]: attributes) {
+      if (std::find(excluded_attributes.begin(), excluded_attributes.end(), name) != excluded_attributes.end())
+        continue;
+      polar_node->attributes().add_attribute(name, value);
+    }
+  }
 
-    std::shared_ptr<PolarNode> polar_node;
+  /**
+   * Builds the PolarNode of group from its metadata, nullptr if group is not a POEM group. Only the values of
+   * PolarTables are read from the file.
+   */
+  std::shared_ptr<PolarNode> load_group(const v1::GroupMetadata &group,
+                                        const std::string &jit_filename,
+                                        ChunkReader *chunk_reader) {
 
-    if (group.getAtts().contains("POEM_NODE_TYPE")) {
+    if (!group.is_poem_object()) return nullptr;
 
-      std::string group_name;
-      if (group.isRootGroup()) {
-        group.getAtt("VESSEL_NAME").getValues(group_name);
-      } else {
-        group_name = group.getName(false);
-      }
+    std::string group_name = group.is_root ? group.attribute("VESSEL_NAME") : group.name;
+    std::string node_type = group.attribute("POEM_NODE_TYPE");
 
-      std::string node_type;
-      group.getAtt("POEM_NODE_TYPE").getValues(node_type);
-
-      if (node_type == "POLAR") {
-
-        std::shared_ptr<DimensionGrid> dimension_grid;
-        std::vector<std::shared_ptr<PolarTableBase>> polar_tables;
-        for (const auto &nc_var: group.getVars()) {
-          if (!nc_var.second.getAtts().contains("POEM_NODE_TYPE")) continue;
-
-          if (!group.getCoordVars().contains(nc_var.first)) {
-            // This is not a Coordinate Variable
-
-            if (!dimension_grid) {
-              // Dimension grid not built, building it!
-              auto nc_dims = nc_var.second.getDims();
-              std::vector<std::shared_ptr<Dimension>> dimensions;
-              dimensions.reserve(nc_dims.size());
-
-              for (const auto &nc_dim: nc_dims) {
-                auto var_dim = group.getVar(nc_dim.getName());
-                std::string unit;
-                var_dim.getAtt("unit").getValues(unit);
-                std::string description;
-                var_dim.getAtt("description").getValues(description);
-                auto dim_ = make_dimension(nc_dim.getName(), unit, description);
-                dimensions.push_back(dim_);
-              }
-              auto dimension_set = make_dimension_set(dimensions);
-              dimension_grid = make_dimension_grid(dimension_set);
-
-              for (const auto &nc_dim: nc_dims) {
-                auto var_dim = group.getVar(nc_dim.getName());
-                std::vector<double> values(nc_dim.getSize());
-                var_dim.getVar(values.data());
-                dimension_grid->set_values(nc_dim.getName(), values);
-              }
-
-            }  // end building DimensionGrid
+    std::shared_ptr<PolarNode> polar_node;
+    if (node_type == "POLAR") {
 
-            std::string unit;
-            nc_var.second.getAtt("unit").getValues(unit);
-            std::string description;
-            nc_var.second.getAtt("description").getValues(description);
-
-            std::shared_ptr<PolarTableBase> polar_table;
-            switch (nc_var.second.getType().getTypeClass()) {
-              case netCDF::NcType::nc_DOUBLE:
-                polar_table = make_polar_table_double(nc_var.first, unit, description, dimension_grid);
-                nc_var.second.getVar(polar_table->as_polar_table_double()->values().data());
-                break;
-              case netCDF::NcType::nc_INT:
-                polar_table = make_polar_table_int(nc_var.first, unit, description, dimension_grid);
-                nc_var.second.getVar(polar_table->as_polar_table_int()->values().data());
-                break;
-              default:
-                LogWarningError("In group {}, PolarTable {} of type {} not managed by POEM. Skip...",
-                                group.getName(true), nc_var.first, nc_var.second.getType().getTypeClassName());
-                continue;
+      std::shared_ptr<DimensionGrid> dimension_grid;
+      std::vector<std::shared_ptr<PolarTableBase>> polar_tables;
+      for (const auto &variable: group.variables) {
+        // Only PolarTables, Coordinate Variables being read with the first of them
+        if (!variable.is_poem_object() || variable.is_coord_var) continue;
+
+        if (!dimension_grid) {
+          // Dimension grid not built, building it!
+          std::vector<std::shared_ptr<Dimension>> dimensions;
+          dimensions.reserve(variable.dimensions.size());
+          for (const auto &dimension_name: variable.dimensions) {
+            auto coord_var = group.variable(dimension_name);
+            if (!coord_var || coord_var->values().empty()) {
+              LogCriticalError("In group {}, Coordinate Variable of Dimension {} of PolarTable {} not found",
+                               group.path, dimension_name, variable.name);
+              CRITICAL_ERROR_POEM
             }
-            // FIXME: il semblerait qu'on le lise pas les valeurs de la PolarTable !!!
 
-            read_attributes(nc_var.second, polar_table);
-            polar_tables.push_back(polar_table);
+            // Optional periodicity of angular dimensions
+            DIMENSION_PERIODICITY periodicity = NON_PERIODIC;
+            double period = 360.;
+            if (coord_var->attributes.contains("periodicity")) {
+              periodicity = string_to_dimension_periodicity(coord_var->attribute("periodicity"));
+              auto it = coord_var->numerical_attributes.find("period");
+              if (it != coord_var->numerical_attributes.end()) period = it->second;
+            }
 
+            dimensions.push_back(make_dimension(dimension_name, coord_var->attribute("unit"),
+                                                coord_var->attribute("description"), periodicity, period));
           }
-        }
+          auto dimension_set = make_dimension_set(dimensions);
+          dimension_grid = make_dimension_grid(dimension_set);
 
-        std::string polar_mode_str;
-        group.getAtt("POEM_MODE").getValues(polar_mode_str);
-        POLAR_MODE polar_mode = string_to_polar_mode(polar_mode_str);
-        polar_node = make_polar(group_name, polar_mode, dimension_grid);
+          for (const auto &dimension_name: variable.dimensions) {
+            dimension_grid->set_values(dimension_name, group.variable(dimension_name)->values());
+          }
 
-        // Attaching each created PolarTable to the Polar
-        for (const auto &polar_table: polar_tables) {
-          polar_node->add_child(polar_table, false);
-        }
+        }  // end building DimensionGrid
 
-        // END group is POLAR
-      } else if (node_type == "POLAR_SET") {
-        std::string description;
-        group.getAtt("description").getValues(description);
-        polar_node = make_polar_set(group_name, description);
+        auto unit = variable.attribute("unit");
+        auto description = variable.attribute("description");
 
-      } else if (node_type == "POLAR_NODE") {
-        std::string description;
-        group.getAtt("description").getValues(description);
-        polar_node = make_polar_node(group_name, description);
+        std::shared_ptr<PolarTableBase> polar_table;
+        switch (variable.type) {
+          case netCDF::NcType::nc_DOUBLE:
+            polar_table = make_polar_table_double(variable.name, unit, description, dimension_grid);
+            read_values(variable.nc_var, *polar_table->as_polar_table_double(), jit_filename, chunk_reader);
+            break;
+          case netCDF::NcType::nc_INT:
+            polar_table = make_polar_table_int(variable.name, unit, description, dimension_grid);
+            read_values(variable.nc_var, *polar_table->as_polar_table_int(), jit_filename, chunk_reader);
+            break;
+          default:
+            LogWarningError("In group {}, PolarTable {} of type {} not managed by POEM. Skip...",
+                            group.path, variable.name, variable.nc_var.getType().getTypeClassName());
+            continue;
+        }
 
+        read_attributes(variable.attributes, polar_table);
+        polar_tables.push_back(polar_table);
       }
 
-      for (const auto &group_: group.getGroups()) {
-        auto polar_node_ = load_group(group_.second);
-        polar_node->add_child(polar_node_);
+      POLAR_MODE polar_mode = string_to_polar_mode(group.attribute("POEM_MODE"));
+      polar_node = make_polar(group_name, polar_mode, dimension_grid);
+
+      // Attaching each created PolarTable to the Polar
+      for (const auto &polar_table: polar_tables) {
+        polar_node->add_child(polar_table, false);
       }
 
+      // END group is POLAR
+    } else if (node_type == "POLAR_SET") {
+      polar_node = make_polar_set(group_name, group.attribute("description"));
+
+    } else if (node_type == "POLAR_NODE") {
+      polar_node = make_polar_node(group_name, group.attribute("description"));
+
+    } else {
+      LogCriticalError("In group {}, unknown POEM_NODE_TYPE {}", group.path, node_type);
+      CRITICAL_ERROR_POEM
     }
 
-    read_attributes(group, polar_node);
+    for (const auto &group_: group.groups) {
+      auto polar_node_ = load_group(group_, jit_filename, chunk_reader);
+      if (polar_node_) polar_node->add_child(polar_node_);
+    }
+
+    read_attributes(group.attributes, polar_node);
 
     return polar_node;
 
   }
 
-  std::shared_ptr<PolarNode> load_v1(const netCDF::NcGroup &root_group) {
+  std::shared_ptr<PolarNode> load_v1(const netCDF::NcGroup &root_group,
+                                     const std::string &jit_filename,
+                                     ChunkReader *chunk_reader) {
 
     if (!root_group.isRootGroup()) {
       LogCriticalError("In load_v1, not a root group");
       CRITICAL_ERROR_POEM
     }
 
-    return load_group(root_group);
+    return load_group(v1::read_metadata(root_group), jit_filename, chunk_reader);
   }
 
   std::shared_ptr<PolarNode> load(const std::string &filename,
                                   bool spec_checking,
-                                  bool verbose) {
+                                  bool verbose,
+                                  bool pack,
+                                  bool jit,
+                                  size_t n_threads) {
 
     if (verbose)
       LogNormalInfo("Reading file: {}", fs::absolute(filename).string());
-    int major_version = get_version(filename);
+    if (!fs::exists(filename)) {
+      LogCriticalError("NetCDF file not found: {}", filename);
+      CRITICAL_ERROR_POEM
+    }
+
+    // Held until the values are read, JIT loaders of other trees possibly running concurrently
+    std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+
+    // The file is opened once, for version detection, compliance check and reading
+    auto start = std::chrono::steady_clock::now();
+    netCDF::NcFile root_group(filename, netCDF::NcFile::read);
+    int major_version = get_version(root_group);
     if (verbose)
       LogNormalInfo("POEM specification v{} detected in file", major_version);
 
-    // Check compliancy with specification
-    if (spec_checking) {
-      if (!spec_check(filename, major_version)) {
-        LogCriticalError("File is not compliant POEM Specification version {}", major_version);
-        CRITICAL_ERROR_POEM
-      } else {
-        if (verbose)
-          LogNormalInfo("File is compliant with version v{}", major_version);
-      }
+    std::string jit_filename = jit ? fs::absolute(filename).string() : "";
+    // Values read by chunks once the tree is built
+    std::unique_ptr<ChunkReader> chunk_reader;
+    if (!jit && n_threads != 1) {
+      chunk_reader = std::make_unique<ChunkReader>(fs::absolute(filename).string(), n_threads);
     }
-
-    netCDF::NcFile root_group(filename, netCDF::NcFile::read);
     std::shared_ptr<PolarNode> root_node;
     switch (major_version) {
 
       case 0: {
-        root_node = load_v0(root_group);
+        // Check compliancy with specification
+        if (spec_checking) {
+          if (!check_v0(filename)) {
+            LogCriticalError("File is not compliant POEM Specification version {}", major_version);
+            CRITICAL_ERROR_POEM
+          } else if (verbose) {
+            LogNormalInfo("File is compliant with version v{}", major_version);
+          }
+        }
+
+        root_node = load_v0(root_group, jit_filename, chunk_reader.get());
         root_node->change_name(fs::path(filename).stem().string()); // FIXME: pourquoi Luc a introduit ca ?
       }
         break;
 
       case 1: {
+        // Metadata read in one traversal of the file, then checked against every rule
+        auto metadata = v1::read_metadata(root_group);
+
+        if (spec_checking) {
+          auto report = v1::check(metadata);
+          if (!report.compliant()) {
+            report.log();
+            LogCriticalError("File is not compliant POEM Specification version {}", major_version);
+            CRITICAL_ERROR_POEM
+          } else if (verbose) {
+            LogNormalInfo("File is compliant with version v{}", major_version);
+          }
+        }
+
         try {
-          root_node = load_v1(root_group);
-          break;
+          root_node = load_group(metadata, jit_filename, chunk_reader.get());
         } catch (const PoemException &e) {
+          root_node = nullptr;
+        }
+        if (!root_node) {
           LogCriticalError("Error while reading POEM File using specification v{}: {}",
                            major_version, fs::absolute(filename).string());
           LogCriticalError("Please spec check the file to get more insight on the problem");
           CRITICAL_ERROR_POEM
         }
-
       }
+        break;
 
       default:
         LogCriticalError("Specification version v{} not known", major_version);
         CRITICAL_ERROR_POEM
     }
     root_group.close();
+    if (chunk_reader) {
+      chunk_reader->read();
+    }
+    if (verbose) {
+      std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+      LogNormalInfo("File read in {:.1f} ms{}", elapsed.count(), chunk_reader ? " (parallel chunk decompression)" : "");
+    }
+
+    if (pack) {
+      root_node->pack();
+    }
+
+    MemoryManager::instance().track(root_node, fs::absolute(filename).string());
 
     return root_node;
   }
@@ -7,6 +7,11 @@
 
 #include <netcdf>
 #include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "exceptions.h"
 #include "enums.h"
@@ -30,6 +35,58 @@ namespace poem {
 
   class PolarNode;
 
+  class ChunkReader;
+
+  /**
+   * Storage of a netCDF variable written by to_netcdf
+   */
+  struct StorageOptions {
+    // Chunk length along Dimensions given by name, 0 meaning the whole Dimension and Dimensions not given having a chunk
+    // length of 1. Dimensions not in the variable are ignored. Empty leaves the chunk shape to the netCDF library.
+    std::unordered_map<std::string, size_t> chunk_lengths;
+    // Deflate level from 1 to 9, 0 meaning no compression
+    int compression_level = 5;
+    bool shuffle = true;
+
+    /**
+     * Chunks made of whole planes (or volumes...) along the given Dimensions, e.g. {"STW_dim", "TWA_dim"}
+     */
+    static StorageOptions whole(const std::vector<std::string> &dimension_names,
+                                int compression_level = 5,
+                                bool shuffle = true);
+
+    /**
+     * Contiguous storage without any filter
+     */
+    static StorageOptions uncompressed();
+  };
+
+  /**
+   * Options of to_netcdf. Default values give chunk shapes chosen by the netCDF library, deflate level 5 and shuffle.
+   */
+  struct WriteOptions {
+    // Storage of the PolarTables
+    StorageOptions polar_tables;
+    // Storage of the PolarTables given by name, overriding polar_tables
+    std::unordered_map<std::string, StorageOptions> per_polar_table;
+    // Storage of the coordinate variables of the Dimensions. Chunk lengths are ignored.
+    StorageOptions coordinates;
+
+    /**
+     * Storage of the PolarTable named polar_table_name
+     */
+    [[nodiscard]] const StorageOptions &storage(const std::string &polar_table_name) const;
+  };
+
+
+  /**
+   * Process wide mutex serializing the calls to the netCDF and HDF5 libraries, which are not thread safe
+   *
+   * It is taken by the functions opening a file (load, to_netcdf, get_version, check_v1_report), by ChunkReader::read
+   * and by the JIT loaders of PolarTables, so that JIT trees may be queried while other files are read or written.
+   * Applications calling these libraries directly while JIT trees are queried must take it too. Recursive.
+   */
+  std::recursive_mutex &netcdf_mutex();
 
   // ===================================================================================================================
   // WRITERS
@@ -38,27 +95,45 @@ namespace poem {
   template<typename T>
   void to_netcdf(std::shared_ptr<PolarTable<T>> polar_table,
                  const netCDF::NcType &nc_type,
-                 netCDF::NcGroup &group);
+                 netCDF::NcGroup &group,
+                 const WriteOptions &write_options = WriteOptions());
+
+  /**
+   * Applies storage to nc_var, of Dimensions dims, before any value is written
+   */
+  void set_storage(netCDF::NcVar &nc_var, const std::vector<netCDF::NcDim> &dims, const StorageOptions &storage);
 
   int current_poem_standard_version();
 
-  std::vector<netCDF::NcDim> write_dimension_grid(std::shared_ptr<DimensionGrid> dimension_grid,
-                                                  netCDF::NcGroup &group);
+  std::vector<netCDF::NcDim> to_netcdf(std::shared_ptr<DimensionGrid> dimension_grid,
+                                       netCDF::NcGroup &group,
+                                       const WriteOptions &write_options = WriteOptions());
 
   void to_netcdf(const Attributes &attributes, netCDF::NcGroup &group);
 
   void to_netcdf(const Attributes &attributes, netCDF::NcVar &nc_var);
 
-  void to_netcdf(std::shared_ptr<Polar> polar, netCDF::NcGroup &group);
+  void to_netcdf(std::shared_ptr<Polar> polar,
+                 netCDF::NcGroup &group,
+                 const WriteOptions &write_options = WriteOptions());
 
-  void to_netcdf(std::shared_ptr<PolarSet> polar_set, netCDF::NcGroup &group);
+  void to_netcdf(std::shared_ptr<PolarSet> polar_set,
+                 netCDF::NcGroup &group,
+                 const WriteOptions &write_options = WriteOptions());
 
-  void to_netcdf(std::shared_ptr<PolarNode> polar_node, netCDF::NcGroup &group);
+  void to_netcdf(std::shared_ptr<PolarNode> polar_node,
+                 netCDF::NcGroup &group,
+                 const WriteOptions &write_options = WriteOptions());
 
+  /**
+   * Writes a PolarNode, PolarSet, Polar or PolarTable to a netCDF file, with the chunking and compression of
+   * write_options
+   */
   void to_netcdf(std::shared_ptr<PolarNode> polar_node,
                  const std::string &vessel_name,
                  const std::string &filename,
-                 bool verbose = true);
+                 bool verbose = true,
+                 const WriteOptions &write_options = WriteOptions());
 
   // ===================================================================================================================
   // READERS
@@ -66,13 +141,53 @@ namespace poem {
 
   int get_version(const std::string &filename);
 
-  std::shared_ptr<PolarNode> load_v0(const netCDF::NcGroup &root_group);
-
-  std::shared_ptr<PolarNode> load_v1(const netCDF::NcGroup &root_group);
-
+  /**
+   * Major version of the POEM specification of an opened file, from its root group
+   */
+  int get_version(const netCDF::NcGroup &root_group);
+
+  /**
+   * Reads a POEM file v0 from its root group. If jit_filename is not empty, PolarTable values are not read but fetched
+   * from the file jit_filename at first access (see PolarTable::set_jit_loader). Otherwise, if chunk_reader is not
+   * null, values are scheduled in it and read by ChunkReader::read once the file is closed.
+   */
+  std::shared_ptr<PolarNode> load_v0(const netCDF::NcGroup &root_group,
+                                     const std::string &jit_filename = "",
+                                     ChunkReader *chunk_reader = nullptr);
+
+  /**
+   * Reads a POEM file v1 from its root group (see load_v0 for jit_filename and chunk_reader)
+   */
+  std::shared_ptr<PolarNode> load_v1(const netCDF::NcGroup &root_group,
+                                     const std::string &jit_filename = "",
+                                     ChunkReader *chunk_reader = nullptr);
+
+  /**
+   * Reads a POEM file
+   *
+   * The file is opened once. For v1 files, attributes and coordinate variables are read in a single traversal of the
+   * groups (see v1::read_metadata), then PolarTable values.
+   *
+   * @param spec_checking checks the file against its POEM specification, every violation being logged before failing
+   * @param verbose logs the reading steps
+   * @param pack switches every Polar to its interleaved storage (see Polar::pack). Values are then read at once.
+   * @param jit only reads the tree and the DimensionGrids, PolarTable values being fetched from the file at first
+   * access and released by PolarTable::jit_unload. The file must stay available. The netCDF library not being thread
+   * safe, JIT loaders take netcdf_mutex, as every netCDF call of the library does: JIT trees may be queried
+   * concurrently with other loads or writes.
+   *
+   * @param n_threads number of threads inflating the compressed chunks of the PolarTables (see ChunkReader). 1 reads
+   * them with the netCDF library, 0 means one thread per hardware core. Not used with jit.
+   *
+   * The tree is tracked by the MemoryManager under the absolute path of the file, JIT tables being evicted under its
+   * memory budget.
+   */
   std::shared_ptr<PolarNode> load(const std::string &filename,
                                   bool spec_checking = true,
-                                  bool verbose = true);
+                                  bool verbose = true,
+                                  bool pack = false,
+                                  bool jit = false,
+                                  size_t n_threads = 1);
 
 }  // poem
 
@@ -7,9 +7,10 @@ namespace poem {
   template<typename T>
   void to_netcdf(std::shared_ptr<PolarTable<T>> polar_table,
                  const netCDF::NcType &nc_type,
-                 netCDF::NcGroup &group) {
+                 netCDF::NcGroup &group,
+                 const WriteOptions &write_options) {
 
-    auto dims = to_netcdf(polar_table->dimension_grid(), group);
+    auto dims = to_netcdf(polar_table->dimension_grid(), group, write_options);
 
     // Storing the values
     auto polar_name = polar_table->name();
@@ -22,9 +23,19 @@ namespace poem {
 
     netCDF::NcVar nc_var = group.addVar(polar_name, nc_type, dims);
 
-    nc_var.setCompression(true, true, 5);
-
-    nc_var.putVar(polar_table->values().data());
+    set_storage(nc_var, dims, write_options.storage(polar_name));
+
+    // Pinned not to be evicted while written, a packed table being gathered without being unpacked
+    auto values = polar_table->view();
+    if (values.stride() == 1) {
+      nc_var.putVar(values.data());
+    } else {
+      std::vector<T> gathered(values.size());
+      for (size_t idx = 0; idx < gathered.size(); ++idx) {
+        gathered[idx] = values[idx];
+      }
+      nc_var.putVar(gathered.data());
+    }
     nc_var.putAtt("unit", polar_table->unit());
     nc_var.putAtt("description", polar_table->description());
     nc_var.putAtt("POEM_NODE_TYPE","POLAR_TABLE");
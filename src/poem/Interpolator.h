@@ -0,0 +1,620 @@
+#ifndef POEM_INTERPOLATOR_H
+#define POEM_INTERPOLATOR_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "exceptions.h"
+#include "DimensionSet.h"
+#include "DimensionPoint.h"
+#include "DimensionGrid.h"
+#include "OutOfBound.h"
+#include "Spline.h"
+#include "simd.h"
+
+namespace poem {
+
+  // Forward declaration
+  template<typename T>
+  class PolarTable;
+
+  /**
+   * Maximum number of dimensions supported by the runtime dimension interpolator Interpolator<T, 0>
+   *
+   * Corners of the cell being held on the stack, this bounds its size to 2^POEM_MAX_DIMS values
+   */
+  constexpr size_t POEM_MAX_DIMS = 10;
+
+  /**
+   * Offsets of the 2^ndims corners of a cell whose lower corner is at offset, steps giving the offset between the lower
+   * and the upper corner along each dimension
+   *
+   * Bit idim of the corner index tells if the corner is the lower or the upper one along dimension idim.
+   */
+  inline void corner_offsets(size_t offset, const size_t *steps, size_t ndims, size_t *offsets) {
+    offsets[0] = offset;
+    for (size_t idim = 0, n = 1; idim < ndims; ++idim, n *= 2) {
+      for (size_t icorner = 0; icorner < n; ++icorner) {
+        offsets[n + icorner] = offsets[icorner] + steps[idim];
+      }
+    }
+  }
+
+  /**
+   * Multilinear combination of the 2^ndims corners of a cell, located into values by offsets (see corner_offsets)
+   *
+   * Consecutive values are stride apart into values (see PolarTable::stride). The reduction is made by successive
+   * linear interpolations along dimensions, starting from the first one.
+   */
+  template<typename T, size_t max_corners>
+  inline T multilinear(const T *values, size_t stride, const size_t *offsets, const double *weights, size_t ndims) {
+    const size_t n_corners = (size_t) 1 << ndims;
+
+    std::array<T, max_corners> corners;
+    for (size_t icorner = 0; icorner < n_corners; ++icorner) {
+      corners[icorner] = values[offsets[icorner] * stride];
+    }
+
+    for (size_t idim = 0, n = n_corners / 2; idim < ndims; ++idim, n /= 2) {
+      double weight = weights[idim];
+      for (size_t icorner = 0; icorner < n; ++icorner) {
+        corners[icorner] = corners[2 * icorner] + weight * (corners[2 * icorner + 1] - corners[2 * icorner]);
+      }
+    }
+
+    return corners[0];
+  }
+
+  /**
+   * Same as multilinear, also giving into gradient the ndims partial derivatives with respect to the coordinates,
+   * widths being the widths of the cell along each dimension
+   *
+   * The partial derivative along idim is the same reduction, the interpolation along idim being replaced by the slope
+   * between the lower and upper faces. It is null along singleton dimensions (null width).
+   */
+  template<size_t max_corners>
+  inline double multilinear_gradient(const double *values,
+                                     size_t stride,
+                                     const size_t *offsets,
+                                     const double *weights,
+                                     const double *widths,
+                                     size_t ndims,
+                                     double *gradient) {
+    const size_t n_corners = (size_t) 1 << ndims;
+
+    std::array<double, max_corners> corners;
+    for (size_t icorner = 0; icorner < n_corners; ++icorner) {
+      corners[icorner] = values[offsets[icorner] * stride];
+    }
+
+    std::array<double, max_corners> work;
+    for (size_t jdim = 0; jdim < ndims; ++jdim) {
+      if (widths[jdim] == 0.) {
+        gradient[jdim] = 0.;
+        continue;
+      }
+      std::copy(corners.begin(), corners.begin() + n_corners, work.begin());
+      for (size_t idim = 0, n = n_corners / 2; idim < ndims; ++idim, n /= 2) {
+        double weight = weights[idim];
+        for (size_t icorner = 0; icorner < n; ++icorner) {
+          double lower = work[2 * icorner];
+          double upper = work[2 * icorner + 1];
+          work[icorner] = idim == jdim ? (upper - lower) / widths[idim] : lower + weight * (upper - lower);
+        }
+      }
+      gradient[jdim] = work[0];
+    }
+
+    for (size_t idim = 0, n = n_corners / 2; idim < ndims; ++idim, n /= 2) {
+      double weight = weights[idim];
+      for (size_t icorner = 0; icorner < n; ++icorner) {
+        corners[icorner] = corners[2 * icorner] + weight * (corners[2 * icorner + 1] - corners[2 * icorner]);
+      }
+    }
+    return corners[0];
+  }
+
+  /**
+   * Non template base class for Interpolator class used by PolarTable
+   */
+  struct InterpolatorBase {
+    virtual ~InterpolatorBase() {}
+
+    virtual void build() = 0;
+
+    /**
+     * Memory held by the interpolator in bytes
+     */
+    [[nodiscard]] virtual size_t memsize() const = 0;
+  };
+
+  /**
+   * Multidimensional interpolation class, multilinear or tensor product cubic Hermite (see INTERPOLATION_METHOD)
+   *
+   * The interpolator does not own any copy of the data. It reads directly into PolarTable::data() using the row major
+   * strides of the DimensionGrid (last dimension varies the fastest, as in NetCDF), packed tables included. Building it
+   * is then O(ndims) and does not allocate anything proportional to the size of the table.
+   *
+   * When the number of dimensions is a compile time constant, loops over dimensions and over the 2^_dim corners of the
+   * cell are unrolled by the compiler. _dim = 0 gives a runtime dimension interpolator, used for tables with more than
+   * 6 dimensions (up to POEM_MAX_DIMS). It runs the same loops over the 2^ndims corners, without recursion nor
+   * allocation.
+   *
+   * Cubic methods (double only) precompute the slopes of the table along each dimension at build (see hermite_slopes),
+   * ndims() values per node, up to POEM_MAX_SPLINE_MEMSIZE bytes. The mixed derivatives at the corners of the cell are
+   * centered differences of these slopes, computed at evaluation. The slopes must be computed again when the values of
+   * the table change.
+   *
+   * @tparam T the datatype of the interpolation
+   * @tparam _dim the number of dimension of the PolarTable, 0 for runtime number of dimensions
+   * @tparam _method the interpolation method
+   */
+  template<typename T, size_t _dim, INTERPOLATION_METHOD _method = LINEAR>
+  class Interpolator : public InterpolatorBase {
+    static_assert(_method == LINEAR || std::is_same_v<T, double>, "Cubic interpolation methods are for double only");
+
+    static constexpr size_t max_dims = _dim == 0 ? POEM_MAX_DIMS : _dim;
+    static constexpr size_t max_corners = 1 << max_dims;
+    static constexpr size_t max_spline_dims = std::min(max_dims, POEM_MAX_SPLINE_DIMS);
+
+   public:
+    explicit Interpolator(const PolarTable<T> *polar_table) : m_polar_table(polar_table) {}
+
+    void build() override {
+      m_dimension_grid = m_polar_table->dimension_grid();
+
+      if constexpr (_dim == 0) {
+        m_ndims = m_dimension_grid->ndims();
+        if (m_ndims > POEM_MAX_DIMS) {
+          LogCriticalError("In PolarTable {}, ND interpolation not supported for dimensions higher than {} (found {})",
+                           m_polar_table->name(), POEM_MAX_DIMS, m_ndims);
+          CRITICAL_ERROR_POEM
+        }
+      } else if (m_dimension_grid->ndims() != _dim) {
+        LogCriticalError("In PolarTable {}, building a {}D interpolator for a DimensionGrid with {} dimensions",
+                         m_polar_table->name(), _dim, m_dimension_grid->ndims());
+        CRITICAL_ERROR_POEM
+      }
+
+      size_t stride = 1;
+      for (int idim = (int) ndims() - 1; idim >= 0; --idim) {
+        const auto &values = m_dimension_grid->values(idim);
+        m_axes[idim] = values.data();
+        m_sizes[idim] = values.size();
+        m_strides[idim] = stride;
+        // Singleton dimensions are given a null step so that the upper corner is the lower one, with a null weight
+        m_steps[idim] = values.size() > 1 ? stride : 0;
+        stride *= values.size();
+      }
+
+      if constexpr (_method != LINEAR) {
+        if (ndims() > POEM_MAX_SPLINE_DIMS) {
+          LogCriticalError("In PolarTable {}, {} interpolation not supported for dimensions higher than {} (found {})",
+                           m_polar_table->name(), interpolation_method_to_string(_method), POEM_MAX_SPLINE_DIMS,
+                           ndims());
+          CRITICAL_ERROR_POEM
+        }
+        size_t slopes_memsize = m_dimension_grid->size() * ndims() * sizeof(double);
+        if (slopes_memsize > POEM_MAX_SPLINE_MEMSIZE) {
+          LogCriticalError("In PolarTable {}, {} interpolation needs {} MB of slopes, more than the {} MB allowed. Use "
+                           "LINEAR interpolation for this table", m_polar_table->name(),
+                           interpolation_method_to_string(_method), slopes_memsize >> 20,
+                           POEM_MAX_SPLINE_MEMSIZE >> 20);
+          CRITICAL_ERROR_POEM
+        }
+        hermite_slopes(_method, *m_dimension_grid, m_polar_table->data(), m_polar_table->stride(), m_slopes);
+      }
+    }
+
+    [[nodiscard]] size_t memsize() const override {
+      return sizeof(*this) + m_slopes.capacity() * sizeof(double);
+    }
+
+    /**
+     * Number of dimensions
+     */
+    [[nodiscard]] size_t ndims() const {
+      if constexpr (_dim == 0) {
+        return m_ndims;
+      } else {
+        return _dim;
+      }
+    }
+
+    /**
+     * Interpolates at coords, an array of ndims() coordinates given in the DimensionSet order
+     */
+    T interp(const double *coords, OUT_OF_BOUND_METHOD oob_method) const {
+      T value;
+      evaluate_point(coords, value, [this, oob_method](size_t idim, double &coord) {
+        coord = bound(idim, coord, oob_method);
+        return true;
+      });
+      return value;
+    }
+
+    T interp(const DimensionPoint &dimension_point, OUT_OF_BOUND_METHOD oob_method) const {
+      std::array<double, max_dims> coords;
+      std::copy(dimension_point.begin(), dimension_point.end(), coords.begin());
+      return interp(coords.data(), oob_method);
+    }
+
+    /**
+     * Non throwing interpolation at coords with one out of bound method per dimension (see PolarTable::query)
+     */
+    QUERY_STATUS query(const double *coords, const OUT_OF_BOUND_METHOD *oob_methods, T &value) const {
+      QUERY_STATUS status = IN_RANGE;
+      bool accepted = evaluate_point(coords, value, [this, oob_methods, &status](size_t idim, double &coord) {
+        return query_bound(idim, coord, oob_methods[idim], status);
+      });
+      if (!accepted) {
+        value = rejected_value<T>();
+      }
+      return status;
+    }
+
+    /**
+     * Batched interpolation on points given in structure-of-arrays layout (see PolarTable::interp_batch)
+     */
+    void interp_batch(const std::vector<const double *> &coords, size_t n_points, T *values,
+                      OUT_OF_BOUND_METHOD oob_method) const {
+      evaluate_batch(coords, n_points, values, [this, oob_method](size_t idim, size_t ipoint, double &coord) {
+        coord = bound(idim, coord, oob_method);
+        return true;
+      });
+    }
+
+    /**
+     * Non throwing batched interpolation with one out of bound method per dimension (see PolarTable::query_batch)
+     */
+    void query_batch(const std::vector<const double *> &coords, size_t n_points, T *values, QUERY_STATUS *statuses,
+                     const OUT_OF_BOUND_METHOD *oob_methods) const {
+      std::fill(statuses, statuses + n_points, IN_RANGE);
+      evaluate_batch(coords, n_points, values, [this, oob_methods, statuses](size_t idim, size_t ipoint, double &coord) {
+        return query_bound(idim, coord, oob_methods[idim], statuses[ipoint]);
+      });
+    }
+
+    /**
+     * Interpolation at coords also giving into gradient the ndims() partial derivatives with respect to the coordinates
+     * (see PolarTable::interp_with_gradient). double only.
+     */
+    T interp_with_gradient(const double *coords, double *gradient, OUT_OF_BOUND_METHOD oob_method) const {
+      static_assert(std::is_same_v<T, double>, "Gradients are for double only");
+      size_t offset = 0;
+      std::array<size_t, max_dims> indices;
+      std::array<size_t, max_dims> steps;
+      std::array<double, max_dims> weights;
+      std::array<double, max_dims> widths;
+      std::array<double, max_dims> chain;
+      for (size_t idim = 0; idim < ndims(); ++idim) {
+        double derivative;
+        double coord = m_dimension_grid->wrap(idim, coords[idim], derivative);
+        double bounded = bound(idim, coord, oob_method);
+        // Along a saturated coordinate, the value does not change
+        chain[idim] = bounded == coord ? derivative : 0.;
+        size_t index = locate(idim, bounded, weights[idim]);
+        indices[idim] = index;
+        offset += index * m_strides[idim];
+        steps[idim] = step(idim, index);
+        widths[idim] = m_dimension_grid->cell_width(idim, index);
+      }
+
+      std::array<size_t, max_corners> offsets;
+      corner_offsets(offset, steps.data(), ndims(), offsets.data());
+
+      T value;
+      if constexpr (_method == LINEAR) {
+        value = multilinear_gradient<max_corners>(m_polar_table->data(), m_polar_table->stride(), offsets.data(),
+                                                  weights.data(), widths.data(), ndims(), gradient);
+      } else {
+        std::array<double, (1 << (2 * max_spline_dims))> corners;
+        std::array<double, (1 << (2 * max_spline_dims - 1))> work;
+        hermite_corners(indices, offsets.data(), corners.data());
+        value = hermite_gradient<max_spline_dims>(corners.data(), weights.data(), widths.data(), ndims(), work.data(),
+                                                  gradient);
+      }
+
+      for (size_t idim = 0; idim < ndims(); ++idim) {
+        gradient[idim] *= chain[idim];
+      }
+      return value;
+    }
+
+    /**
+     * Batched interp_with_gradient on points given in structure-of-arrays layout, gradients holding one array of
+     * n_points partial derivatives per dimension
+     */
+    void interp_with_gradient_batch(const std::vector<const double *> &coords, size_t n_points, T *values,
+                                    const std::vector<double *> &gradients, OUT_OF_BOUND_METHOD oob_method) const {
+      std::array<double, max_dims> point;
+      std::array<double, max_dims> gradient;
+      for (size_t ipoint = 0; ipoint < n_points; ++ipoint) {
+        for (size_t idim = 0; idim < ndims(); ++idim) {
+          point[idim] = coords[idim][ipoint];
+        }
+        values[ipoint] = interp_with_gradient(point.data(), gradient.data(), oob_method);
+        for (size_t idim = 0; idim < ndims(); ++idim) {
+          gradients[idim][ipoint] = gradient[idim];
+        }
+      }
+    }
+
+   private:
+    /**
+     * Interpolation at coords, bound_(idim, coord) managing the out of bound coordinates. It returns false if the point
+     * is rejected, value being then left untouched.
+     */
+    template<class Bound>
+    inline bool evaluate_point(const double *coords, T &value, Bound &&bound_) const {
+      size_t offset = 0;
+      std::array<size_t, max_dims> indices;
+      std::array<size_t, max_dims> steps;
+      std::array<double, max_dims> weights;
+      std::array<double, max_dims> widths;
+      for (size_t idim = 0; idim < ndims(); ++idim) {
+        double coord = m_dimension_grid->wrap(idim, coords[idim]);
+        if (!bound_(idim, coord)) return false;
+        size_t index = locate(idim, coord, weights[idim]);
+        offset += index * m_strides[idim];
+        steps[idim] = step(idim, index);
+        if constexpr (_method != LINEAR) {
+          indices[idim] = index;
+          widths[idim] = m_dimension_grid->cell_width(idim, index);
+        }
+      }
+      value = evaluate(offset, indices, steps, weights, widths);
+      return true;
+    }
+
+    /**
+     * Batched interpolation, bound_(idim, ipoint, coord) managing the out of bound coordinates. Rejected points are
+     * given rejected_value<T>().
+     *
+     * No allocation is done per point. For multilinear interpolation of double, points are processed by chunks: cells
+     * are located point by point, then the corners are combined by the vectorized multilinear_batch kernel. Its steps
+     * being the same for every point, the few points in the wrap cell of a PERIODIC dimension (see
+     * DimensionGrid::cell_index) are evaluated afterward by evaluate_point.
+     */
+    template<class Bound>
+    void evaluate_batch(const std::vector<const double *> &coords, size_t n_points, T *values, Bound &&bound_) const {
+      if constexpr (std::is_same_v<T, double> && _method == LINEAR) {
+        constexpr size_t chunk_size = 64;
+        const size_t stride = m_polar_table->stride();
+        const auto &dimension_grid = *m_dimension_grid;
+
+        std::array<size_t, max_dims> steps;
+        std::array<std::array<double, chunk_size>, max_dims> weights;
+        std::array<const double *, max_dims> weights_ptr;
+        for (size_t idim = 0; idim < ndims(); ++idim) {
+          steps[idim] = m_steps[idim] * stride;
+          weights_ptr[idim] = weights[idim].data();
+        }
+        std::array<size_t, chunk_size> offsets;
+        // Points whose value is replaced after the kernel: rejected, or in a wrap cell
+        enum : uint8_t { KERNEL, REJECTED_POINT, WRAP_CELL };
+        std::array<uint8_t, chunk_size> deferred;
+        std::array<double, max_dims> point;
+
+        for (size_t start = 0; start < n_points; start += chunk_size) {
+          size_t n = std::min(chunk_size, n_points - start);
+          bool any_deferred = false;
+          for (size_t ipoint = 0; ipoint < n; ++ipoint) {
+            size_t offset = 0;
+            deferred[ipoint] = KERNEL;
+            for (size_t idim = 0; idim < ndims(); ++idim) {
+              double coord = dimension_grid.wrap(idim, coords[idim][start + ipoint]);
+              if (!bound_(idim, start + ipoint, coord)) {
+                deferred[ipoint] = REJECTED_POINT;
+                break;
+              }
+              size_t index = locate(idim, coord, weights[idim][ipoint]);
+              if (m_steps[idim] && index + 1 == m_sizes[idim]) {
+                deferred[ipoint] = WRAP_CELL;
+                break;
+              }
+              offset += index * m_strides[idim];
+            }
+            if (deferred[ipoint] != KERNEL) {
+              // Any valid cell is given to the kernel, the value being replaced afterward
+              any_deferred = true;
+              offset = 0;
+              for (size_t jdim = 0; jdim < ndims(); ++jdim) {
+                weights[jdim][ipoint] = 0.;
+              }
+            }
+            offsets[ipoint] = offset * stride;
+          }
+
+          multilinear_batch(m_polar_table->data(), steps.data(), ndims(), n, offsets.data(), weights_ptr.data(),
+                            values + start);
+
+          if (any_deferred) {
+            for (size_t ipoint = 0; ipoint < n; ++ipoint) {
+              if (deferred[ipoint] == REJECTED_POINT) {
+                values[start + ipoint] = rejected_value<T>();
+              } else if (deferred[ipoint] == WRAP_CELL) {
+                for (size_t idim = 0; idim < ndims(); ++idim) {
+                  point[idim] = coords[idim][start + ipoint];
+                }
+                size_t jpoint = start + ipoint;
+                evaluate_point(point.data(), values[jpoint], [&bound_, jpoint](size_t idim, double &coord) {
+                  return bound_(idim, jpoint, coord);
+                });
+              }
+            }
+          }
+        }
+
+      } else {
+        std::array<double, max_dims> point;
+        for (size_t ipoint = 0; ipoint < n_points; ++ipoint) {
+          for (size_t idim = 0; idim < ndims(); ++idim) {
+            point[idim] = coords[idim][ipoint];
+          }
+          bool accepted = evaluate_point(point.data(), values[ipoint], [&bound_, ipoint](size_t idim, double &coord) {
+            return bound_(idim, ipoint, coord);
+          });
+          if (!accepted) values[ipoint] = rejected_value<T>();
+        }
+      }
+    }
+
+    /**
+     * Out of bound management of a coordinate along dimension idim
+     *
+     * With EXTRAPOLATE, the coordinate is kept as is: the first or last cell is used, with a weight out of [0, 1].
+     */
+    inline double bound(size_t idim, double coord, OUT_OF_BOUND_METHOD oob_method) const {
+      return bound_coordinate(coord, m_axes[idim][0], m_dimension_grid->range_max(idim), oob_method, [&]() {
+        return fmt::format("In PolarTable {}, while calling interp, out of bound value found for dimension {}",
+                           m_polar_table->name(), m_dimension_grid->dimension_set()->name(idim));
+      });
+    }
+
+    /**
+     * Non throwing out of bound management of a coordinate along dimension idim, status being updated with the
+     * status of the coordinate. Returns false if the point is rejected.
+     */
+    inline bool query_bound(size_t idim, double &coord, OUT_OF_BOUND_METHOD oob_method, QUERY_STATUS &status) const {
+      QUERY_STATUS coord_status = apply_out_of_bound_method(coord, m_axes[idim][0], m_dimension_grid->range_max(idim),
+                                                            oob_method);
+      status = std::max(status, coord_status);
+      return coord_status != REJECTED;
+    }
+
+    /**
+     * Get the index of the lower bound of the cell containing coord along dimension idim and the normalized position
+     * of coord into that cell. Out of bound coordinates give the first or last cell, with a weight out of [0, 1].
+     */
+    inline size_t locate(size_t idim, double coord, double &weight) const {
+      return m_dimension_grid->locate(idim, coord, weight);
+    }
+
+    /**
+     * Offset between the lower and the upper corners of cell index along dimension idim, that of the wrap cell of a
+     * PERIODIC dimension going back to the first node (see DimensionGrid::upper_index)
+     */
+    inline size_t step(size_t idim, size_t index) const {
+      if (index + 1 < m_sizes[idim]) return m_steps[idim];
+      // Unsigned wrap around, the offset of the upper corner being lower than that of the lower corner
+      return (m_dimension_grid->upper_index(idim, index) - index) * m_strides[idim];
+    }
+
+    /**
+     * Combination of the 2^ndims corners of the cell starting at offset into values, steps being the offsets between
+     * the lower and the upper corners along each dimension. indices (the lower node of the cell along each dimension)
+     * and widths (the widths of the cell) are for cubic methods only.
+     */
+    inline T evaluate(size_t offset,
+                      const std::array<size_t, max_dims> &indices,
+                      const std::array<size_t, max_dims> &steps,
+                      const std::array<double, max_dims> &weights,
+                      const std::array<double, max_dims> &widths) const {
+      std::array<size_t, max_corners> offsets;
+      corner_offsets(offset, steps.data(), ndims(), offsets.data());
+
+      if constexpr (_method == LINEAR) {
+        return multilinear<T, max_corners>(m_polar_table->data(), m_polar_table->stride(), offsets.data(),
+                                           weights.data(), ndims());
+      } else {
+        std::array<double, (1 << (2 * max_spline_dims))> corners;
+        std::array<double, (1 << (2 * max_spline_dims - 1))> work;
+        hermite_corners(indices, offsets.data(), corners.data());
+        return hermite<max_spline_dims>(corners.data(), weights.data(), widths.data(), ndims(), work.data());
+      }
+    }
+
+    /**
+     * Hermite coefficients of the 2^ndims corners of the cell whose lower nodes are indices, the corners being at
+     * offsets (see hermite_reduce for the layout of corners)
+     *
+     * Coefficient S of a corner is its value for S = 0 and its slope along idim for S = {idim}. Mixed derivatives are
+     * centered differences of the slope along the lowest dimension of S, across the neighbours of the corner along
+     * the other dimensions of S (see DimensionGrid::neighbours).
+     */
+    inline void hermite_corners(const std::array<size_t, max_dims> &indices,
+                                const size_t *offsets,
+                                double *corners) const {
+      const size_t ndims_ = ndims();
+      const size_t n_subsets = (size_t) 1 << ndims_;
+      const double *values = m_polar_table->data();
+      const size_t stride = m_polar_table->stride();
+
+      for (size_t icorner = 0; icorner < n_subsets; ++icorner) {
+        // Offsets from the corner to its neighbours along each dimension (unsigned wrap around for the previous one)
+        // and inverse of their distance
+        std::array<size_t, max_spline_dims> previous;
+        std::array<size_t, max_spline_dims> next;
+        std::array<double, max_spline_dims> inverse_distances;
+        for (size_t idim = 0; idim < ndims_; ++idim) {
+          size_t index = (icorner >> idim) & 1 ? m_dimension_grid->upper_index(idim, indices[idim]) : indices[idim];
+          size_t previous_index, next_index;
+          double distance = m_dimension_grid->neighbours(idim, index, previous_index, next_index);
+          previous[idim] = (previous_index - index) * m_strides[idim];
+          next[idim] = (next_index - index) * m_strides[idim];
+          inverse_distances[idim] = distance > 0. ? 1. / distance : 0.;
+        }
+
+        const size_t node = offsets[icorner];
+        const double *slopes = m_slopes.data() + node * ndims_;
+        double *corner = corners + icorner * n_subsets;
+        corner[0] = values[node * stride];
+        for (size_t subset = 1; subset < n_subsets; ++subset) {
+          size_t idim = std::countr_zero(subset);
+          size_t others = subset & (subset - 1);
+          if (others == 0) {
+            corner[subset] = slopes[idim];
+            continue;
+          }
+
+          double scale = 1.;
+          for (size_t bits = others; bits; bits &= bits - 1) {
+            scale *= inverse_distances[std::countr_zero(bits)];
+          }
+          double sum = 0.;
+          if (scale != 0.) {
+            // Bit jdim of choice tells the next neighbour along jdim, the previous one giving a negative sign
+            for (size_t choice = others;; choice = (choice - 1) & others) {
+              size_t neighbour = node;
+              double sign = 1.;
+              for (size_t bits = others; bits; bits &= bits - 1) {
+                size_t jdim = std::countr_zero(bits);
+                if ((choice >> jdim) & 1) {
+                  neighbour += next[jdim];
+                } else {
+                  neighbour += previous[jdim];
+                  sign = -sign;
+                }
+              }
+              sum += sign * m_slopes[neighbour * ndims_ + idim];
+              if (choice == 0) break;
+            }
+          }
+          corner[subset] = sum * scale;
+        }
+      }
+    }
+
+   private:
+    const PolarTable<T> *m_polar_table;
+    std::shared_ptr<DimensionGrid> m_dimension_grid;
+
+    size_t m_ndims = _dim;
+    std::array<const double *, max_dims> m_axes;
+    std::array<size_t, max_dims> m_sizes;
+    std::array<size_t, max_dims> m_strides;
+    std::array<size_t, max_dims> m_steps;
+
+    // Slopes of cubic methods, ndims per node (see hermite_slopes)
+    std::vector<double> m_slopes;
+  };
+
+}  // poem
+
+#endif //POEM_INTERPOLATOR_H
@@ -0,0 +1,196 @@
+#include "MemoryManager.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "DimensionGrid.h"
+#include "PolarNode.h"
+#include "PolarTable.h"
+
+namespace poem {
+
+  MemoryManager &MemoryManager::instance() {
+    static MemoryManager manager;
+    return manager;
+  }
+
+  void MemoryManager::set_budget(size_t budget) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_budget = budget;
+    }
+    enforce();
+  }
+
+  size_t MemoryManager::budget() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_budget;
+  }
+
+  void MemoryManager::track(const std::shared_ptr<PolarNode> &polar_node, const std::string &filename) {
+    std::vector<std::shared_ptr<PolarTableBase>> polar_tables;
+    polar_node->polar_tables(polar_tables);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Forgets the tables released since the last call
+    std::erase_if(m_entries, [](const auto &pair) { return pair.second.polar_table.expired(); });
+    for (const auto &polar_table: polar_tables) {
+      auto &entry = m_entries[polar_table.get()];
+      // The address may be the one of an expired table
+      if (entry.polar_table.lock() != polar_table) {
+        entry = Entry{polar_table, filename, polar_table->is_loaded() ? size_t(1) : size_t(0)};
+      }
+    }
+    m_counters[filename];
+    refresh_resident_size(live_tables());
+  }
+
+  std::vector<std::pair<std::shared_ptr<PolarTableBase>, MemoryManager::Entry *>> MemoryManager::live_tables() {
+    std::vector<std::pair<std::shared_ptr<PolarTableBase>, Entry *>> polar_tables;
+    polar_tables.reserve(m_entries.size());
+    for (auto &pair: m_entries) {
+      if (auto polar_table = pair.second.polar_table.lock()) {
+        polar_tables.emplace_back(std::move(polar_table), &pair.second);
+      }
+    }
+    return polar_tables;
+  }
+
+  std::vector<std::pair<std::shared_ptr<PolarTableBase>, const MemoryManager::Entry *>>
+  MemoryManager::live_tables() const {
+    std::vector<std::pair<std::shared_ptr<PolarTableBase>, const Entry *>> polar_tables;
+    polar_tables.reserve(m_entries.size());
+    for (const auto &pair: m_entries) {
+      if (auto polar_table = pair.second.polar_table.lock()) {
+        polar_tables.emplace_back(std::move(polar_table), &pair.second);
+      }
+    }
+    return polar_tables;
+  }
+
+  namespace {
+
+    /**
+     * Resident size of tables, each DimensionGrid being counted once
+     */
+    template<class Tables>
+    size_t tables_resident_size(const Tables &polar_tables) {
+      size_t size = 0;
+      std::unordered_set<const DimensionGrid *> dimension_grids;
+      for (const auto &pair: polar_tables) {
+        const auto &polar_table = pair.first;
+        if (polar_table->is_loaded()) size += polar_table->memsize();
+        auto dimension_grid = polar_table->dimension_grid().get();
+        if (dimension_grids.insert(dimension_grid).second) size += dimension_grid->memsize();
+      }
+      return size;
+    }
+
+  }  // namespace
+
+  size_t MemoryManager::resident_size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return tables_resident_size(live_tables());
+  }
+
+  void MemoryManager::refresh_resident_size(
+      const std::vector<std::pair<std::shared_ptr<PolarTableBase>, Entry *>> &polar_tables) {
+    m_resident_size = 0;
+    std::unordered_set<const DimensionGrid *> dimension_grids;
+    for (const auto &[polar_table, entry]: polar_tables) {
+      entry->resident_size = polar_table->is_loaded() ? polar_table->memsize() : 0;
+      m_resident_size += entry->resident_size;
+      auto dimension_grid = polar_table->dimension_grid().get();
+      if (dimension_grids.insert(dimension_grid).second) m_resident_size += dimension_grid->memsize();
+    }
+  }
+
+  size_t MemoryManager::enforce() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tick.fetch_add(1, std::memory_order_relaxed);
+    refresh_resident_size(live_tables());
+    return evict(nullptr);
+  }
+
+  void MemoryManager::on_load(const PolarTableBase &polar_table) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tick.fetch_add(1, std::memory_order_relaxed);
+
+    auto it = m_entries.find(&polar_table);
+    if (it == m_entries.end()) return;
+
+    auto &entry = it->second;
+    auto &counters = m_counters[entry.filename];
+    counters.n_loads++;
+    if (entry.n_loads++ > 0) counters.n_reloads++;
+
+    // Only the loaded table is measured, the other ones being scanned only when over the budget
+    size_t table_size = polar_table.memsize();
+    m_resident_size = m_resident_size + table_size - std::min(m_resident_size, entry.resident_size);
+    entry.resident_size = table_size;
+    evict(&polar_table);
+  }
+
+  size_t MemoryManager::evict(const PolarTableBase *kept) {
+    if (m_budget == 0 || m_resident_size <= m_budget) return 0;
+
+    // Exact resident size, the running total possibly counting released tables or missing built interpolators
+    std::erase_if(m_entries, [](const auto &pair) { return pair.second.polar_table.expired(); });
+    auto polar_tables = live_tables();
+    refresh_resident_size(polar_tables);
+    size_t &size = m_resident_size;
+    if (size <= m_budget) return 0;
+
+    std::vector<std::pair<uint64_t, size_t>> candidates;
+    for (size_t i = 0; i < polar_tables.size(); ++i) {
+      const auto &polar_table = polar_tables[i].first;
+      if (polar_table.get() == kept || !polar_table->has_jit_loader() || !polar_table->is_loaded()) continue;
+      candidates.emplace_back(polar_table->last_access(), i);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    size_t n_evicted = 0;
+    for (const auto &candidate: candidates) {
+      if (size <= m_budget) break;
+      auto &[polar_table, entry] = polar_tables[candidate.second];
+      // Tables being queried are skipped
+      if (!polar_table->try_evict()) continue;
+      size -= std::min(size, entry->resident_size);
+      entry->resident_size = 0;
+      m_counters[entry->filename].n_evictions++;
+      n_evicted++;
+    }
+    return n_evicted;
+  }
+
+  std::map<std::string, MemoryStatistics> MemoryManager::statistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto polar_tables = live_tables();
+
+    std::map<std::string, MemoryStatistics> statistics;
+    std::unordered_map<std::string, std::vector<std::pair<std::shared_ptr<PolarTableBase>, const Entry *>>> per_file;
+    for (auto &pair: polar_tables) {
+      per_file[pair.second->filename].push_back(pair);
+    }
+    for (const auto &[filename, counters]: m_counters) {
+      auto &statistics_ = statistics[filename];
+      statistics_ = counters;
+      auto it = per_file.find(filename);
+      if (it == per_file.end()) continue;
+      statistics_.n_tables = it->second.size();
+      for (const auto &pair: it->second) {
+        statistics_.n_resident += pair.first->is_loaded();
+      }
+      statistics_.resident_size = tables_resident_size(it->second);
+    }
+    return statistics;
+  }
+
+  void MemoryManager::reset_statistics() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &pair: m_counters) {
+      pair.second = MemoryStatistics();
+    }
+  }
+
+}  // poem
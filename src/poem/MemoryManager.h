@@ -0,0 +1,148 @@
+#ifndef POEM_MEMORYMANAGER_H
+#define POEM_MEMORYMANAGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace poem {
+
+  // Forward declaration
+  class PolarNode;
+
+  struct PolarTableBase;
+
+  /**
+   * Residency statistics of the PolarTables loaded from one file
+   */
+  struct MemoryStatistics {
+    // Tables alive
+    size_t n_tables = 0;
+    // Tables whose values are in memory
+    size_t n_resident = 0;
+    // Bytes held by the resident tables and by their DimensionGrids
+    size_t resident_size = 0;
+    // Fetches of values by a JIT loader, first ones included
+    size_t n_loads = 0;
+    // Fetches of values evicted before
+    size_t n_reloads = 0;
+    size_t n_evictions = 0;
+  };
+
+  /**
+   * Process wide memory budget over the PolarNode trees given by load
+   *
+   * The manager tracks the resident size of every table of the trees (values, built interpolators) and of their
+   * DimensionGrids (sampling and materialized dimension points). When a table loaded on demand (see load with jit)
+   * brings the resident size over the budget, the least recently queried tables having a JIT loader are evicted to the
+   * unloaded state until the budget is met again, to be fetched back from their file at next query.
+   *
+   * The resident size is kept as a running total, updated at each load and each eviction, so that a load under the
+   * budget costs no scan of the tracked tables. It is recomputed from every table only when over the budget, at each
+   * enforcement and at each track: interpolators built and tables unloaded by the user in between are accounted for at
+   * that point.
+   *
+   * Recency is approximate: a table records the manager tick of its last query, the tick advancing at each load and each
+   * enforcement. A table pinned by a running query (see PolarTableBase::pin) is never evicted. Tables without JIT
+   * loader and DimensionGrids are accounted for but never evicted, so that the budget may not be met.
+   *
+   * Tables are tracked by weak reference: a tree is forgotten once released by the user.
+   */
+  class MemoryManager {
+   public:
+    static MemoryManager &instance();
+
+    /**
+     * Sets the budget in bytes, 0 meaning no budget, and enforces it
+     */
+    void set_budget(size_t budget);
+
+    [[nodiscard]] size_t budget() const;
+
+    /**
+     * Tracks every PolarTable of the tree starting at polar_node, statistics being reported under filename
+     */
+    void track(const std::shared_ptr<PolarNode> &polar_node, const std::string &filename);
+
+    /**
+     * Resident size of every tracked tree in bytes
+     */
+    [[nodiscard]] size_t resident_size() const;
+
+    /**
+     * Evicts least recently queried tables until the budget is met. Returns the number of evicted tables.
+     */
+    size_t enforce();
+
+    /**
+     * Residency statistics, per file given to track
+     */
+    [[nodiscard]] std::map<std::string, MemoryStatistics> statistics() const;
+
+    /**
+     * Resets the load, reload and eviction counters
+     */
+    void reset_statistics();
+
+    /**
+     * Current tick, recorded by tables at each query
+     */
+    [[nodiscard]] uint64_t tick() const {
+      return m_tick.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Counts a fetch of the values of polar_table and enforces the budget, polar_table being kept. Called by
+     * PolarTable::jit_load with no lock held.
+     */
+    void on_load(const PolarTableBase &polar_table);
+
+    MemoryManager(const MemoryManager &) = delete;
+
+    MemoryManager &operator=(const MemoryManager &) = delete;
+
+   private:
+    MemoryManager() = default;
+
+    struct Entry {
+      std::weak_ptr<PolarTableBase> polar_table;
+      std::string filename;
+      // Loads of the table seen by the manager, a load after the first one being a reload
+      size_t n_loads = 0;
+      // Resident size of the table accounted for in m_resident_size
+      size_t resident_size = 0;
+    };
+
+    /**
+     * Tables still alive. To be called under m_mutex.
+     */
+    std::vector<std::pair<std::shared_ptr<PolarTableBase>, Entry *>> live_tables();
+
+    std::vector<std::pair<std::shared_ptr<PolarTableBase>, const Entry *>> live_tables() const;
+
+    /**
+     * Recomputes the running resident size from polar_tables, the tables still alive. To be called under m_mutex.
+     */
+    void refresh_resident_size(const std::vector<std::pair<std::shared_ptr<PolarTableBase>, Entry *>> &polar_tables);
+
+    size_t evict(const PolarTableBase *kept);
+
+   private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<const PolarTableBase *, Entry> m_entries;
+    std::unordered_map<std::string, MemoryStatistics> m_counters;
+    size_t m_budget = 0;
+    // Running resident size of the tracked tables and of their DimensionGrids
+    size_t m_resident_size = 0;
+    std::atomic<uint64_t> m_tick = 1;
+
+  };
+
+}  // poem
+
+#endif //POEM_MEMORYMANAGER_H
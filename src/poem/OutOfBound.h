@@ -0,0 +1,200 @@
+#ifndef POEM_OUTOFBOUND_H
+#define POEM_OUTOFBOUND_H
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include "exceptions.h"
+#include "DimensionSet.h"
+
+namespace poem {
+
+  /**
+   * Management of query coordinates out of the range of a Dimension
+   */
+  enum OUT_OF_BOUND_METHOD {
+    /// Error (throws in interp, rejects the point in non throwing queries)
+    ERROR,
+    /// Coordinate is clamped to the range
+    SATURATE,
+    /// Linear extrapolation from the first or last cell (nearest saturates)
+    EXTRAPOLATE
+  };
+
+  inline OUT_OF_BOUND_METHOD string_to_outofbound_method(const std::string &oob_str) {
+    OUT_OF_BOUND_METHOD method;
+    if (oob_str == "error") {
+      method = ERROR;
+    } else if (oob_str == "saturate") {
+      method = SATURATE;
+    } else if (oob_str == "extrapolate") {
+      method = EXTRAPOLATE;
+    } else {
+      LogCriticalError("Unknown out of bound method {}. "
+                       "Available values are error, saturate or extrapolate", oob_str);
+      CRITICAL_ERROR_POEM
+    }
+    return method;
+  }
+
+  inline std::string outofbound_method_to_string(OUT_OF_BOUND_METHOD method) {
+    std::string oob_str;
+    switch (method) {
+      case ERROR:
+        oob_str = "error";
+        break;
+      case SATURATE:
+        oob_str = "saturate";
+        break;
+      case EXTRAPOLATE:
+        oob_str = "extrapolate";
+        break;
+    }
+    return oob_str;
+  }
+
+  /**
+   * Status of a point in a non throwing query, by increasing severity. The status of a point is the most severe status
+   * among its coordinates.
+   */
+  enum QUERY_STATUS {
+    /// Every coordinate is in range
+    IN_RANGE,
+    /// At least one coordinate has been saturated
+    SATURATED,
+    /// At least one coordinate has been extrapolated
+    EXTRAPOLATED,
+    /// At least one coordinate is out of range with ERROR method, or is NaN. No value is computed.
+    REJECTED
+  };
+
+  inline std::string query_status_to_string(QUERY_STATUS status) {
+    std::string status_str;
+    switch (status) {
+      case IN_RANGE:
+        status_str = "in_range";
+        break;
+      case SATURATED:
+        status_str = "saturated";
+        break;
+      case EXTRAPOLATED:
+        status_str = "extrapolated";
+        break;
+      case REJECTED:
+        status_str = "rejected";
+        break;
+    }
+    return status_str;
+  }
+
+  /**
+   * Value given to rejected points: NaN for floating point types, 0 otherwise
+   */
+  template<typename T>
+  constexpr T rejected_value() {
+    if constexpr (std::numeric_limits<T>::has_quiet_NaN) {
+      return std::numeric_limits<T>::quiet_NaN();
+    } else {
+      return T(0);
+    }
+  }
+
+  /**
+   * Applies an out of bound method to coord given the [min, max] range of a Dimension, without throwing
+   */
+  inline QUERY_STATUS apply_out_of_bound_method(double &coord, double min, double max, OUT_OF_BOUND_METHOD method) {
+    if (coord >= min && coord <= max) return IN_RANGE;
+    if (std::isnan(coord)) return REJECTED;
+
+    QUERY_STATUS status;
+    switch (method) {
+      case SATURATE:
+        coord = coord < min ? min : max;
+        status = SATURATED;
+        break;
+      case EXTRAPOLATE:
+        status = EXTRAPOLATED;
+        break;
+      default:
+        status = REJECTED;
+    }
+    return status;
+  }
+
+  /**
+   * Applies an out of bound method to coord given the [min, max] range of a Dimension, in throwing queries
+   *
+   * With ERROR, an out of range coordinate is logged and throws, where() giving the beginning of the message (e.g. "In
+   * Polar MPPP, while calling interp, out of bound value found for dimension STW_dim"), only built then. With
+   * EXTRAPOLATE, coord is kept as is, to be extrapolated from the first or last cell.
+   */
+  template<class Where>
+  inline double bound_coordinate(double coord, double min, double max, OUT_OF_BOUND_METHOD method, Where &&where) {
+    // In range, NaN being left as is
+    if (!(coord < min || coord > max)) return coord;
+
+    switch (method) {
+      case ERROR:
+        LogCriticalError("{}. Min: {}, Max: {}, Value: {}", where(), min, max, coord);
+        LogCriticalError("Following your context, you may consider using SATURATE out of bound method "
+                         "in interpolation");
+        CRITICAL_ERROR_POEM
+      case SATURATE:
+        return coord < min ? min : max;
+      case EXTRAPOLATE:
+        break;
+    }
+    return coord;
+  }
+
+  /**
+   * Out of bound methods to apply per Dimension in non throwing queries (see PolarTable::query)
+   *
+   * Dimensions not given a method explicitly use the default method.
+   */
+  class OutOfBoundPolicy {
+   public:
+    OutOfBoundPolicy(OUT_OF_BOUND_METHOD default_method = ERROR) : m_default_method(default_method) {}
+
+    explicit OutOfBoundPolicy(const std::unordered_map<std::string, OUT_OF_BOUND_METHOD> &methods,
+                              OUT_OF_BOUND_METHOD default_method = ERROR) :
+        m_methods(methods),
+        m_default_method(default_method) {}
+
+    OutOfBoundPolicy &set(const std::string &dimension_name, OUT_OF_BOUND_METHOD method) {
+      m_methods[dimension_name] = method;
+      return *this;
+    }
+
+    [[nodiscard]] OUT_OF_BOUND_METHOD method(const std::string &dimension_name) const {
+      auto it = m_methods.find(dimension_name);
+      return it == m_methods.end() ? m_default_method : it->second;
+    }
+
+    /**
+     * Get the methods in the order of dimension_set into methods, which must hold dimension_set.size() values
+     *
+     * Dimension names of the policy that are not in dimension_set are an error.
+     */
+    void methods(const DimensionSet &dimension_set, OUT_OF_BOUND_METHOD *methods) const {
+      for (const auto &pair: m_methods) {
+        if (!dimension_set.contains(pair.first)) {
+          LogCriticalError("Out of bound policy given for unknown dimension {}", pair.first);
+          CRITICAL_ERROR_POEM
+        }
+      }
+      for (size_t idim = 0; idim < dimension_set.size(); ++idim) {
+        methods[idim] = method(dimension_set.name(idim));
+      }
+    }
+
+   private:
+    std::unordered_map<std::string, OUT_OF_BOUND_METHOD> m_methods;
+    OUT_OF_BOUND_METHOD m_default_method;
+  };
+
+}  // poem
+
+#endif //POEM_OUTOFBOUND_H
@@ -2,12 +2,113 @@
 // Created by frongere on 21/01/25.
 //
 
+#include <cmath>
+#include <limits>
+
 #include "PolarTable.h"
 #include "Polar.h"
 #include "DimensionGrid.h"
+#include "parallel.h"
 
 namespace poem {
 
+  namespace {
+
+    const std::vector<std::string> vmg_envelope_names = {"UPWIND_VMG", "UPWIND_TWA", "UPWIND_STW",
+                                                         "DOWNWIND_VMG", "DOWNWIND_TWA", "DOWNWIND_STW"};
+
+    /**
+     * STW along one TWA line of the Polar, strided view into the STW and SOLVER_STATUS tables
+     */
+    struct TWALine {
+      const double *TWA;
+      size_t n;
+      const double *STW;
+      size_t STW_stride;
+      // nullptr without SOLVER_STATUS
+      const int *solver_status;
+      size_t solver_status_stride;
+
+      bool is_valid(size_t i) const {
+        return (!solver_status || solver_status[i * solver_status_stride] == 0) && std::isfinite(STW[i * STW_stride]);
+      }
+
+      /**
+       * VMG times sign at node i
+       */
+      double node_VMG(size_t i, double sign, double &TWA_, double &STW_) const {
+        TWA_ = TWA[i];
+        STW_ = STW[i * STW_stride];
+        return sign * STW_ * std::cos(TWA_ * M_PI / 180.);
+      }
+
+      /**
+       * VMG times sign at the normalized position weight of cell [i, i+1], the STW being interpolated
+       */
+      double cell_VMG(size_t i, double weight, double sign, double &TWA_, double &STW_) const {
+        TWA_ = TWA[i] + weight * (TWA[i + 1] - TWA[i]);
+        STW_ = STW[i * STW_stride] + weight * (STW[(i + 1) * STW_stride] - STW[i * STW_stride]);
+        return sign * STW_ * std::cos(TWA_ * M_PI / 180.);
+      }
+
+      /**
+       * Best VMG times sign, with its TWA and STW. Returns false if no node is valid.
+       */
+      bool optimum(double sign, double &VMG_, double &TWA_, double &STW_) const {
+        // Best node
+        size_t best = n;
+        VMG_ = -std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < n; ++i) {
+          if (!is_valid(i)) continue;
+          double TWA__, STW__;
+          double VMG__ = node_VMG(i, sign, TWA__, STW__);
+          if (VMG__ > VMG_) {
+            best = i;
+            VMG_ = VMG__;
+            TWA_ = TWA__;
+            STW_ = STW__;
+          }
+        }
+        if (best == n) return false;
+
+        // Refinement by golden section search into the valid adjacent cells
+        constexpr double inv_phi = 0.6180339887498949;
+        constexpr size_t n_iterations = 60;
+        for (size_t i = best > 0 ? best - 1 : 0; i <= best && i + 1 < n; ++i) {
+          if (!is_valid(i) || !is_valid(i + 1)) continue;
+          double a = 0., b = 1.;
+          double c = b - inv_phi * (b - a), d = a + inv_phi * (b - a);
+          double TWA_c, STW_c, TWA_d, STW_d;
+          double fc = cell_VMG(i, c, sign, TWA_c, STW_c), fd = cell_VMG(i, d, sign, TWA_d, STW_d);
+          for (size_t iteration = 0; iteration < n_iterations; ++iteration) {
+            if (fc > fd) {
+              b = d;
+              d = c;
+              fd = fc;
+              c = b - inv_phi * (b - a);
+              fc = cell_VMG(i, c, sign, TWA_c, STW_c);
+            } else {
+              a = c;
+              c = d;
+              fc = fd;
+              d = a + inv_phi * (b - a);
+              fd = cell_VMG(i, d, sign, TWA_d, STW_d);
+            }
+          }
+          double TWA__, STW__;
+          double VMG__ = cell_VMG(i, 0.5 * (a + b), sign, TWA__, STW__);
+          if (VMG__ > VMG_) {
+            VMG_ = VMG__;
+            TWA_ = TWA__;
+            STW_ = STW__;
+          }
+        }
+        return true;
+      }
+    };
+
+  }  // namespace
+
   Polar::Polar(const std::string &name, POLAR_MODE mode, std::shared_ptr<DimensionGrid> dimension_grid) :
       PolarNode(name, polar_mode_to_string(mode) + " polar"),
       m_mode(mode),
@@ -81,6 +182,181 @@ namespace poem {
     return new_polar;
   }
 
+  void Polar::pack() {
+    std::vector<std::shared_ptr<PolarTable<double>>> polar_tables;
+    for (const auto &polar_table: children<PolarTableBase>()) {
+      if (polar_table->type() == POEM_DOUBLE && polar_table->dimension_grid() == m_dimension_grid) {
+        polar_tables.push_back(polar_table->as_polar_table_double());
+      }
+    }
+    if (polar_tables.empty()) return;
+
+    // One record of n_tables values per grid node
+    size_t n_tables = polar_tables.size();
+    size_t size = m_dimension_grid->size();
+    auto storage = std::make_shared<std::vector<double>>(size * n_tables);
+    for (size_t column = 0; column < n_tables; ++column) {
+      auto values = polar_tables[column]->view();
+      for (size_t idx = 0; idx < size; ++idx) {
+        (*storage)[idx * n_tables + column] = values[idx];
+      }
+    }
+
+    for (size_t column = 0; column < n_tables; ++column) {
+      polar_tables[column]->pack(storage, column, n_tables);
+    }
+  }
+
+  void Polar::unpack() {
+    for (const auto &polar_table: children<PolarTableBase>()) {
+      if (polar_table->type() == POEM_DOUBLE) {
+        polar_table->as_polar_table_double()->unpack();
+      }
+    }
+  }
+
+  bool Polar::is_packed() const {
+    for (const auto &polar_table: children<PolarTableBase>()) {
+      if (polar_table->type() == POEM_DOUBLE && polar_table->as_polar_table_double()->is_packed()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  PolarQuery Polar::query(const std::vector<std::string> &polar_table_names) const {
+    return {*this, polar_table_names};
+  }
+
+  PolarCurve Polar::curve(const std::vector<std::string> &polar_table_names,
+                          const std::string &free_dimension_name) const {
+    return {*this, polar_table_names, free_dimension_name};
+  }
+
+  std::vector<double> Polar::interp(const DimensionPoint &dimension_point,
+                                    const std::vector<std::string> &polar_table_names,
+                                    OUT_OF_BOUND_METHOD oob_method) const {
+    return query(polar_table_names).interp(dimension_point, oob_method);
+  }
+
+  void Polar::interp_batch(const std::vector<const double *> &coords,
+                           size_t n_points,
+                           const std::vector<std::string> &polar_table_names,
+                           const std::vector<double *> &results,
+                           OUT_OF_BOUND_METHOD oob_method) const {
+    query(polar_table_names).interp_batch(coords, n_points, results, oob_method);
+  }
+
+  void Polar::update_vmg_envelope(size_t n_threads) {
+    if (is_vmg_envelope_up_to_date()) return;
+
+    if (!contains_polar_table("STW") || polar_table("STW")->type() != POEM_DOUBLE) {
+      LogCriticalError("In Polar {}, a PolarTable STW of type double is required to build the VMG envelope", m_name);
+      CRITICAL_ERROR_POEM
+    }
+    const auto &dimension_set = *m_dimension_grid->dimension_set();
+    if (!dimension_set.contains("TWA_dim")) {
+      LogCriticalError("In Polar {}, Dimension TWA_dim is required to build the VMG envelope", m_name);
+      CRITICAL_ERROR_POEM
+    }
+    const std::string TWA_unit = dimension_set.dimension("TWA_dim")->unit();
+    if (TWA_unit != "deg") {
+      LogCriticalError("In Polar {}, Dimension TWA_dim must be in deg to build the VMG envelope (found {})",
+                       m_name, TWA_unit);
+      CRITICAL_ERROR_POEM
+    }
+    auto STW = polar_table("STW")->as_polar_table_double();
+    std::shared_ptr<PolarTable<int>> solver_status;
+    if (contains_polar_table("SOLVER_STATUS")) {
+      solver_status = polar_table("SOLVER_STATUS")->as_polar_table_int();
+    }
+
+    std::vector<std::shared_ptr<PolarTable<double>>> envelope;
+    for (const auto &name: vmg_envelope_names) {
+      if (!contains_polar_table(name)) {
+        std::string unit = name.ends_with("TWA") ? TWA_unit : STW->unit();
+        envelope.push_back(create_polar_table<double>(name, unit, "Optimal VMG envelope", POEM_DOUBLE));
+      } else {
+        auto polar_table_ = polar_table(name);
+        if (polar_table_->type() != POEM_DOUBLE || polar_table_->dimension_grid() != m_dimension_grid) {
+          LogCriticalError("In Polar {}, PolarTable {} exists and cannot hold the VMG envelope", m_name, name);
+          CRITICAL_ERROR_POEM
+        }
+        envelope.push_back(polar_table_->as_polar_table_double());
+      }
+    }
+
+    // Row major layout: node (outer, i, inner) along TWA_dim is at (outer * n + i) * inner_size + inner
+    const size_t iTWA = dimension_set.index("TWA_dim");
+    const auto &TWA_values = m_dimension_grid->values(iTWA);
+    const size_t n_TWA = TWA_values.size();
+    size_t inner_size = 1;
+    for (size_t idim = iTWA + 1; idim < dimension_set.size(); ++idim) {
+      inner_size *= m_dimension_grid->values(idim).size();
+    }
+    const size_t n_nodes = m_dimension_grid->size() / n_TWA;
+
+    // Tables are written by index from the threads, their storage being got once before
+    std::vector<double *> envelope_data;
+    for (const auto &polar_table_: envelope) {
+      envelope_data.push_back(polar_table_->values().data());
+    }
+
+    std::vector<std::shared_ptr<PolarTableBase>> sources{STW};
+    if (solver_status) sources.push_back(solver_status);
+    ReadGuard guard(sources);
+    parallel_for(n_nodes, [&](size_t inode) {
+      size_t outer = inode / inner_size;
+      size_t inner = inode % inner_size;
+      size_t offset = outer * n_TWA * inner_size + inner;
+
+      TWALine line{TWA_values.data(), n_TWA,
+                   STW->data() + offset * STW->stride(), inner_size * STW->stride(),
+                   solver_status ? solver_status->data() + offset * solver_status->stride() : nullptr,
+                   solver_status ? inner_size * solver_status->stride() : 0};
+
+      for (size_t iside = 0; iside < 2; ++iside) {
+        double VMG, TWA, STW_;
+        if (!line.optimum(iside == 0 ? 1. : -1., VMG, TWA, STW_)) {
+          VMG = TWA = STW_ = std::numeric_limits<double>::quiet_NaN();
+        }
+        for (size_t i = 0; i < n_TWA; ++i) {
+          size_t idx = offset + i * inner_size;
+          envelope_data[3 * iside][idx] = VMG;
+          envelope_data[3 * iside + 1][idx] = TWA;
+          envelope_data[3 * iside + 2][idx] = STW_;
+        }
+      }
+    }, n_threads);
+
+    m_vmg_envelope_versions.clear();
+    for (const auto &name: {"STW", "SOLVER_STATUS"}) {
+      if (contains_polar_table(name)) {
+        auto polar_table_ = polar_table(name);
+        m_vmg_envelope_versions.emplace_back(polar_table_, polar_table_->version());
+      } else {
+        m_vmg_envelope_versions.emplace_back(std::weak_ptr<PolarTableBase>(), 0);
+      }
+    }
+    for (const auto &polar_table_: envelope) {
+      m_vmg_envelope_versions.emplace_back(polar_table_, polar_table_->version());
+    }
+  }
+
+  bool Polar::is_vmg_envelope_up_to_date() const {
+    if (m_vmg_envelope_versions.empty()) return false;
+
+    std::vector<std::string> names = {"STW", "SOLVER_STATUS"};
+    names.insert(names.end(), vmg_envelope_names.begin(), vmg_envelope_names.end());
+    for (size_t i = 0; i < names.size(); ++i) {
+      auto recorded = m_vmg_envelope_versions[i].first.lock();
+      auto current = contains_polar_table(names[i]) ? polar_table(names[i]) : nullptr;
+      if (current != recorded) return false;
+      if (current && current->version() != m_vmg_envelope_versions[i].second) return false;
+    }
+    return true;
+  }
+
   std::shared_ptr<Polar>
   make_polar(const std::string &name, POLAR_MODE mode, std::shared_ptr<DimensionGrid> dimension_grid) {
     return std::make_shared<Polar>(name, mode, dimension_grid);
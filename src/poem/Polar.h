@@ -7,8 +7,12 @@
 
 #include <string>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "PolarNode.h"
+#include "PolarQuery.h"
+#include "PolarCurve.h"
 #include "enums.h"
 
 namespace poem {
@@ -61,10 +65,87 @@ namespace poem {
 
     std::shared_ptr<Polar> resample(std::shared_ptr<DimensionGrid> new_dimension_grid) const;
 
+    /**
+     * Switches the PolarTable<double> of the Polar to an interleaved storage: the values of every table at a grid node
+     * are stored contiguously into one record, so that a fused query (see query) reads one record per cell corner.
+     *
+     * PolarTable::values() still gives the values of a packed table, at the cost of a materialization. Modifying a
+     * table unpacks it.
+     */
+    void pack() override;
+
+    /**
+     * Gets back to one contiguous data vector per PolarTable
+     */
+    void unpack();
+
+    /**
+     * Tells if some PolarTable of the Polar are packed
+     */
+    bool is_packed() const;
+
+    /**
+     * Build a fused query of the PolarTables polar_table_names, computing the cell location once per point for every
+     * table (see PolarQuery). Better kept and reused for repeated queries.
+     */
+    PolarQuery query(const std::vector<std::string> &polar_table_names) const;
+
+    /**
+     * Build a 1D view of the PolarTables polar_table_names along free_dimension_name, to be bound to an environment
+     * (see PolarCurve)
+     */
+    PolarCurve curve(const std::vector<std::string> &polar_table_names, const std::string &free_dimension_name) const;
+
+    /**
+     * Fused query of the PolarTables polar_table_names at dimension_point
+     *
+     * PolarTable<double> are interpolated, PolarTable<int> are resolved by nearest. Results are given in the order of
+     * polar_table_names.
+     */
+    std::vector<double> interp(const DimensionPoint &dimension_point,
+                               const std::vector<std::string> &polar_table_names,
+                               OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Batched fused query of the PolarTables polar_table_names (see PolarQuery::interp_batch)
+     */
+    void interp_batch(const std::vector<const double *> &coords,
+                      size_t n_points,
+                      const std::vector<std::string> &polar_table_names,
+                      const std::vector<double *> &results,
+                      OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Builds the optimal VMG envelope of the STW PolarTable along TWA_dim, for every node of the other Dimensions
+     *
+     * The upwind envelope maximizes STW * cos(TWA) and the downwind envelope -STW * cos(TWA). TWA_dim must be in deg,
+     * the VMG and STW envelopes taking the unit of the STW PolarTable. The optimum is searched on the TWA nodes then
+     * refined into the adjacent cells along the interpolated STW. Nodes whose SOLVER_STATUS is not 0 are excluded, the
+     * envelope being NaN if no node is valid.
+     *
+     * The envelope is stored into the PolarTables UPWIND_VMG, UPWIND_TWA, UPWIND_STW, DOWNWIND_VMG, DOWNWIND_TWA and
+     * DOWNWIND_STW. As every PolarTable of a Polar share its DimensionGrid, they span TWA_dim too: each value of the
+     * envelope is replicated at every node along TWA_dim, the tables holding size(TWA_dim) times the values of the
+     * envelope itself, in memory as in files. They are written and loaded as any other PolarTable.
+     *
+     * Nothing is done if the envelope is up to date (see is_vmg_envelope_up_to_date). Nodes are processed in parallel
+     * over n_threads threads (0 for one per hardware core).
+     */
+    void update_vmg_envelope(size_t n_threads = 0);
+
+    /**
+     * Tells if the VMG envelope has been built by update_vmg_envelope and neither STW, SOLVER_STATUS nor the envelope
+     * PolarTables have been modified or replaced since. A loaded envelope is never up to date.
+     */
+    bool is_vmg_envelope_up_to_date() const;
+
    private:
     POLAR_MODE m_mode;
     std::shared_ptr<DimensionGrid> m_dimension_grid;
 
+    // Tables read and written by update_vmg_envelope, with their version at the last update (null if absent)
+    std::vector<std::pair<std::weak_ptr<PolarTableBase>, size_t>> m_vmg_envelope_versions;
+
   };
 
   template<typename T>
@@ -0,0 +1,184 @@
+#include "PolarConversion.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "exceptions.h"
+#include "parallel.h"
+#include "Dimension.h"
+#include "DimensionGrid.h"
+#include "PolarTable.h"
+#include "Polar.h"
+
+namespace poem {
+
+  namespace {
+
+    /**
+     * Inversion of the power along one STW line of the power polar, strided views into the tables
+     */
+    struct PowerLine {
+      const double *STW;
+      size_t n;
+      const double *power;
+      size_t power_stride;
+      const double *leeway;
+      size_t leeway_stride;
+      const int *solver_status;
+      size_t solver_status_stride;
+
+      /**
+       * Valid nodes along the line, with non decreasing power (running maximum)
+       */
+      void valid_nodes(std::vector<size_t> &indices, std::vector<double> &powers) const {
+        indices.clear();
+        powers.clear();
+        for (size_t i = 0; i < n; ++i) {
+          double power_ = power[i * power_stride];
+          if (solver_status[i * solver_status_stride] != 0 || !std::isfinite(power_)) continue;
+          indices.push_back(i);
+          powers.push_back(powers.empty() ? power_ : std::max(powers.back(), power_));
+        }
+      }
+
+      /**
+       * STW and LEEWAY at power_, given the valid nodes
+       */
+      VELOCITY_INVERSION_STATUS invert(double power_,
+                                       const std::vector<size_t> &indices,
+                                       const std::vector<double> &powers,
+                                       double &STW_,
+                                       double &leeway_) const {
+        if (indices.empty()) {
+          STW_ = 0.;
+          leeway_ = 0.;
+          return NO_VALID_POINT;
+        }
+        if (power_ < powers.front()) {
+          STW_ = STW[indices.front()];
+          leeway_ = leeway[indices.front() * leeway_stride];
+          return POWER_BELOW_RANGE;
+        }
+        if (power_ > powers.back()) {
+          STW_ = STW[indices.back()];
+          leeway_ = leeway[indices.back() * leeway_stride];
+          return POWER_ABOVE_RANGE;
+        }
+
+        // Bracket [powers[k - 1], powers[k]) containing power_, with a strictly increasing power. On a plateau of the
+        // running maximum, the highest STW is kept.
+        size_t k = std::upper_bound(powers.begin(), powers.end(), power_) - powers.begin();
+        if (k == powers.size()) {
+          STW_ = STW[indices.back()];
+          leeway_ = leeway[indices.back() * leeway_stride];
+          return INVERSION_SUCCESS;
+        }
+        size_t i0 = indices[k - 1];
+        size_t i1 = indices[k];
+        double weight = (power_ - powers[k - 1]) / (powers[k] - powers[k - 1]);
+        STW_ = STW[i0] + weight * (STW[i1] - STW[i0]);
+        double leeway0 = leeway[i0 * leeway_stride];
+        leeway_ = leeway0 + weight * (leeway[i1 * leeway_stride] - leeway0);
+        return INVERSION_SUCCESS;
+      }
+    };
+
+  }  // namespace
+
+  std::shared_ptr<Polar> make_velocity_polar(const Polar &power_polar,
+                                             const std::vector<double> &power_values,
+                                             size_t n_threads) {
+    POLAR_MODE mode;
+    switch (power_polar.mode()) {
+      case MPPP:
+        mode = MVPP;
+        break;
+      case HPPP:
+        mode = HVPP;
+        break;
+      default:
+        LogCriticalError("Velocity polar can only be built from MPPP or HPPP Polar. Polar {} is {}",
+                         power_polar.name(), polar_mode_to_string(power_polar.mode()));
+        CRITICAL_ERROR_POEM
+    }
+
+    for (const auto &name: {"TOTAL_POWER", "LEEWAY", "SOLVER_STATUS"}) {
+      if (!power_polar.contains_polar_table(name)) {
+        LogCriticalError("In Polar {}, PolarTable {} is required to build the velocity polar",
+                         power_polar.name(), name);
+        CRITICAL_ERROR_POEM
+      }
+    }
+    auto total_power = power_polar.polar_table("TOTAL_POWER")->as_polar_table_double();
+    auto leeway = power_polar.polar_table("LEEWAY")->as_polar_table_double();
+    auto solver_status = power_polar.polar_table("SOLVER_STATUS")->as_polar_table_int();
+
+    const auto &dimension_grid = *power_polar.dimension_grid();
+    const auto &dimension_set = *dimension_grid.dimension_set();
+    if (!dimension_set.contains("STW_dim")) {
+      LogCriticalError("In Polar {}, Dimension STW_dim is required to build the velocity polar", power_polar.name());
+      CRITICAL_ERROR_POEM
+    }
+    const size_t iSTW = dimension_set.index("STW_dim");
+
+    // Power_dim takes the place of STW_dim, other Dimensions and their values being kept
+    std::vector<std::shared_ptr<Dimension>> dimensions(dimension_set.begin(), dimension_set.end());
+    dimensions[iSTW] = make_dimension("Power_dim", "kW", "Total Power");
+    auto new_dimension_grid = make_dimension_grid(make_dimension_set(dimensions));
+    for (size_t idim = 0; idim < dimension_set.size(); ++idim) {
+      if (idim == iSTW) {
+        new_dimension_grid->set_values("Power_dim", power_values);
+      } else {
+        new_dimension_grid->set_values(dimension_set.name(idim), dimension_grid.values(idim));
+      }
+    }
+
+    auto velocity_polar = make_polar(polar_mode_to_string(mode), mode, new_dimension_grid);
+    velocity_polar->attributes() = power_polar.attributes();
+    auto STW = velocity_polar->create_polar_table<double>("STW", "kt", "Speed Through Water", POEM_DOUBLE);
+    auto new_leeway = velocity_polar->create_polar_table<double>("LEEWAY", leeway->unit(), leeway->description(),
+                                                                 POEM_DOUBLE);
+    auto new_solver_status = velocity_polar->create_polar_table<int>("SOLVER_STATUS", "-", "Solver Status", POEM_INT);
+
+    // Row major layout: node (outer, i, inner) along STW_dim is at (outer * n + i) * inner_size + inner
+    const auto &STW_values = dimension_grid.values(iSTW);
+    const size_t n_STW = STW_values.size();
+    const size_t n_power = power_values.size();
+    size_t inner_size = 1;
+    for (size_t idim = iSTW + 1; idim < dimension_set.size(); ++idim) {
+      inner_size *= dimension_grid.values(idim).size();
+    }
+    const size_t n_environments = dimension_grid.size() / n_STW;
+
+    // Tables are written by index from the threads, their storage being got once before
+    auto &STW_data = STW->values();
+    auto &leeway_data = new_leeway->values();
+    auto &solver_status_data = new_solver_status->values();
+
+    std::vector<std::shared_ptr<PolarTableBase>> sources{total_power, leeway, solver_status};
+    ReadGuard guard(sources);
+    parallel_for(n_environments, [&](size_t ienvironment) {
+      size_t outer = ienvironment / inner_size;
+      size_t inner = ienvironment % inner_size;
+      size_t offset = outer * n_STW * inner_size + inner;
+
+      PowerLine line{STW_values.data(), n_STW,
+                     total_power->data() + offset * total_power->stride(), inner_size * total_power->stride(),
+                     leeway->data() + offset * leeway->stride(), inner_size * leeway->stride(),
+                     solver_status->data() + offset * solver_status->stride(), inner_size * solver_status->stride()};
+
+      std::vector<size_t> indices;
+      std::vector<double> powers;
+      line.valid_nodes(indices, powers);
+
+      size_t new_offset = outer * n_power * inner_size + inner;
+      for (size_t j = 0; j < n_power; ++j) {
+        size_t idx = new_offset + j * inner_size;
+        solver_status_data[idx] = line.invert(power_values[j], indices, powers, STW_data[idx], leeway_data[idx]);
+      }
+    }, n_threads);
+
+    return velocity_polar;
+  }
+
+}  // poem
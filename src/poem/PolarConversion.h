@@ -0,0 +1,48 @@
+#ifndef POEM_POLARCONVERSION_H
+#define POEM_POLARCONVERSION_H
+
+#include <memory>
+#include <vector>
+
+namespace poem {
+
+  // Forward declaration
+  class Polar;
+
+  /**
+   * SOLVER_STATUS values given by make_velocity_polar
+   *
+   * Every non zero value flags a node whose STW could not be obtained by inversion, as required by V1/R7.
+   */
+  enum VELOCITY_INVERSION_STATUS {
+    /// The power is reached within the STW range of the power polar
+    INVERSION_SUCCESS = 0,
+    /// The power is lower than the power needed at the lowest valid STW (STW saturated to that speed)
+    POWER_BELOW_RANGE = 1,
+    /// The power is higher than the power needed at the highest valid STW (STW saturated to that speed)
+    POWER_ABOVE_RANGE = 2,
+    /// No valid point along STW for this environment (STW and LEEWAY set to 0)
+    NO_VALID_POINT = 3
+  };
+
+  /**
+   * Builds the velocity prediction Polar (MVPP from MPPP, HVPP from HPPP) of a power prediction Polar
+   *
+   * For every environment node (every Dimension but STW_dim), TOTAL_POWER is inverted along STW_dim at each value of
+   * power_values, giving the STW, LEEWAY and SOLVER_STATUS PolarTables of the returned Polar over a Power_dim Dimension
+   * (kW) that takes the place of STW_dim. Other Dimensions are shared with power_polar.
+   *
+   * Along STW, only the points whose SOLVER_STATUS is 0 are used and TOTAL_POWER is made non decreasing (running
+   * maximum) so that the inversion is monotone. The root is bracketed between two consecutive valid STW nodes, then
+   * obtained by linear interpolation, LEEWAY being interpolated with the same weight. Powers out of the bracketing range
+   * are flagged (see VELOCITY_INVERSION_STATUS).
+   *
+   * Environment nodes are processed in parallel over n_threads threads (0 for one per hardware core).
+   */
+  std::shared_ptr<Polar> make_velocity_polar(const Polar &power_polar,
+                                             const std::vector<double> &power_values,
+                                             size_t n_threads = 0);
+
+}  // poem
+
+#endif //POEM_POLARCONVERSION_H
@@ -0,0 +1,180 @@
+#include "PolarCurve.h"
+#include "PolarTable.h"
+#include "Polar.h"
+
+namespace poem {
+
+  PolarCurve::PolarCurve(const Polar &polar,
+                         const std::vector<std::string> &polar_table_names,
+                         const std::string &free_dimension_name) :
+      m_query(polar, polar_table_names),
+      m_polar_name(polar.name()),
+      m_dimension_grid(polar.dimension_grid()),
+      m_free_dimension_name(free_dimension_name),
+      m_is_bound(false) {
+
+    auto dimension_set = m_dimension_grid->dimension_set();
+    if (!dimension_set->contains(free_dimension_name)) {
+      LogCriticalError("In Polar {}, unknown free dimension {} for PolarCurve", m_polar_name, free_dimension_name);
+      CRITICAL_ERROR_POEM
+    }
+    m_free_dimension_index = dimension_set->index(free_dimension_name);
+
+    m_is_nearest.reserve(polar_table_names.size());
+    for (const auto &name: polar_table_names) {
+      m_polar_tables.push_back(polar.polar_table(name));
+      m_is_nearest.push_back(m_polar_tables.back()->type() != POEM_DOUBLE);
+    }
+    m_values.resize(free_dimension_values().size() * size());
+  }
+
+  size_t PolarCurve::size() const {
+    return m_query.size();
+  }
+
+  const std::vector<std::string> &PolarCurve::polar_table_names() const {
+    return m_query.polar_table_names();
+  }
+
+  const std::string &PolarCurve::free_dimension_name() const {
+    return m_free_dimension_name;
+  }
+
+  size_t PolarCurve::free_dimension_index() const {
+    return m_free_dimension_index;
+  }
+
+  const std::vector<double> &PolarCurve::free_dimension_values() const {
+    return m_dimension_grid->values(m_free_dimension_index);
+  }
+
+  void PolarCurve::bind(const double *coords, OUT_OF_BOUND_METHOD oob_method) {
+    const auto &nodes = free_dimension_values();
+    const size_t ndims = m_dimension_grid->ndims();
+
+    // Left unbound if a query throws
+    m_is_bound = false;
+    for (size_t itable = 0; itable < size(); ++itable) {
+      if (!m_is_nearest[itable] && m_polar_tables[itable]->interpolation_method() != LINEAR) {
+        LogCriticalError("In PolarCurve of Polar {}, PolarTable {} with {} interpolation cannot be collapsed along {}, "
+                         "only LINEAR tables can", m_polar_name, m_polar_tables[itable]->name(),
+                         interpolation_method_to_string(m_polar_tables[itable]->interpolation_method()),
+                         m_free_dimension_name);
+        CRITICAL_ERROR_POEM
+      }
+    }
+    std::array<double, POEM_MAX_DIMS> point;
+    std::copy(coords, coords + ndims, point.begin());
+    for (size_t inode = 0; inode < nodes.size(); ++inode) {
+      point[m_free_dimension_index] = nodes[inode];
+      m_query.interp(point.data(), m_values.data() + inode * size(), oob_method);
+    }
+    m_is_bound = true;
+  }
+
+  void PolarCurve::bind(const std::unordered_map<std::string, double> &environment, OUT_OF_BOUND_METHOD oob_method) {
+    auto dimension_set = m_dimension_grid->dimension_set();
+    for (const auto &pair: environment) {
+      if (!dimension_set->contains(pair.first) || pair.first == m_free_dimension_name) {
+        LogCriticalError("In PolarCurve of Polar {}, {} is not an environment dimension", m_polar_name, pair.first);
+        CRITICAL_ERROR_POEM
+      }
+    }
+
+    std::array<double, POEM_MAX_DIMS> coords;
+    for (size_t idim = 0; idim < dimension_set->size(); ++idim) {
+      if (idim == m_free_dimension_index) continue;
+      auto it = environment.find(dimension_set->name(idim));
+      if (it == environment.end()) {
+        LogCriticalError("In PolarCurve of Polar {}, no value given for environment dimension {}",
+                         m_polar_name, dimension_set->name(idim));
+        CRITICAL_ERROR_POEM
+      }
+      coords[idim] = it->second;
+    }
+    // The free dimension is set to any valid value
+    coords[m_free_dimension_index] = free_dimension_values().front();
+    bind(coords.data(), oob_method);
+  }
+
+  bool PolarCurve::is_bound() const {
+    return m_is_bound;
+  }
+
+  void PolarCurve::interp(double coord, double *results, OUT_OF_BOUND_METHOD oob_method) const {
+    check_bound();
+
+    const double *lower, *upper, *nearest;
+    double weight = cell(coord, oob_method, lower, upper, nearest);
+    for (size_t itable = 0; itable < size(); ++itable) {
+      results[itable] = m_is_nearest[itable] ? nearest[itable] :
+                        lower[itable] + weight * (upper[itable] - lower[itable]);
+    }
+  }
+
+  std::vector<double> PolarCurve::interp(double coord, OUT_OF_BOUND_METHOD oob_method) const {
+    std::vector<double> results(size());
+    interp(coord, results.data(), oob_method);
+    return results;
+  }
+
+  void PolarCurve::interp_batch(const double *coords,
+                                size_t n_points,
+                                const std::vector<double *> &results,
+                                OUT_OF_BOUND_METHOD oob_method) const {
+    check_bound();
+
+    if (results.size() != size()) {
+      LogCriticalError("[PolarCurve::interp_batch] In Polar {}, querying {} PolarTable, got {} result arrays",
+                       m_polar_name, size(), results.size());
+      CRITICAL_ERROR_POEM
+    }
+
+    for (size_t ipoint = 0; ipoint < n_points; ++ipoint) {
+      const double *lower, *upper, *nearest;
+      double weight = cell(coords[ipoint], oob_method, lower, upper, nearest);
+      for (size_t itable = 0; itable < size(); ++itable) {
+        results[itable][ipoint] = m_is_nearest[itable] ? nearest[itable] :
+                                  lower[itable] + weight * (upper[itable] - lower[itable]);
+      }
+    }
+  }
+
+  const std::vector<double> &PolarCurve::values() const {
+    return m_values;
+  }
+
+  double PolarCurve::cell(double coord,
+                          OUT_OF_BOUND_METHOD oob_method,
+                          const double *&lower,
+                          const double *&upper,
+                          const double *&nearest) const {
+    const auto &dimension_grid = *m_dimension_grid;
+    coord = bound(dimension_grid.wrap(m_free_dimension_index, coord), oob_method);
+
+    double weight;
+    size_t index = dimension_grid.locate(m_free_dimension_index, coord, weight);
+    lower = m_values.data() + index * size();
+    // The upper node of the wrap cell of a PERIODIC dimension is the first one
+    upper = m_values.data() + dimension_grid.upper_index(m_free_dimension_index, index) * size();
+    nearest = dimension_grid.nearest_in_cell(m_free_dimension_index, index, coord) == index ? lower : upper;
+    return weight;
+  }
+
+  double PolarCurve::bound(double coord, OUT_OF_BOUND_METHOD oob_method) const {
+    // With EXTRAPOLATE, PolarTable<int> are resolved by saturated nearest
+    return bound_coordinate(coord, m_dimension_grid->min(m_free_dimension_index),
+                            m_dimension_grid->range_max(m_free_dimension_index), oob_method, [&]() {
+      return fmt::format("In PolarCurve of Polar {}, while calling interp, out of bound value found for dimension {}",
+                         m_polar_name, m_free_dimension_name);
+    });
+  }
+
+  void PolarCurve::check_bound() const {
+    if (!m_is_bound) {
+      LogCriticalError("PolarCurve of Polar {} queried before being bound to an environment", m_polar_name);
+      CRITICAL_ERROR_POEM
+    }
+  }
+
+}  // poem
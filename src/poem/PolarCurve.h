@@ -0,0 +1,133 @@
+#ifndef POEM_POLARCURVE_H
+#define POEM_POLARCURVE_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PolarQuery.h"
+
+namespace poem {
+
+  // Forward declaration
+  class Polar;
+
+  class DimensionGrid;
+
+  struct PolarTableBase;
+
+  /**
+   * 1D view of several PolarTable of a Polar along one free Dimension, every other Dimension (the environment) being
+   * bound to fixed values
+   *
+   * Binding collapses the requested tables onto the nodes of the free Dimension, with one fused query per node (see
+   * PolarQuery). Later queries along the free Dimension are then 1D interpolations into that small buffer, with the same
+   * results as the full query: multilinear interpolation is linear along each Dimension, so interpolating the collapsed
+   * curve gives the N-D interpolation. PolarTable<int> are resolved by nearest as in PolarQuery.
+   *
+   * This does not hold for the cubic methods, whose values between the nodes of the free Dimension also depend on the
+   * slopes of the table: binding a PolarTable<double> whose interpolation method is not LINEAR is an error.
+   *
+   * Typical use is a speed sweep in power prediction routing: bind (TWS, TWA, WA, Hs) once per weather cell and
+   * heading, then query along STW. Rebinding reuses the buffer.
+   *
+   * The collapsed values are a copy: the curve must be bound again if the values of the tables change.
+   */
+  class PolarCurve {
+   public:
+    PolarCurve(const Polar &polar,
+               const std::vector<std::string> &polar_table_names,
+               const std::string &free_dimension_name);
+
+    /**
+     * Number of PolarTable in the curve
+     */
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] const std::vector<std::string> &polar_table_names() const;
+
+    [[nodiscard]] const std::string &free_dimension_name() const;
+
+    /**
+     * Index of the free Dimension into the DimensionSet of the Polar
+     */
+    [[nodiscard]] size_t free_dimension_index() const;
+
+    /**
+     * Sampling values of the free Dimension, nodes of the curve
+     */
+    [[nodiscard]] const std::vector<double> &free_dimension_values() const;
+
+    /**
+     * Binds the environment to coords, an array of coordinates given in the DimensionSet order, the coordinate of the
+     * free Dimension being ignored
+     */
+    void bind(const double *coords, OUT_OF_BOUND_METHOD oob_method);
+
+    /**
+     * Binds the environment to values given per Dimension name, for every Dimension but the free one
+     */
+    void bind(const std::unordered_map<std::string, double> &environment, OUT_OF_BOUND_METHOD oob_method);
+
+    [[nodiscard]] bool is_bound() const;
+
+    /**
+     * Query at coord along the free Dimension. results must be allocated by the caller with size() values, given in
+     * the order of polar_table_names().
+     */
+    void interp(double coord, double *results, OUT_OF_BOUND_METHOD oob_method) const;
+
+    [[nodiscard]] std::vector<double> interp(double coord, OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Batched query at n_points coordinates along the free Dimension
+     *
+     * results holds one pointer per PolarTable, in the order of polar_table_names(), each pointing to an array of
+     * n_points values allocated by the caller.
+     */
+    void interp_batch(const double *coords,
+                      size_t n_points,
+                      const std::vector<double *> &results,
+                      OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Collapsed values, size() values per node of the free Dimension
+     */
+    [[nodiscard]] const std::vector<double> &values() const;
+
+   private:
+    /**
+     * Collapsed values at the lower and upper nodes of the cell containing coord and at its nearest node. Returns the
+     * normalized position of coord into the cell.
+     */
+    double cell(double coord,
+                OUT_OF_BOUND_METHOD oob_method,
+                const double *&lower,
+                const double *&upper,
+                const double *&nearest) const;
+
+    double bound(double coord, OUT_OF_BOUND_METHOD oob_method) const;
+
+    void check_bound() const;
+
+   private:
+    PolarQuery m_query;
+    std::string m_polar_name;
+    std::shared_ptr<DimensionGrid> m_dimension_grid;
+    std::string m_free_dimension_name;
+    size_t m_free_dimension_index;
+    // Tables of the curve, whose interpolation method is checked at bind
+    std::vector<std::shared_ptr<PolarTableBase>> m_polar_tables;
+    // Tells which tables are resolved by nearest
+    std::vector<bool> m_is_nearest;
+
+    // Node major collapsed values: values of the tables at node i start at i * size()
+    std::vector<double> m_values;
+    bool m_is_bound;
+
+  };
+
+}  // poem
+
+#endif //POEM_POLARCURVE_H
@@ -10,6 +10,7 @@
 #include "PolarSet.h"
 #include "Polar.h"
 #include "PolarTable.h"
+#include "parallel.h"
 
 namespace poem {
 
@@ -115,6 +116,34 @@ namespace poem {
 
   }
 
+  void PolarNode::polar_tables(std::vector<std::shared_ptr<PolarTableBase>> &polar_tables) const {
+
+    if (m_polar_node_type == POLAR_TABLE) {
+      polar_tables.push_back(const_cast<PolarNode *>(this)->as_polar_table());
+    } else {
+      for (const auto &child: children<PolarNode>()) {
+        child->polar_tables(polar_tables);
+      }
+    }
+
+  }
+
+  void PolarNode::prepare(size_t n_threads) const {
+    std::vector<std::shared_ptr<PolarTableBase>> polar_tables_;
+    polar_tables(polar_tables_);
+
+    parallel_for(polar_tables_.size(), [&polar_tables_](size_t i) {
+      polar_tables_[i]->warm_up();
+    }, n_threads);
+  }
+
+  void PolarNode::pack() {
+    if (m_polar_node_type == POLAR_TABLE) return;
+    for (const auto &child: children<PolarNode>()) {
+      child->pack();
+    }
+  }
+
   std::shared_ptr<PolarNode> PolarNode::polar_node_from_path(const fs::path &path) {
 
     fs::path path_ = path;
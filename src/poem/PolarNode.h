@@ -71,6 +71,27 @@ namespace poem {
 
     void polar_tables_paths(std::vector<std::string> &paths) const;
 
+    /**
+     * Appends every PolarTable found in the tree starting at current PolarNode (included)
+     */
+    void polar_tables(std::vector<std::shared_ptr<PolarTableBase>> &polar_tables) const;
+
+    /**
+     * Eagerly builds the interpolators of every PolarTable of the tree starting at current PolarNode
+     *
+     * Tables are processed in parallel. To be called at load time so that the first query does not suffer from a
+     * latency spike. Tables of a JIT tree whose values are not resident are skipped, so as not to fetch them all (see
+     * PolarTable::warm_up).
+     *
+     * @param n_threads number of threads to use. 0 means one thread per hardware core
+     */
+    void prepare(size_t n_threads = 0) const;
+
+    /**
+     * Packs every Polar of the tree starting at current PolarNode (see Polar::pack)
+     */
+    virtual void pack();
+
     std::shared_ptr<PolarNode> polar_node_from_path(const fs::path &path);
 
     bool exists(const fs::path &path);
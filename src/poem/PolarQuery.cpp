@@ -0,0 +1,199 @@
+#include "PolarQuery.h"
+#include "PolarTable.h"
+#include "Polar.h"
+
+namespace poem {
+
+  PolarQuery::PolarQuery(const Polar &polar, const std::vector<std::string> &polar_table_names) :
+      m_polar_name(polar.name()),
+      m_dimension_grid(polar.dimension_grid()),
+      m_polar_table_names(polar_table_names) {
+
+    if (m_dimension_grid->ndims() > POEM_MAX_DIMS) {
+      LogCriticalError("In Polar {}, query not supported for dimensions higher than {} (found {})",
+                       m_polar_name, POEM_MAX_DIMS, m_dimension_grid->ndims());
+      CRITICAL_ERROR_POEM
+    }
+
+    m_polar_tables.reserve(polar_table_names.size());
+    for (const auto &name: polar_table_names) {
+      if (!polar.contains_polar_table(name)) {
+        LogCriticalError("In Polar {}, query of unknown PolarTable {}", m_polar_name, name);
+        CRITICAL_ERROR_POEM
+      }
+      auto polar_table = polar.polar_table(name);
+
+      if (polar_table->dimension_grid() != m_dimension_grid) {
+        LogCriticalError("In Polar {}, PolarTable {} does not share the DimensionGrid of the Polar and cannot be "
+                         "queried with the other tables", m_polar_name, name);
+        CRITICAL_ERROR_POEM
+      }
+
+      if (polar_table->type() != POEM_DOUBLE && polar_table->type() != POEM_INT) {
+        LogCriticalError("Type not supported");
+        CRITICAL_ERROR_POEM
+      }
+
+      m_polar_tables.push_back(polar_table);
+    }
+  }
+
+  size_t PolarQuery::size() const {
+    return m_polar_tables.size();
+  }
+
+  const std::vector<std::string> &PolarQuery::polar_table_names() const {
+    return m_polar_table_names;
+  }
+
+  void PolarQuery::interp(const double *coords, double *results, OUT_OF_BOUND_METHOD oob_method) const {
+    if (m_cache) {
+      check_cache_versions();
+      m_cache->get(*m_dimension_grid, coords, oob_method, results,
+                   [this, oob_method](const double *coords_, double *results_) {
+                     evaluate(coords_, results_, oob_method);
+                   });
+    } else {
+      evaluate(coords, results, oob_method);
+    }
+  }
+
+  void PolarQuery::enable_cache(size_t capacity, const std::unordered_map<std::string, double> &resolutions) {
+    m_cache = std::make_shared<QueryCache>(capacity,
+                                           cache_resolutions(*m_dimension_grid->dimension_set(), resolutions),
+                                           size());
+    m_cache_versions = std::make_shared<CacheVersions>(size());
+    for (size_t itable = 0; itable < size(); ++itable) {
+      m_cache_versions->versions[itable].store(m_polar_tables[itable]->version(), std::memory_order_relaxed);
+    }
+  }
+
+  void PolarQuery::disable_cache() {
+    m_cache.reset();
+    m_cache_versions.reset();
+  }
+
+  std::shared_ptr<QueryCache> PolarQuery::cache() const {
+    return m_cache;
+  }
+
+  void PolarQuery::check_cache_versions() const {
+    auto &versions = m_cache_versions->versions;
+    bool up_to_date = true;
+    for (size_t itable = 0; itable < m_polar_tables.size(); ++itable) {
+      up_to_date &= m_polar_tables[itable]->version() == versions[itable].load(std::memory_order_acquire);
+    }
+    if (up_to_date) return;
+
+    std::lock_guard<std::mutex> lock(m_cache_versions->mutex);
+    // Another query may have cleared the cache while we were waiting for the lock
+    bool cleared = true;
+    for (size_t itable = 0; itable < m_polar_tables.size(); ++itable) {
+      cleared &= m_polar_tables[itable]->version() == versions[itable].load(std::memory_order_relaxed);
+    }
+    if (cleared) return;
+
+    // Cleared before publishing the new versions, so that a query seeing them finds no stale entry
+    m_cache->clear();
+    for (size_t itable = 0; itable < m_polar_tables.size(); ++itable) {
+      versions[itable].store(m_polar_tables[itable]->version(), std::memory_order_release);
+    }
+  }
+
+  void PolarQuery::evaluate(const double *coords, double *results, OUT_OF_BOUND_METHOD oob_method) const {
+    const auto &dimension_grid = *m_dimension_grid;
+    const size_t ndims = dimension_grid.ndims();
+
+    // Cell location, once for every table
+    std::array<double, POEM_MAX_DIMS> weights;
+    std::array<size_t, POEM_MAX_DIMS> steps;
+    size_t offset = 0;
+    size_t nearest_offset = 0;
+    size_t stride = 1;
+    for (int idim = (int) ndims - 1; idim >= 0; --idim) {
+      const auto &values = dimension_grid.values(idim);
+      double coord = bound(idim, dimension_grid.wrap(idim, coords[idim]), oob_method);
+      size_t index = dimension_grid.locate(idim, coord, weights[idim]);
+
+      offset += index * stride;
+      // Unsigned wrap around for the wrap cell of a PERIODIC dimension, whose upper node is the first one
+      steps[idim] = (dimension_grid.upper_index(idim, index) - index) * stride;
+      nearest_offset += dimension_grid.nearest_in_cell(idim, index, coord) * stride;
+      stride *= values.size();
+    }
+
+    std::array<size_t, (1 << POEM_MAX_DIMS)> offsets;
+    corner_offsets(offset, steps.data(), ndims, offsets.data());
+
+    ReadGuard guard(m_polar_tables);
+    // With a packed Polar, the corners of every table are read from the same records
+    for (size_t itable = 0; itable < m_polar_tables.size(); ++itable) {
+      auto polar_table = m_polar_tables[itable].get();
+      if (polar_table->type() == POEM_DOUBLE) {
+        auto polar_table_double = static_cast<const PolarTable<double> *>(polar_table);
+        auto interpolation_method = polar_table_double->interpolation_method();
+        if (interpolation_method != LINEAR) {
+          // Cubic methods read the slopes of the table, not only the corners of the cell
+          results[itable] = polar_table_double->interp_coords(coords, oob_method, interpolation_method);
+          continue;
+        }
+        results[itable] = multilinear<double, (1 << POEM_MAX_DIMS)>(polar_table_double->data(),
+                                                                    polar_table_double->stride(),
+                                                                    offsets.data(), weights.data(), ndims);
+      } else {
+        auto polar_table_int = static_cast<const PolarTable<int> *>(polar_table);
+        results[itable] = polar_table_int->data()[nearest_offset * polar_table_int->stride()];
+      }
+    }
+  }
+
+  std::vector<double> PolarQuery::interp(const DimensionPoint &dimension_point, OUT_OF_BOUND_METHOD oob_method) const {
+    if (dimension_point.dimension_set() != m_dimension_grid->dimension_set()) {
+      LogCriticalError("[PolarQuery::interp] DimensionPoint has not the same DimensionSet as the Polar {}",
+                       m_polar_name);
+      CRITICAL_ERROR_POEM
+    }
+
+    std::vector<double> results(size());
+    interp(&dimension_point[0], results.data(), oob_method);
+    return results;
+  }
+
+  void PolarQuery::interp_batch(const std::vector<const double *> &coords,
+                                size_t n_points,
+                                const std::vector<double *> &results,
+                                OUT_OF_BOUND_METHOD oob_method) const {
+    if (coords.size() != m_dimension_grid->ndims()) {
+      LogCriticalError("[PolarQuery::interp_batch] In Polar {} of dimension {}, got coordinates for {} dimensions",
+                       m_polar_name, m_dimension_grid->ndims(), coords.size());
+      CRITICAL_ERROR_POEM
+    }
+
+    if (results.size() != size()) {
+      LogCriticalError("[PolarQuery::interp_batch] In Polar {}, querying {} PolarTable, got {} result arrays",
+                       m_polar_name, size(), results.size());
+      CRITICAL_ERROR_POEM
+    }
+
+    std::array<double, POEM_MAX_DIMS> point;
+    std::vector<double> point_results(size());
+    for (size_t ipoint = 0; ipoint < n_points; ++ipoint) {
+      for (size_t idim = 0; idim < coords.size(); ++idim) {
+        point[idim] = coords[idim][ipoint];
+      }
+      interp(point.data(), point_results.data(), oob_method);
+      for (size_t itable = 0; itable < point_results.size(); ++itable) {
+        results[itable][ipoint] = point_results[itable];
+      }
+    }
+  }
+
+  double PolarQuery::bound(size_t idim, double coord, OUT_OF_BOUND_METHOD oob_method) const {
+    // With EXTRAPOLATE, PolarTable<int> are resolved by saturated nearest
+    return bound_coordinate(coord, m_dimension_grid->min(idim), m_dimension_grid->range_max(idim), oob_method, [&]() {
+      return fmt::format("In Polar {}, while calling interp, out of bound value found for dimension {}",
+                         m_polar_name, m_dimension_grid->dimension_set()->name(idim));
+    });
+  }
+
+}  // poem
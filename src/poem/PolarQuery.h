@@ -0,0 +1,127 @@
+#ifndef POEM_POLARQUERY_H
+#define POEM_POLARQUERY_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Interpolator.h"
+#include "QueryCache.h"
+
+namespace poem {
+
+  // Forward declaration
+  class Polar;
+
+  class DimensionGrid;
+
+  struct PolarTableBase;
+
+  /**
+   * Fused query of several PolarTable of a Polar
+   *
+   * Every PolarTable of a Polar share the same DimensionGrid. The cell containing the query point and the interpolation
+   * weights are then computed once per point and applied to every PolarTable of the query. PolarTable<double> are
+   * interpolated with their interpolation method, with the same results as PolarTable::interp: LINEAR tables share
+   * the located cell, the other ones being interpolated by their own interpolator. PolarTable<int> are resolved by
+   * nearest.
+   *
+   * Results are given as double, int values being exactly represented.
+   *
+   * The query keeps the PolarTable and the DimensionGrid of the Polar at construction. It must be built again if
+   * PolarTables are added, removed or squeezed.
+   */
+  class PolarQuery {
+   public:
+    PolarQuery(const Polar &polar, const std::vector<std::string> &polar_table_names);
+
+    /**
+     * Number of PolarTable in the query
+     */
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] const std::vector<std::string> &polar_table_names() const;
+
+    /**
+     * Query at coords, an array of coordinates given in the DimensionSet order. results must be allocated by the
+     * caller with size() values, given in the order of polar_table_names().
+     */
+    void interp(const double *coords, double *results, OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Query at dimension_point, results being given in the order of polar_table_names()
+     */
+    [[nodiscard]] std::vector<double> interp(const DimensionPoint &dimension_point,
+                                             OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Batched query on n_points query points given in a structure-of-arrays layout (see PolarTable::interp_batch)
+     *
+     * Points are queried one by one by interp, each of them probing the cache if enabled.
+     *
+     * results holds one pointer per PolarTable, in the order of polar_table_names(), each pointing to an array of
+     * n_points values allocated by the caller.
+     */
+    void interp_batch(const std::vector<const double *> &coords,
+                      size_t n_points,
+                      const std::vector<double *> &results,
+                      OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Puts a memoization cache of capacity entries in front of interp (see QueryCache), query coordinates being
+     * quantized to resolutions given per Dimension name (exact keys for Dimensions not given)
+     *
+     * Results are then computed at the snapped coordinates. The cache is shared by the copies of the query. It is
+     * cleared when the version of one of the PolarTables changed since the entries were computed (see
+     * PolarTableBase::version), versions being compared lock free at each query. Not to be called concurrently with
+     * queries.
+     */
+    void enable_cache(size_t capacity, const std::unordered_map<std::string, double> &resolutions = {});
+
+    void disable_cache();
+
+    /**
+     * The cache in front of interp, for its hit and miss counters. nullptr if not enabled.
+     */
+    [[nodiscard]] std::shared_ptr<QueryCache> cache() const;
+
+   private:
+    /**
+     * Query at coords, without cache
+     */
+    void evaluate(const double *coords, double *results, OUT_OF_BOUND_METHOD oob_method) const;
+
+    double bound(size_t idim, double coord, OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Clears the cache if a PolarTable changed since its entries were computed
+     */
+    void check_cache_versions() const;
+
+   private:
+    /**
+     * Versions of the PolarTables the entries of the cache were computed with, shared with the cache. The mutex is only
+     * taken to clear the cache.
+     */
+    struct CacheVersions {
+      explicit CacheVersions(size_t size) : versions(size) {}
+
+      std::mutex mutex;
+      std::vector<std::atomic<size_t>> versions;
+    };
+
+    std::string m_polar_name;
+    std::shared_ptr<DimensionGrid> m_dimension_grid;
+    std::vector<std::string> m_polar_table_names;
+    std::vector<std::shared_ptr<PolarTableBase>> m_polar_tables;
+    std::shared_ptr<QueryCache> m_cache;
+    std::shared_ptr<CacheVersions> m_cache_versions;
+
+  };
+
+}  // poem
+
+#endif //POEM_POLARQUERY_H
@@ -0,0 +1,278 @@
+#include "PolarSetQuery.h"
+
+#include <cmath>
+#include <limits>
+
+#include "parallel.h"
+#include "PolarTable.h"
+#include "Polar.h"
+#include "PolarSet.h"
+
+namespace poem {
+
+  namespace {
+    // Number of points processed by a thread at once
+    constexpr size_t chunk_size = 256;
+
+    bool is_control_dimension(const std::string &name) {
+      return name == "STW_dim" || name == "Power_dim";
+    }
+  }  // namespace
+
+  PolarSetQuery::PolarSetQuery(PolarSet &polar_set) : m_polar_set_name(polar_set.name()) {
+
+    for (auto mode: {MPPP, HPPP, MVPP, HVPP, VPP}) {
+      if (!polar_set.has_polar(mode)) continue;
+      add_mode(polar_set, mode, control_type(mode) == VELOCITY_CONTROL ? "TOTAL_POWER" : "STW");
+    }
+
+    if (m_modes.empty()) {
+      LogCriticalError("PolarSet {} has no Polar to select a mode from", m_polar_set_name);
+      CRITICAL_ERROR_POEM
+    }
+
+    // Coordinates of the control dimensions are given by the target
+    for (auto &axis_: m_axes) {
+      const auto &name = axis_.dimension_grid->dimension_set()->name(axis_.idim);
+      if (is_control_dimension(name)) {
+        axis_.source = m_environment_dimension_names.size();
+      } else {
+        axis_.source = std::find(m_environment_dimension_names.begin(), m_environment_dimension_names.end(), name) -
+                       m_environment_dimension_names.begin();
+      }
+    }
+
+    for (size_t imode = 0; imode < m_modes.size(); ++imode) {
+      const auto &mode = m_modes[imode];
+      bool at_speed = control_type(mode.mode) != POWER_CONTROL;
+      bool at_power = control_type(mode.mode) != VELOCITY_CONTROL;
+      if (at_speed) m_speed_modes.push_back(imode);
+      if (at_power) m_power_modes.push_back(imode);
+      for (size_t iaxis: mode.axes) {
+        if (at_speed && std::find(m_speed_axes.begin(), m_speed_axes.end(), iaxis) == m_speed_axes.end()) {
+          m_speed_axes.push_back(iaxis);
+        }
+        if (at_power && std::find(m_power_axes.begin(), m_power_axes.end(), iaxis) == m_power_axes.end()) {
+          m_power_axes.push_back(iaxis);
+        }
+      }
+    }
+  }
+
+  const std::vector<std::string> &PolarSetQuery::environment_dimension_names() const {
+    return m_environment_dimension_names;
+  }
+
+  std::vector<POLAR_MODE> PolarSetQuery::speed_modes() const {
+    std::vector<POLAR_MODE> modes;
+    for (size_t imode: m_speed_modes) modes.push_back(m_modes[imode].mode);
+    return modes;
+  }
+
+  std::vector<POLAR_MODE> PolarSetQuery::power_modes() const {
+    std::vector<POLAR_MODE> modes;
+    for (size_t imode: m_power_modes) modes.push_back(m_modes[imode].mode);
+    return modes;
+  }
+
+  void PolarSetQuery::select_at_speed(const std::vector<const double *> &environment,
+                                      const double *STW,
+                                      size_t n_points,
+                                      int *modes,
+                                      double *powers,
+                                      OUT_OF_BOUND_METHOD oob_method,
+                                      size_t n_threads) const {
+    select(m_speed_modes, true, environment, STW, n_points, modes, powers, oob_method, n_threads);
+  }
+
+  void PolarSetQuery::select_at_power(const std::vector<const double *> &environment,
+                                      const double *power,
+                                      size_t n_points,
+                                      int *modes,
+                                      double *STW,
+                                      OUT_OF_BOUND_METHOD oob_method,
+                                      size_t n_threads) const {
+    select(m_power_modes, false, environment, power, n_points, modes, STW, oob_method, n_threads);
+  }
+
+  void PolarSetQuery::add_mode(PolarSet &polar_set, POLAR_MODE mode, const std::string &value_name) {
+    auto polar = polar_set.polar(mode);
+    auto dimension_grid = polar->dimension_grid();
+    if (dimension_grid->ndims() > POEM_MAX_DIMS) {
+      LogCriticalError("In Polar {}, query not supported for dimensions higher than {} (found {})",
+                       polar->name(), POEM_MAX_DIMS, dimension_grid->ndims());
+      CRITICAL_ERROR_POEM
+    }
+
+    for (const auto &name: {value_name, std::string("SOLVER_STATUS")}) {
+      if (!polar->contains_polar_table(name)) {
+        LogCriticalError("In Polar {} of PolarSet {}, PolarTable {} is required to select the optimal mode",
+                         polar->name(), m_polar_set_name, name);
+        CRITICAL_ERROR_POEM
+      }
+      if (polar->polar_table(name)->dimension_grid() != dimension_grid) {
+        LogCriticalError("In Polar {}, PolarTable {} does not share the DimensionGrid of the Polar",
+                         polar->name(), name);
+        CRITICAL_ERROR_POEM
+      }
+    }
+
+    Mode mode_;
+    mode_.mode = mode;
+    mode_.polar_name = polar->name();
+    mode_.dimension_grid = dimension_grid;
+    mode_.values = polar->polar_table(value_name)->as_polar_table_double();
+    mode_.solver_status = polar->polar_table("SOLVER_STATUS")->as_polar_table_int();
+
+    const auto &dimension_set = *dimension_grid->dimension_set();
+    for (size_t idim = 0; idim < dimension_set.size(); ++idim) {
+      const auto &name = dimension_set.name(idim);
+      if (!is_control_dimension(name) &&
+          std::find(m_environment_dimension_names.begin(), m_environment_dimension_names.end(), name) ==
+          m_environment_dimension_names.end()) {
+        m_environment_dimension_names.push_back(name);
+      }
+      mode_.axes.push_back(axis(dimension_grid, idim));
+    }
+
+    m_polar_tables.push_back(mode_.values);
+    m_polar_tables.push_back(mode_.solver_status);
+    m_modes.push_back(std::move(mode_));
+  }
+
+  size_t PolarSetQuery::axis(const std::shared_ptr<DimensionGrid> &dimension_grid, size_t idim) {
+    auto dimension = dimension_grid->dimension_set()->dimension(idim);
+    for (size_t iaxis = 0; iaxis < m_axes.size(); ++iaxis) {
+      const auto &axis_ = m_axes[iaxis];
+      auto other = axis_.dimension_grid->dimension_set()->dimension(axis_.idim);
+      if (other->name() == dimension->name() &&
+          other->periodicity() == dimension->periodicity() &&
+          other->period() == dimension->period() &&
+          axis_.dimension_grid->values(axis_.idim) == dimension_grid->values(idim)) {
+        return iaxis;
+      }
+    }
+    m_axes.push_back({dimension_grid, idim, 0});
+    return m_axes.size() - 1;
+  }
+
+  void PolarSetQuery::select(const std::vector<size_t> &modes_,
+                             bool at_speed,
+                             const std::vector<const double *> &environment,
+                             const double *target,
+                             size_t n_points,
+                             int *modes,
+                             double *values,
+                             OUT_OF_BOUND_METHOD oob_method,
+                             size_t n_threads) const {
+    if (environment.size() != m_environment_dimension_names.size()) {
+      LogCriticalError("In PolarSet {}, mode selection with {} environment dimensions, got coordinates for {}",
+                       m_polar_set_name, m_environment_dimension_names.size(), environment.size());
+      CRITICAL_ERROR_POEM
+    }
+
+    // The located cells and weights only give multilinear interpolation
+    for (size_t imode: modes_) {
+      const auto &mode = m_modes[imode];
+      if (mode.values->interpolation_method() != LINEAR) {
+        LogCriticalError("In Polar {} of PolarSet {}, PolarTable {} with {} interpolation cannot be used to select the "
+                         "optimal mode, only LINEAR tables can", mode.polar_name, m_polar_set_name,
+                         mode.values->name(), interpolation_method_to_string(mode.values->interpolation_method()));
+        CRITICAL_ERROR_POEM
+      }
+    }
+
+    const auto &axes = at_speed ? m_speed_axes : m_power_axes;
+    const size_t target_source = m_environment_dimension_names.size();
+    const size_t n_chunks = (n_points + chunk_size - 1) / chunk_size;
+
+    ReadGuard guard(m_polar_tables);
+    parallel_for(n_chunks, [&](size_t ichunk) {
+      std::vector<AxisLocation> locations(m_axes.size());
+      size_t end = std::min(n_points, (ichunk + 1) * chunk_size);
+      for (size_t ipoint = ichunk * chunk_size; ipoint < end; ++ipoint) {
+
+        // Shared axes are located once for every mode
+        for (size_t iaxis: axes) {
+          const auto &axis_ = m_axes[iaxis];
+          const auto &dimension_grid = *axis_.dimension_grid;
+          double coord = axis_.source == target_source ? target[ipoint] : environment[axis_.source][ipoint];
+          coord = bound(axis_, dimension_grid.wrap(axis_.idim, coord), oob_method);
+          auto &location = locations[iaxis];
+          location.index = dimension_grid.locate(axis_.idim, coord, location.weight);
+        }
+
+        int best_mode = NO_FEASIBLE_MODE;
+        double best_value = std::numeric_limits<double>::quiet_NaN();
+        for (size_t imode: modes_) {
+          const auto &mode = m_modes[imode];
+          double value = evaluate(mode, locations.data());
+          if (std::isnan(value)) continue;
+          if (at_speed && mode.mode == VPP) {
+            // Sailing only, without power if fast enough
+            if (value < target[ipoint]) continue;
+            value = 0.;
+          }
+          if (best_mode == NO_FEASIBLE_MODE || (at_speed ? value < best_value : value > best_value)) {
+            best_mode = mode.mode;
+            best_value = value;
+          }
+        }
+        modes[ipoint] = best_mode;
+        values[ipoint] = best_value;
+      }
+    }, n_threads);
+  }
+
+  double PolarSetQuery::evaluate(const Mode &mode, const AxisLocation *locations) const {
+    const auto &dimension_grid = *mode.dimension_grid;
+    const size_t ndims = dimension_grid.ndims();
+
+    std::array<double, POEM_MAX_DIMS> weights;
+    std::array<size_t, POEM_MAX_DIMS> steps;
+    size_t offset = 0;
+    size_t stride = 1;
+    for (int idim = (int) ndims - 1; idim >= 0; --idim) {
+      const auto &location = locations[mode.axes[idim]];
+      size_t size = dimension_grid.size(idim);
+      weights[idim] = location.weight;
+      // Unsigned wrap around for the wrap cell of a PERIODIC dimension, whose upper node is the first one
+      steps[idim] = (dimension_grid.upper_index(idim, location.index) - location.index) * stride;
+      offset += location.index * stride;
+      stride *= size;
+    }
+
+    std::array<size_t, (1 << POEM_MAX_DIMS)> offsets;
+    corner_offsets(offset, steps.data(), ndims, offsets.data());
+
+    // Infeasible if the solver failed at any corner contributing to the value, the values of failed nodes being
+    // meaningless
+    auto solver_status = mode.solver_status.get();
+    const int *status = solver_status->data();
+    const size_t status_stride = solver_status->stride();
+    const size_t n_corners = (size_t) 1 << ndims;
+    for (size_t icorner = 0; icorner < n_corners; ++icorner) {
+      if (status[offsets[icorner] * status_stride] == 0) continue;
+      // Bit idim of icorner tells the upper node along idim (see corner_offsets)
+      double weight = 1.;
+      for (size_t idim = 0; idim < ndims; ++idim) {
+        weight *= (icorner >> idim) & 1 ? weights[idim] : 1. - weights[idim];
+      }
+      if (weight != 0.) return std::numeric_limits<double>::quiet_NaN();
+    }
+    double value = multilinear<double, (1 << POEM_MAX_DIMS)>(mode.values->data(), mode.values->stride(),
+                                                             offsets.data(), weights.data(), ndims);
+    return std::isfinite(value) ? value : std::numeric_limits<double>::quiet_NaN();
+  }
+
+  double PolarSetQuery::bound(const Axis &axis, double coord, OUT_OF_BOUND_METHOD oob_method) const {
+    const auto &dimension_grid = *axis.dimension_grid;
+    double min = dimension_grid.min(axis.idim);
+    double max = dimension_grid.range_max(axis.idim);
+    return bound_coordinate(coord, min, max, oob_method, [&]() {
+      return fmt::format("In PolarSet {}, while selecting the optimal mode, out of bound value found for dimension {}",
+                         m_polar_set_name, axis.dimension_grid->dimension_set()->name(axis.idim));
+    });
+  }
+
+}  // poem
@@ -0,0 +1,162 @@
+#ifndef POEM_POLARSETQUERY_H
+#define POEM_POLARSETQUERY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "enums.h"
+#include "Interpolator.h"
+
+namespace poem {
+
+  // Forward declaration
+  class PolarSet;
+
+  struct PolarTableBase;
+
+  template<typename T>
+  class PolarTable;
+
+  /**
+   * Mode given by PolarSetQuery when no mode of the PolarSet is feasible at a point
+   */
+  constexpr int NO_FEASIBLE_MODE = -1;
+
+  /**
+   * Batched selection of the optimal operating mode among the Polar of a PolarSet
+   *
+   * At a target STW (select_at_speed), the velocity controlled modes (MPPP, HPPP) are evaluated on TOTAL_POWER and the
+   * mode of least power is selected. VPP is feasible with no power if its STW reaches the target.
+   *
+   * At a power budget (select_at_power), the power controlled modes (MVPP, HVPP) and VPP are evaluated on STW and the
+   * mode of highest STW is selected. Power controlled Polar may be built from MPPP and HPPP with make_velocity_polar.
+   *
+   * A mode is infeasible at a point if its SOLVER_STATUS is not 0 at any node of the cell contributing to the
+   * interpolated value (non null weight) or if its value is not finite. On equal values, the first mode in POLAR_MODE
+   * order is selected.
+   *
+   * Environment dimensions (every Dimension other than STW_dim and Power_dim) are given once for every mode. Dimensions
+   * with the same name, sampling and periodicity in several Polar are located once per point, the cell and the weights
+   * being reused by every mode sharing them. Values are interpolated multilinearly from the located cells: selecting
+   * with a value PolarTable whose interpolation method is not LINEAR is an error.
+   *
+   * The query keeps the PolarTables and DimensionGrids of the Polar at construction. It must be built again if Polar
+   * are added to the PolarSet.
+   */
+  class PolarSetQuery {
+   public:
+    explicit PolarSetQuery(PolarSet &polar_set);
+
+    /**
+     * Names of the environment dimensions, order in which environment coordinates are given
+     */
+    [[nodiscard]] const std::vector<std::string> &environment_dimension_names() const;
+
+    /**
+     * Modes evaluated by select_at_speed, in POLAR_MODE order
+     */
+    [[nodiscard]] std::vector<POLAR_MODE> speed_modes() const;
+
+    /**
+     * Modes evaluated by select_at_power, in POLAR_MODE order
+     */
+    [[nodiscard]] std::vector<POLAR_MODE> power_modes() const;
+
+    /**
+     * Selection of the mode of least power at n_points target STW
+     *
+     * @param environment one array of n_points coordinates per environment dimension, in the order of
+     * environment_dimension_names()
+     * @param STW target STW of each point
+     * @param modes selected mode of each point (a POLAR_MODE or NO_FEASIBLE_MODE), allocated by the caller
+     * @param powers predicted power of the selected mode (NaN if no feasible mode), allocated by the caller
+     * @param n_threads points are processed in parallel by chunks. 0 means one thread per hardware core
+     */
+    void select_at_speed(const std::vector<const double *> &environment,
+                         const double *STW,
+                         size_t n_points,
+                         int *modes,
+                         double *powers,
+                         OUT_OF_BOUND_METHOD oob_method,
+                         size_t n_threads = 1) const;
+
+    /**
+     * Selection of the mode of highest STW at n_points power budgets (see select_at_speed)
+     */
+    void select_at_power(const std::vector<const double *> &environment,
+                         const double *power,
+                         size_t n_points,
+                         int *modes,
+                         double *STW,
+                         OUT_OF_BOUND_METHOD oob_method,
+                         size_t n_threads = 1) const;
+
+   private:
+    /**
+     * A dimension of one or several Polar, located once per point
+     */
+    struct Axis {
+      std::shared_ptr<DimensionGrid> dimension_grid;
+      size_t idim;
+      // Index of the environment dimension giving the coordinate, or n environment dimensions for the target
+      size_t source;
+    };
+
+    struct Mode {
+      POLAR_MODE mode;
+      std::string polar_name;
+      std::shared_ptr<DimensionGrid> dimension_grid;
+      std::shared_ptr<PolarTable<double>> values;
+      std::shared_ptr<PolarTable<int>> solver_status;
+      // Index into m_axes of each dimension of the Polar
+      std::vector<size_t> axes;
+    };
+
+    /**
+     * Location of a coordinate on an Axis
+     */
+    struct AxisLocation {
+      size_t index;
+      double weight;
+    };
+
+    void add_mode(PolarSet &polar_set, POLAR_MODE mode, const std::string &value_name);
+
+    size_t axis(const std::shared_ptr<DimensionGrid> &dimension_grid, size_t idim);
+
+    void select(const std::vector<size_t> &modes_,
+                bool at_speed,
+                const std::vector<const double *> &environment,
+                const double *target,
+                size_t n_points,
+                int *modes,
+                double *values,
+                OUT_OF_BOUND_METHOD oob_method,
+                size_t n_threads) const;
+
+    /**
+     * Value of mode at the located point, NaN if infeasible
+     */
+    double evaluate(const Mode &mode, const AxisLocation *locations) const;
+
+    double bound(const Axis &axis, double coord, OUT_OF_BOUND_METHOD oob_method) const;
+
+   private:
+    std::string m_polar_set_name;
+    std::vector<std::string> m_environment_dimension_names;
+    std::vector<Axis> m_axes;
+    std::vector<Mode> m_modes;
+    // Tables of every mode, pinned during a selection
+    std::vector<std::shared_ptr<PolarTableBase>> m_polar_tables;
+    // Indices into m_modes and axes to locate of select_at_speed and select_at_power
+    std::vector<size_t> m_speed_modes;
+    std::vector<size_t> m_speed_axes;
+    std::vector<size_t> m_power_modes;
+    std::vector<size_t> m_power_axes;
+
+  };
+
+}  // poem
+
+#endif //POEM_POLARSETQUERY_H
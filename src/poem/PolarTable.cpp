@@ -4,90 +4,316 @@
 
 #include "PolarTable.h"
 
-namespace poem {
-
-  template<>
-  double PolarTable<double>::interp(const DimensionPoint &dimension_point, OUT_OF_BOUND_METHOD oob_method) const {
-
-    // FIXME: si on a une table de int, on devrait reagir de maniere diffente et renvoyer un nearest
-    //  remplacer bound_check par un enum ERROR, SATURATE, EXTRAPOLATE
+#include <thread>
 
-//    if (m_type != POEM_DOUBLE) {
-//      return nearest(dimension_point, oob_method);
-//    }
-
-    if (dimension_point.dimension_set() != m_dimension_grid->dimension_set()) {
-      LogCriticalError("[PolarTable::interp] DimensionPoint has not the same DimensionSet as the PolarTable");
-      CRITICAL_ERROR_POEM
-    }
-
-    if (!m_interpolator) {
-      const_cast<PolarTable<double> *>(this)->build_interpolator();
-    }
-
-    // Out of bound management
-    auto dimension_point_ = dimension_point; // TODO: voir si ca copie correctement
-    size_t index = 0;
-    for (auto &coord: dimension_point_) {
-      if (coord < m_dimension_grid->min(index) || coord > m_dimension_grid->max(index)) {
-        switch (oob_method) {
-          case ERROR: {
-            LogCriticalError("In PolarTable {}, while calling interp, out of bound value found for "
-                             "dimension {}. Min: {}, Max: {}, Value: {}",
-                             m_name, m_dimension_grid->dimension_set()->name(index),
-                             m_dimension_grid->min(index), m_dimension_grid->max(index),
-                             coord);
-            LogCriticalError("Following your context, you may consider using SATURATE out of bound method "
-                             "in interpolation");
-            CRITICAL_ERROR_POEM
-          }
-          case SATURATE: {
-            dimension_point_[index] = coord < m_dimension_grid->min(index) ?
-                                      m_dimension_grid->min(index) : m_dimension_grid->max(index);
-          }
-            break;
-          case EXTRAPOLATE: {
-            NIY_POEM
-          }
-        }
-      }
-      index++;
-    }
+#include "MemoryManager.h"
 
+namespace poem {
 
-    // FIXME: ce switch devrait plutot se trouver dans la class Interpolator !
-    double val;
-    switch (dim()) {
+  /**
+   * Calls f with interpolator cast to its actual type given the number of dimensions: compile time number of dimensions
+   * up to 6, runtime number of dimensions above
+   */
+  template<INTERPOLATION_METHOD method, class F>
+  inline void dispatch_interpolator(InterpolatorBase *interpolator, size_t ndims, F &&f) {
+    switch (ndims) {
       case 1:
-        val = static_cast<Interpolator<double, 1> *>(m_interpolator.get())->interp(dimension_point_, false);
+        f(static_cast<Interpolator<double, 1, method> *>(interpolator));
         break;
       case 2:
-        val = static_cast<Interpolator<double, 2> *>(m_interpolator.get())->interp(dimension_point_, false);
+        f(static_cast<Interpolator<double, 2, method> *>(interpolator));
         break;
       case 3:
-        val = static_cast<Interpolator<double, 3> *>(m_interpolator.get())->interp(dimension_point_, false);
+        f(static_cast<Interpolator<double, 3, method> *>(interpolator));
         break;
       case 4:
-        val = static_cast<Interpolator<double, 4> *>(m_interpolator.get())->interp(dimension_point_, false);
+        f(static_cast<Interpolator<double, 4, method> *>(interpolator));
         break;
       case 5:
-        val = static_cast<Interpolator<double, 5> *>(m_interpolator.get())->interp(dimension_point_, false);
+        f(static_cast<Interpolator<double, 5, method> *>(interpolator));
         break;
       case 6:
-        val = static_cast<Interpolator<double, 6> *>(m_interpolator.get())->interp(dimension_point_, false);
+        f(static_cast<Interpolator<double, 6, method> *>(interpolator));
         break;
       default:
-        LogCriticalError("ND interpolation not supported for dimensions higher than 6 (found {})", dim());
-        CRITICAL_ERROR_POEM
+        // Runtime number of dimensions
+        f(static_cast<Interpolator<double, 0, method> *>(interpolator));
+    }
+  }
+
+  /**
+   * Same as above, also dispatching on the interpolation method
+   */
+  template<class F>
+  inline void dispatch_interpolator(InterpolatorBase *interpolator, size_t ndims, INTERPOLATION_METHOD method, F &&f) {
+    switch (method) {
+      case LINEAR:
+        dispatch_interpolator<LINEAR>(interpolator, ndims, f);
+        break;
+      case CUBIC:
+        dispatch_interpolator<CUBIC>(interpolator, ndims, f);
+        break;
+      case PCHIP:
+        dispatch_interpolator<PCHIP>(interpolator, ndims, f);
+        break;
+      case AKIMA:
+        dispatch_interpolator<AKIMA>(interpolator, ndims, f);
+        break;
+    }
+  }
+
+  namespace {
+    // Flag of PolarTableBase::m_pins set while a table is being evicted
+    constexpr size_t evicting = size_t(1) << (8 * sizeof(size_t) - 1);
+  }  // namespace
+
+  void PolarTableBase::pin() const {
+    if (!m_is_tracked) return;
+
+    while (m_pins.fetch_add(1, std::memory_order_acquire) & evicting) {
+      // Waiting for the eviction to complete, values being then fetched back below
+      m_pins.fetch_sub(1, std::memory_order_relaxed);
+      std::this_thread::yield();
+    }
+
+    auto tick = MemoryManager::instance().tick();
+    if (m_last_access.load(std::memory_order_relaxed) != tick) {
+      m_last_access.store(tick, std::memory_order_relaxed);
+    }
+
+    try {
+      jit_load();
+    } catch (...) {
+      unpin();
+      throw;
+    }
+  }
+
+  void PolarTableBase::unpin() const {
+    if (!m_is_tracked) return;
+    m_pins.fetch_sub(1, std::memory_order_release);
+  }
+
+  bool PolarTableBase::try_evict() {
+    if (!has_jit_loader() || !is_loaded()) return false;
+    size_t n_pins = 0;
+    if (!m_pins.compare_exchange_strong(n_pins, evicting, std::memory_order_acquire)) return false;
+    jit_unload();
+    m_pins.fetch_sub(evicting, std::memory_order_release);
+    return true;
+  }
+
+  void PolarTableBase::notify_loaded() const {
+    MemoryManager::instance().on_load(*this);
+  }
+
+  ReadGuard::ReadGuard(const PolarTableBase &polar_table) : m_polar_table(&polar_table) {
+    polar_table.pin();
+  }
+
+  ReadGuard::ReadGuard(const std::vector<std::shared_ptr<PolarTableBase>> &polar_tables) :
+      m_polar_tables(&polar_tables) {
+    try {
+      for (; m_n_pinned < polar_tables.size(); ++m_n_pinned) {
+        polar_tables[m_n_pinned]->pin();
+      }
+    } catch (...) {
+      for (size_t i = 0; i < m_n_pinned; ++i) (*m_polar_tables)[i]->unpin();
+      throw;
+    }
+  }
+
+  ReadGuard::~ReadGuard() {
+    if (m_polar_table) m_polar_table->unpin();
+    if (m_polar_tables) {
+      for (size_t i = 0; i < m_n_pinned; ++i) (*m_polar_tables)[i]->unpin();
+    }
+  }
+
+  template<>
+  double PolarTable<double>::interp(const DimensionPoint &dimension_point,
+                                    OUT_OF_BOUND_METHOD oob_method,
+                                    INTERPOLATION_METHOD interpolation_method) const {
+
+    if (dimension_point.dimension_set() != m_dimension_grid->dimension_set()) {
+      LogCriticalError("[PolarTable::interp] DimensionPoint has not the same DimensionSet as the PolarTable");
+      CRITICAL_ERROR_POEM
+    }
+
+    ReadGuard guard(*this);
+    double val;
+    if (m_cache) {
+      // Building the interpolator first checks the number of dimensions
+      auto interpolator_ = interpolator(interpolation_method);
+      std::array<double, POEM_MAX_DIMS> coords;
+      std::copy(dimension_point.begin(), dimension_point.end(), coords.begin());
+      m_cache->get(*m_dimension_grid, coords.data(), oob_method * N_INTERPOLATION_METHODS + interpolation_method,
+                   &val,
+                   [&](const double *coords_, double *val_) {
+                     dispatch_interpolator(interpolator_, dim(), interpolation_method, [&](auto interpolator) {
+                       *val_ = interpolator->interp(coords_, oob_method);
+                     });
+                   });
+      return val;
     }
 
+    dispatch_interpolator(interpolator(interpolation_method), dim(), interpolation_method, [&](auto interpolator) {
+      val = interpolator->interp(dimension_point, oob_method);
+    });
     return val;
   }
 
+  template<>
+  double PolarTable<double>::interp_coords(const double *coords,
+                                           OUT_OF_BOUND_METHOD oob_method,
+                                           INTERPOLATION_METHOD interpolation_method) const {
+    ReadGuard guard(*this);
+    double val;
+    dispatch_interpolator(interpolator(interpolation_method), dim(), interpolation_method, [&](auto interpolator) {
+      val = interpolator->interp(coords, oob_method);
+    });
+    return val;
+  }
+
+  template<>
+  void PolarTable<double>::interp_batch(const std::vector<const double *> &coords,
+                                        size_t n_points,
+                                        double *values,
+                                        OUT_OF_BOUND_METHOD oob_method,
+                                        INTERPOLATION_METHOD interpolation_method) const {
+
+    if (coords.size() != dim()) {
+      LogCriticalError("[PolarTable::interp_batch] In PolarTable {} of dimension {}, "
+                       "got coordinates for {} dimensions", m_name, dim(), coords.size());
+      CRITICAL_ERROR_POEM
+    }
+
+    if (n_points == 0) return;
+
+    ReadGuard guard(*this);
+    dispatch_interpolator(interpolator(interpolation_method), dim(), interpolation_method, [&](auto interpolator) {
+      interpolator->interp_batch(coords, n_points, values, oob_method);
+    });
+  }
+
+  template<>
+  double PolarTable<double>::interp_with_gradient(const DimensionPoint &dimension_point,
+                                                  double *gradient,
+                                                  OUT_OF_BOUND_METHOD oob_method,
+                                                  INTERPOLATION_METHOD interpolation_method) const {
+
+    if (dimension_point.dimension_set() != m_dimension_grid->dimension_set()) {
+      LogCriticalError("[PolarTable::interp_with_gradient] DimensionPoint has not the same DimensionSet as the "
+                       "PolarTable");
+      CRITICAL_ERROR_POEM
+    }
+
+    ReadGuard guard(*this);
+    // Building the interpolator first checks the number of dimensions
+    auto interpolator_ = interpolator(interpolation_method);
+    std::array<double, POEM_MAX_DIMS> coords;
+    std::copy(dimension_point.begin(), dimension_point.end(), coords.begin());
+
+    double val;
+    dispatch_interpolator(interpolator_, dim(), interpolation_method, [&](auto interpolator) {
+      val = interpolator->interp_with_gradient(coords.data(), gradient, oob_method);
+    });
+    return val;
+  }
+
+  template<>
+  void PolarTable<double>::interp_with_gradient_batch(const std::vector<const double *> &coords,
+                                                      size_t n_points,
+                                                      double *values,
+                                                      const std::vector<double *> &gradients,
+                                                      OUT_OF_BOUND_METHOD oob_method,
+                                                      INTERPOLATION_METHOD interpolation_method) const {
+
+    if (coords.size() != dim() || gradients.size() != dim()) {
+      LogCriticalError("[PolarTable::interp_with_gradient_batch] In PolarTable {} of dimension {}, "
+                       "got coordinates for {} dimensions and gradients for {} dimensions",
+                       m_name, dim(), coords.size(), gradients.size());
+      CRITICAL_ERROR_POEM
+    }
+
+    if (n_points == 0) return;
+
+    ReadGuard guard(*this);
+    dispatch_interpolator(interpolator(interpolation_method), dim(), interpolation_method, [&](auto interpolator) {
+      interpolator->interp_with_gradient_batch(coords, n_points, values, gradients, oob_method);
+    });
+  }
+
+  template<>
+  QUERY_STATUS PolarTable<double>::query(const DimensionPoint &dimension_point,
+                                         const OutOfBoundPolicy &oob_policy,
+                                         double &value) const {
+
+    if (dimension_point.dimension_set() != m_dimension_grid->dimension_set()) {
+      LogCriticalError("[PolarTable::query] DimensionPoint has not the same DimensionSet as the PolarTable");
+      CRITICAL_ERROR_POEM
+    }
+
+    std::array<OUT_OF_BOUND_METHOD, POEM_MAX_DIMS> oob_methods;
+    query_methods(oob_policy, oob_methods.data());
+
+    std::array<double, POEM_MAX_DIMS> coords;
+    std::copy(dimension_point.begin(), dimension_point.end(), coords.begin());
+
+    ReadGuard guard(*this);
+    QUERY_STATUS status;
+    dispatch_interpolator(interpolator(m_interpolation_method), dim(), m_interpolation_method, [&](auto interpolator) {
+      status = interpolator->query(coords.data(), oob_methods.data(), value);
+    });
+    return status;
+  }
+
+  template<>
+  void PolarTable<double>::query_batch(const std::vector<const double *> &coords,
+                                       size_t n_points,
+                                       double *values,
+                                       QUERY_STATUS *statuses,
+                                       const OutOfBoundPolicy &oob_policy) const {
+
+    if (coords.size() != dim()) {
+      LogCriticalError("[PolarTable::query_batch] In PolarTable {} of dimension {}, "
+                       "got coordinates for {} dimensions", m_name, dim(), coords.size());
+      CRITICAL_ERROR_POEM
+    }
+
+    std::array<OUT_OF_BOUND_METHOD, POEM_MAX_DIMS> oob_methods;
+    query_methods(oob_policy, oob_methods.data());
+
+    if (n_points == 0) return;
+
+    ReadGuard guard(*this);
+    dispatch_interpolator(interpolator(m_interpolation_method), dim(), m_interpolation_method, [&](auto interpolator) {
+      interpolator->query_batch(coords, n_points, values, statuses, oob_methods.data());
+    });
+  }
+
+  template<>
+  void PolarTable<double>::warm_up() const {
+    // Fetching the values would defeat JIT loading
+    if (has_jit_loader() && !is_loaded()) return;
+    ReadGuard guard(*this);
+    interpolator(m_interpolation_method);
+  }
+
   template<>
   int PolarTable<int>::interp(const poem::DimensionPoint &dimension_point,
-                              poem::OUT_OF_BOUND_METHOD oob_method) const {
+                              poem::OUT_OF_BOUND_METHOD oob_method,
+                              INTERPOLATION_METHOD interpolation_method) const {
     return nearest(dimension_point, oob_method);
   }
 
+  template<>
+  void PolarTable<int>::interp_batch(const std::vector<const double *> &coords,
+                                     size_t n_points,
+                                     int *values,
+                                     OUT_OF_BOUND_METHOD oob_method,
+                                     INTERPOLATION_METHOD interpolation_method) const {
+    nearest_batch(coords, n_points, values, oob_method);
+  }
+
 }  // poem
@@ -5,11 +5,15 @@
 #ifndef POEM_POLARTABLE_H
 #define POEM_POLARTABLE_H
 
+#include <array>
 #include <string>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <utility>
 
-#include <boost/multi_array.hpp>
-#include <MathUtils/RegularGridInterpolator.h>
-
+#include "Interpolator.h"
+#include "QueryCache.h"
 #include "Dimension.h"
 #include "DimensionPoint.h"
 #include "DimensionGrid.h"
@@ -19,69 +23,6 @@
 
 namespace poem {
 
-  // Forward declaration
-  template<typename T>
-  class PolarTable;
-
-  /**
-   * Non template base class for Interpolator class used by PolarTable
-   */
-  struct InterpolatorBase {
-    virtual ~InterpolatorBase() {}
-
-    virtual void build() = 0;
-  };
-
-  /**
-   * Multidimensional interpolation class
-   * @tparam T the datatype of the interpolation
-   * @tparam _dim the number of dimension of the PolarTable
-   */
-  template<typename T, size_t _dim>
-  class Interpolator : public InterpolatorBase {
-   public:
-    explicit Interpolator(PolarTable<T> *polar_table) : m_polar_table(polar_table) {}
-
-    T interp(const DimensionPoint &dimension_point, bool bound_check) const {
-      std::array<T, _dim> array;
-      size_t idx = 0;
-      for (const auto &coord: dimension_point) {
-        array[idx] = coord;
-        idx++;
-      }
-
-      return m_interpolator->Interp(array, bound_check);
-    }
-
-    void build() override {
-      m_interpolator = std::make_unique<mathutils::RegularGridInterpolator<T, _dim>>();
-      // TODO: Check que m_polar_table est filled
-
-      using NDArray = boost::multi_array<double, _dim>;
-      using IndexArray = boost::array<typename NDArray::index, _dim>;
-      IndexArray shape;
-
-      auto dimension_grid = m_polar_table->dimension_grid();
-      for (size_t idim = 0; idim < dimension_grid->ndims(); ++idim) {
-        auto values = dimension_grid->values(idim);
-        shape[idim] = values.size();
-        m_interpolator->AddCoord(values);
-      }
-
-      NDArray array(shape);
-      std::copy(m_polar_table->values().begin(), m_polar_table->values().end(), array.data());
-      this->m_interpolator->AddVar(array);
-
-    }
-
-   private:
-    PolarTable<T> *m_polar_table;
-    std::unique_ptr<mathutils::RegularGridInterpolator<T, _dim>> m_interpolator;
-  };
-
-  // ===================================================================================================================
-  // ===================================================================================================================
-
   // Forward declaration
   class Polar;
 
@@ -102,8 +43,11 @@ namespace poem {
         Dimensional(unit),
         m_type(type),
         m_dimension_grid(dimension_grid),
-        m_interpolator(nullptr) {
+        m_interpolation_method(LINEAR) {
       m_polar_node_type = POLAR_TABLE;
+      for (auto &interpolator_ptr: m_interpolator_ptrs) {
+        interpolator_ptr.store(nullptr, std::memory_order_relaxed);
+      }
     }
 
     virtual POEM_DATATYPE type() const = 0;
@@ -114,6 +58,87 @@ namespace poem {
 
     virtual bool operator!=(const PolarTableBase &other) const = 0;
 
+    /**
+     * Builds every lazily computed data used for querying the table (interpolator...) so that the first query does
+     * not pay for it. Safe to be called concurrently with queries.
+     */
+    virtual void warm_up() const = 0;
+
+    /**
+     * Interpolation method used by interp, interp_batch, query and query_batch when not given (LINEAR by default)
+     *
+     * Only PolarTable<double> accept methods other than LINEAR, PolarTable<int> being resolved by nearest. PolarQuery
+     * honors it, PolarCurve and PolarSetQuery only accept LINEAR.
+     */
+    INTERPOLATION_METHOD interpolation_method() const {
+      return m_interpolation_method;
+    }
+
+    void set_interpolation_method(INTERPOLATION_METHOD method) {
+      if (method != LINEAR && m_type != POEM_DOUBLE) {
+        LogCriticalError("In PolarTable {}, {} interpolation method is only available for double tables",
+                         m_name, interpolation_method_to_string(method));
+        CRITICAL_ERROR_POEM
+      }
+      m_interpolation_method = method;
+    }
+
+    /**
+     * Resident memory of the table in bytes: the object, its own data vector and its built interpolators
+     */
+    virtual size_t memsize() const = 0;
+
+    /**
+     * Tells if the values of the table can be fetched back by a loader after jit_unload
+     */
+    virtual bool has_jit_loader() const = 0;
+
+    /**
+     * Tells if the values of the table are resident
+     */
+    virtual bool is_loaded() const = 0;
+
+    /**
+     * Fetches the values of the table if not resident. Thread safe.
+     */
+    virtual void jit_load() const = 0;
+
+    /**
+     * Releases the values, the interpolators and the cache of a table with a JIT loader, to be fetched back at next
+     * access. Not to be called concurrently with queries (see try_evict).
+     */
+    virtual void jit_unload() = 0;
+
+    /**
+     * Pins the values of the table for a read: they are fetched if not resident and cannot be evicted until unpin.
+     * Called by every query. Lock free unless the table is being evicted, and a no-op for tables without JIT loader,
+     * always resident and not tracked by the MemoryManager.
+     */
+    void pin() const;
+
+    void unpin() const;
+
+    /**
+     * Releases the values of a table with a JIT loader if it is resident and not pinned. Returns true if released. Safe
+     * to be called concurrently with queries.
+     */
+    bool try_evict();
+
+    /**
+     * MemoryManager tick of the last pin of the table
+     */
+    uint64_t last_access() const {
+      return m_last_access.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Number of modifications of the values or of the DimensionGrid of the table, for objects derived from the table to
+     * know if they are out of date. Lock free.
+     */
+    size_t version() const {
+      return m_version.load(std::memory_order_acquire);
+    }
+
     std::shared_ptr<PolarTable<double>> as_polar_table_double() {
       if (m_type != POEM_DOUBLE) {
         LogCriticalError("PolarTable {} has no type double", m_name);
@@ -133,47 +158,84 @@ namespace poem {
    protected:
     POEM_DATATYPE m_type;
     std::shared_ptr<DimensionGrid> m_dimension_grid;
-    std::unique_ptr<InterpolatorBase> m_interpolator;
+    INTERPOLATION_METHOD m_interpolation_method;
+    // Interpolators, lazily built per interpolation method
+    std::array<std::unique_ptr<InterpolatorBase>, N_INTERPOLATION_METHODS> m_interpolators;
+    // Published interpolators, used for lock free access once built
+    mutable std::array<std::atomic<InterpolatorBase *>, N_INTERPOLATION_METHODS> m_interpolator_ptrs;
+    // Incremented at each modification, see version()
+    std::atomic<size_t> m_version = 0;
+
+    // Set with a JIT loader, pins and access ticks being only maintained for these tables
+    bool m_is_tracked = false;
+    // Number of readers, with the evicting flag set during try_evict
+    mutable std::atomic<size_t> m_pins = 0;
+    mutable std::atomic<uint64_t> m_last_access = 0;
+
+    /**
+     * Tells the MemoryManager that the values have been fetched, to be called with no lock held
+     */
+    void notify_loaded() const;
 
   };
 
-  enum OUT_OF_BOUND_METHOD {
-    ERROR,
-    SATURATE,
-    EXTRAPOLATE
+  /**
+   * Pins PolarTables for the scope of a read (see PolarTableBase::pin)
+   */
+  class ReadGuard {
+   public:
+    explicit ReadGuard(const PolarTableBase &polar_table);
+
+    explicit ReadGuard(const std::vector<std::shared_ptr<PolarTableBase>> &polar_tables);
+
+    ~ReadGuard();
+
+    ReadGuard(const ReadGuard &) = delete;
+
+    ReadGuard &operator=(const ReadGuard &) = delete;
+
+   private:
+    const PolarTableBase *m_polar_table = nullptr;
+    const std::vector<std::shared_ptr<PolarTableBase>> *m_polar_tables = nullptr;
+    size_t m_n_pinned = 0;
+
   };
 
-  inline OUT_OF_BOUND_METHOD string_to_outofbound_method(const std::string &oob_str) {
-    OUT_OF_BOUND_METHOD method;
-    if (oob_str == "error") {
-      method = ERROR;
-    } else if (oob_str == "saturate") {
-      method = SATURATE;
-    } else if (oob_str == "extrapolate") {
-      method = EXTRAPOLATE;
-    } else {
-      LogCriticalError("Unknown out of bound method {}. "
-                       "Available values are error, saturate or extrapolate", oob_str);
-      CRITICAL_ERROR_POEM
+  template<typename T>
+  class PolarTable;
+
+  /**
+   * Read only view of the values of a PolarTable, pinning the table for the lifetime of the view so that its values
+   * cannot be released by jit_unload or evicted by the MemoryManager while read (see PolarTable::view)
+   */
+  template<typename T>
+  class ValuesView {
+   public:
+    explicit ValuesView(const PolarTable<T> &polar_table);
+
+    [[nodiscard]] const T *data() const {
+      return m_data;
     }
-    return method;
-  }
 
-  inline std::string outofbound_method_to_string(OUT_OF_BOUND_METHOD method) {
-    std::string oob_str;
-    switch (method) {
-      case ERROR:
-        oob_str = "error";
-        break;
-      case SATURATE:
-        oob_str = "saturate";
-        break;
-      case EXTRAPOLATE:
-        oob_str = "extrapolate";
-        break;
+    [[nodiscard]] size_t stride() const {
+      return m_stride;
+    }
+
+    [[nodiscard]] size_t size() const {
+      return m_size;
+    }
+
+    const T &operator[](size_t idx) const {
+      return m_data[idx * m_stride];
     }
-    return oob_str;
-  }
+
+   private:
+    ReadGuard m_guard;
+    const T *m_data;
+    size_t m_stride;
+    size_t m_size;
+
+  };
 
   /**
    * A multidimensional numerical table representing a variable
@@ -192,12 +254,14 @@ namespace poem {
      * @param description description of the table
      * @param type datatype of the table
      * @param dimension_grid the grid of the table
+     * @param storage if not null, values the table is bound to without allocating its own (see bind_values)
      */
     PolarTable(const std::string &name,
                const std::string &unit,
                const std::string &description,
                POEM_DATATYPE type,
-               std::shared_ptr<DimensionGrid> dimension_grid);
+               std::shared_ptr<DimensionGrid> dimension_grid,
+               std::shared_ptr<const T> storage = nullptr);
 
     /**
      * Get the type of the table
@@ -260,14 +324,67 @@ namespace poem {
 
     /**
      * Get the whole data vector of the table.
+     *
+     * When the table is packed (see Polar::pack), the values are materialized into a contiguous vector at first call.
+     * Prefer data() and stride() for read access without copy.
+     *
+     * For a table with a JIT loader, the reference is only valid while the table is pinned (see ReadGuard), the values
+     * being released by jit_unload or by the MemoryManager otherwise. Prefer view().
      */
     [[nodiscard]] const std::vector<T> &values() const;
 
     /**
      * Get the whole data vector of the table.
+     *
+     * The data vector being modifiable, the table is unpacked first if packed.
      */
     std::vector<T> &values();
 
+    /**
+     * Pointer to the first value of the table, consecutive values being stride() apart
+     *
+     * As for values(), the pointer of a table with a JIT loader is only valid while the table is pinned.
+     */
+    [[nodiscard]] const T *data() const;
+
+    /**
+     * Read only view of the values, keeping the table pinned for its lifetime. Safe against concurrent jit_unload and
+     * eviction.
+     */
+    [[nodiscard]] ValuesView<T> view() const;
+
+    /**
+     * Distance between two consecutive values from data(). It is 1 unless the table is packed.
+     */
+    [[nodiscard]] size_t stride() const;
+
+    /**
+     * Tells if the values of the table are read from a storage it does not own: interleaved with those of other tables
+     * (see pack) or bound to external values (see bind_values)
+     */
+    [[nodiscard]] bool is_packed() const;
+
+    /**
+     * Binds the table to an interleaved storage where value idx is (*storage)[idx * stride + column]
+     *
+     * Used by Polar::pack. The own data vector of the table is released.
+     */
+    void pack(std::shared_ptr<const std::vector<T>> storage, size_t column, size_t stride);
+
+    /**
+     * Binds the table to size() contiguous values owned by another object, without copy (e.g. the memory mapping of a
+     * snapshot, see load_snapshot). storage keeps its owner alive.
+     *
+     * The table is then read as a packed table with a stride of 1: queries read the values in place, values()
+     * materializes a copy and every modifying method unpacks the table. The own data vector of the table is released.
+     */
+    void bind_values(std::shared_ptr<const T> storage);
+
+    /**
+     * Gets back a contiguous data vector owned by the table if packed. Every modifying method unpacks the table.
+     */
+    void unpack();
+
     /**
      * Set the whole data vector of the table
      * @param new_values vector of values
@@ -344,10 +461,133 @@ namespace poem {
     [[nodiscard]] T nearest(const DimensionPoint &dimension_point, OUT_OF_BOUND_METHOD oob_method) const;
 
     /**
-     * Get the value of the interpolation to dimension_point
+     * Batched nearest lookup on n_points query points given in a structure-of-arrays layout (see interp_batch)
+     *
+     * Lookup is O(1) per dimension on uniform samplings and O(log n) otherwise. No allocation is done per point.
+     */
+    void nearest_batch(const std::vector<const double *> &coords,
+                       size_t n_points,
+                       T *values,
+                       OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Get the value of the interpolation to dimension_point, with the interpolation method of the table
      */
     [[nodiscard]] T interp(const DimensionPoint &dimension_point, OUT_OF_BOUND_METHOD oob_method) const;
 
+    /**
+     * Get the value of the interpolation to dimension_point with a given interpolation method
+     *
+     * Cubic methods compute their slopes at first use (see warm_up), then cache them with the table.
+     */
+    [[nodiscard]] T interp(const DimensionPoint &dimension_point,
+                           OUT_OF_BOUND_METHOD oob_method,
+                           INTERPOLATION_METHOD interpolation_method) const;
+
+    /**
+     * Same as interp at coords, an array of dim() coordinates given in the order of the DimensionSet, bypassing the
+     * cache (see enable_cache). Used by fused queries for non LINEAR tables (see PolarQuery).
+     *
+     * Only available for PolarTable<double>.
+     */
+    [[nodiscard]] T interp_coords(const double *coords,
+                                  OUT_OF_BOUND_METHOD oob_method,
+                                  INTERPOLATION_METHOD interpolation_method) const;
+
+    /**
+     * Batched interpolation on n_points query points given in a structure-of-arrays layout
+     *
+     * coords holds one pointer per Dimension, in the order of the associated DimensionSet, each pointing to a
+     * contiguous array of n_points coordinates. The n_points interpolated values are written into values which must be
+     * allocated by the caller.
+     *
+     * Validation and dispatch on the number of dimensions are done once per batch and no allocation is done per point.
+     * With ERROR out of bound method, an exception is thrown at the first out of bound point.
+     *
+     * For PolarTable<int>, this is nearest_batch.
+     */
+    void interp_batch(const std::vector<const double *> &coords,
+                      size_t n_points,
+                      T *values,
+                      OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Same as interp_batch with a given interpolation method
+     */
+    void interp_batch(const std::vector<const double *> &coords,
+                      size_t n_points,
+                      T *values,
+                      OUT_OF_BOUND_METHOD oob_method,
+                      INTERPOLATION_METHOD interpolation_method) const;
+
+    /**
+     * Get the value of the interpolation to dimension_point, with the interpolation method of the table, together with
+     * its partial derivatives along every Dimension
+     *
+     * gradient must hold dim() values, written in the order of the DimensionSet. They are computed from the same cell
+     * and weights as the value and are analytic derivatives of the interpolant, expressed in units of the table per
+     * unit of the Dimension. They are null along singleton Dimensions and along coordinates saturated by SATURATE.
+     * Along a SYMMETRIC Dimension, the derivative changes sign on the mirrored half period.
+     *
+     * Only available for PolarTable<double>.
+     */
+    T interp_with_gradient(const DimensionPoint &dimension_point,
+                           double *gradient,
+                           OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Same as interp_with_gradient with a given interpolation method
+     */
+    T interp_with_gradient(const DimensionPoint &dimension_point,
+                           double *gradient,
+                           OUT_OF_BOUND_METHOD oob_method,
+                           INTERPOLATION_METHOD interpolation_method) const;
+
+    /**
+     * Batched version of interp_with_gradient on n_points query points given in a structure-of-arrays layout (see
+     * interp_batch)
+     *
+     * gradients holds one pointer per Dimension, each pointing to an array of n_points partial derivatives along that
+     * Dimension. values and gradients are allocated by the caller.
+     */
+    void interp_with_gradient_batch(const std::vector<const double *> &coords,
+                                    size_t n_points,
+                                    T *values,
+                                    const std::vector<double *> &gradients,
+                                    OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Same as interp_with_gradient_batch with a given interpolation method
+     */
+    void interp_with_gradient_batch(const std::vector<const double *> &coords,
+                                    size_t n_points,
+                                    T *values,
+                                    const std::vector<double *> &gradients,
+                                    OUT_OF_BOUND_METHOD oob_method,
+                                    INTERPOLATION_METHOD interpolation_method) const;
+
+    /**
+     * Non throwing query at dimension_point, with one out of bound method per Dimension given by oob_policy
+     *
+     * The value is written into value and the status of the query is returned. Rejected points (out of bound
+     * coordinate with ERROR method, or NaN coordinate) are given NaN (0 for integer tables). Tables that are not
+     * interpolated (PolarTable<int>) use nearest, EXTRAPOLATE being then the same as SATURATE.
+     *
+     * Errors on the inputs themselves (DimensionSet mismatch, unknown dimension in oob_policy) still throw.
+     */
+    QUERY_STATUS query(const DimensionPoint &dimension_point, const OutOfBoundPolicy &oob_policy, T &value) const;
+
+    /**
+     * Batched version of query on n_points query points given in a structure-of-arrays layout (see interp_batch)
+     *
+     * values and statuses must hold n_points elements each and are allocated by the caller.
+     */
+    void query_batch(const std::vector<const double *> &coords,
+                     size_t n_points,
+                     T *values,
+                     QUERY_STATUS *statuses,
+                     const OutOfBoundPolicy &oob_policy) const;
+
     /**
      * Get a slice in the table given values for different dimensions
      *
@@ -377,34 +617,189 @@ namespace poem {
     [[nodiscard]] std::shared_ptr<PolarTable<T>> resample(std::shared_ptr<DimensionGrid> new_dimension_grid,
                                                           OUT_OF_BOUND_METHOD oob_method) const;
 
-    int memsize() const {
-      return sizeof(*this); // pour monitorer la taille de l'objet lors des devs de JIT loader
-    }
+    /**
+     * Resident memory of the table in bytes: the object, its own data vector and its built interpolators (a packed
+     * storage being shared is not counted)
+     */
+    [[nodiscard]] size_t memsize() const override;
+
+    /**
+     * Makes the values of the table fetched on demand: they are released, then filled by loader with size() values at
+     * first access and after each jit_unload (see load with jit)
+     *
+     * The table is detached from its loader once modified, its values being then owned in memory only. Not to be called
+     * while the table is read or pinned (see ReadGuard).
+     */
+    void set_jit_loader(std::function<void(T *)> loader);
+
+    [[nodiscard]] bool has_jit_loader() const override;
+
+    [[nodiscard]] bool is_loaded() const override;
+
+    /**
+     * Fetches the values of the table if not resident. Called by every access to the values. Thread safe.
+     */
+    void jit_load() const override;
+
+    /**
+     * Releases the values, the interpolators and the cache of a table with a JIT loader, to be fetched back at next
+     * access. A table without loader is kept as is. Not to be called concurrently with queries (see try_evict).
+     */
+    void jit_unload() override;
+
+    /**
+     * Builds the interpolator of the interpolation method of the table if not already built. Tables with a JIT loader
+     * whose values are not resident are skipped, their interpolator being built at first query.
+     */
+    void warm_up() const override;
+
+    /**
+     * Puts a memoization cache of capacity entries in front of interp (see QueryCache), query coordinates being
+     * quantized to resolutions given per Dimension name (exact keys for Dimensions not given)
+     *
+     * Values are then interpolated at the snapped coordinates. The cache is cleared when the values of the table change.
+     * Only interp goes through the cache, interp_batch interpolating every point. Only available for
+     * PolarTable<double>. Not to be called concurrently with queries.
+     */
+    void enable_cache(size_t capacity, const std::unordered_map<std::string, double> &resolutions = {});
 
-    void jit_load() {NIY_POEM}
+    void disable_cache();
 
-    void jit_unload() {NIY_POEM}
+    /**
+     * The cache in front of interp, for its hit and miss counters. nullptr if not enabled.
+     */
+    [[nodiscard]] std::shared_ptr<QueryCache> cache() const;
 
 
    private:
+    /**
+     * Drops every interpolator and bumps the version, to be called when the values or the grid of the table change
+     *
+     * The table is detached from its JIT loader.
+     */
     void reset();
 
-    void build_interpolator();
+    /**
+     * Drops every built interpolator
+     */
+    void drop_interpolators();
+
+    void build_interpolator(INTERPOLATION_METHOD interpolation_method);
+
+    /**
+     * Index into the values of the grid point the nearest to the point whose coordinate along dimension idim is
+     * coord(idim)
+     *
+     * bound(idim, coord) manages out of bound coordinates. If it returns false, the point is rejected and false is
+     * returned.
+     */
+    template<class Coords, class Bound>
+    bool nearest_index(Coords &&coord, Bound &&bound, size_t &index) const;
+
+    /**
+     * Out of bound management of nearest, throwing with ERROR and saturating otherwise
+     */
+    double nearest_bound(size_t idim, double coord, OUT_OF_BOUND_METHOD oob_method) const;
+
+    /**
+     * Non throwing out of bound management of nearest, status being updated with the status of the coordinate
+     */
+    bool nearest_query_bound(size_t idim, double &coord, OUT_OF_BOUND_METHOD oob_method, QUERY_STATUS &status) const;
+
+    /**
+     * Gets the out of bound methods of oob_policy in the order of the dimensions, into an array of POEM_MAX_DIMS
+     */
+    void query_methods(const OutOfBoundPolicy &oob_policy, OUT_OF_BOUND_METHOD *oob_methods) const;
+
+    /**
+     * Get the interpolator of an interpolation method, building it at first call
+     *
+     * Thread safe: the interpolator is built once under the node mutex, then atomically published so that later calls
+     * are lock free.
+     */
+    InterpolatorBase *interpolator(INTERPOLATION_METHOD interpolation_method) const;
 
 
    private:
     std::vector<T> m_values;
 
+    // First value of a storage not owned by the table, interleaved with other tables (see pack()) or external (see
+    // bind_values())
+    std::shared_ptr<const T> m_packed_storage;
+    size_t m_packed_column;
+    size_t m_packed_stride;
+    // Tells if m_values holds a materialized copy of the packed values
+    mutable std::atomic<bool> m_is_materialized;
+
+    // Memoization cache of interp, see enable_cache()
+    std::shared_ptr<QueryCache> m_cache;
+
+    // On demand values, see set_jit_loader()
+    std::function<void(T *)> m_jit_loader;
+    mutable std::atomic<bool> m_is_loaded;
+
   };
 
   template<>
   [[nodiscard]] double
-  PolarTable<double>::interp(const DimensionPoint &dimension_point, OUT_OF_BOUND_METHOD oob_method) const;
+  PolarTable<double>::interp(const DimensionPoint &dimension_point,
+                             OUT_OF_BOUND_METHOD oob_method,
+                             INTERPOLATION_METHOD interpolation_method) const;
 
   template<>
   [[nodiscard]] int
-  PolarTable<int>::interp(const DimensionPoint &dimension_point, OUT_OF_BOUND_METHOD oob_method) const;
+  PolarTable<int>::interp(const DimensionPoint &dimension_point,
+                          OUT_OF_BOUND_METHOD oob_method,
+                          INTERPOLATION_METHOD interpolation_method) const;
+
+  template<>
+  [[nodiscard]] double
+  PolarTable<double>::interp_coords(const double *coords,
+                                    OUT_OF_BOUND_METHOD oob_method,
+                                    INTERPOLATION_METHOD interpolation_method) const;
+
+  template<>
+  void PolarTable<double>::warm_up() const;
+
+  template<>
+  void PolarTable<double>::interp_batch(const std::vector<const double *> &coords,
+                                        size_t n_points,
+                                        double *values,
+                                        OUT_OF_BOUND_METHOD oob_method,
+                                        INTERPOLATION_METHOD interpolation_method) const;
+
+  template<>
+  double PolarTable<double>::interp_with_gradient(const DimensionPoint &dimension_point,
+                                                  double *gradient,
+                                                  OUT_OF_BOUND_METHOD oob_method,
+                                                  INTERPOLATION_METHOD interpolation_method) const;
 
+  template<>
+  void PolarTable<double>::interp_with_gradient_batch(const std::vector<const double *> &coords,
+                                                      size_t n_points,
+                                                      double *values,
+                                                      const std::vector<double *> &gradients,
+                                                      OUT_OF_BOUND_METHOD oob_method,
+                                                      INTERPOLATION_METHOD interpolation_method) const;
+
+  template<>
+  QUERY_STATUS PolarTable<double>::query(const DimensionPoint &dimension_point,
+                                         const OutOfBoundPolicy &oob_policy,
+                                         double &value) const;
+
+  template<>
+  void PolarTable<double>::query_batch(const std::vector<const double *> &coords,
+                                       size_t n_points,
+                                       double *values,
+                                       QUERY_STATUS *statuses,
+                                       const OutOfBoundPolicy &oob_policy) const;
+
+  template<>
+  void PolarTable<int>::interp_batch(const std::vector<const double *> &coords,
+                                     size_t n_points,
+                                     int *values,
+                                     OUT_OF_BOUND_METHOD oob_method,
+                                     INTERPOLATION_METHOD interpolation_method) const;
 
   template<typename T>
   std::shared_ptr<PolarTable<T>> make_polar_table(const std::string &name,
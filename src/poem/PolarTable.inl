@@ -15,9 +15,15 @@ namespace poem {
   PolarTable<T>::PolarTable(const std::string &name,
                             const std::string &unit,
                             const std::string &description,
-                            POEM_DATATYPE type, std::shared_ptr<DimensionGrid> dimension_grid) :
+                            POEM_DATATYPE type, std::shared_ptr<DimensionGrid> dimension_grid,
+                            std::shared_ptr<const T> storage) :
       PolarTableBase(name, unit, description, type, dimension_grid),
-      m_values(dimension_grid->size()) {
+      m_values(storage ? 0 : dimension_grid->size()),
+      m_packed_storage(std::move(storage)),
+      m_packed_column(0),
+      m_packed_stride(1),
+      m_is_materialized(false),
+      m_is_loaded(true) {
 
     switch (type) {
       case POEM_DOUBLE:
@@ -78,59 +84,156 @@ namespace poem {
 
   template<typename T>
   void PolarTable<T>::set_value(size_t idx, const T &value) {
+    unpack();
     m_values[idx] = value;
     reset();
   }
 
   template<typename T>
   void PolarTable<T>::set_value(std::vector<size_t> grid_indices, const T &value) {
+    unpack();
     m_values[m_dimension_grid->grid_to_index(grid_indices)] = value;
+    reset();
   }
 
   template<typename T>
-  const vector<T> &PolarTable<T>::values() const {
+  ValuesView<T>::ValuesView(const PolarTable<T> &polar_table) :
+      m_guard(polar_table),
+      m_data(polar_table.data()),
+      m_stride(polar_table.stride()),
+      m_size(polar_table.size()) {}
+
+  template<typename T>
+  const std::vector<T> &PolarTable<T>::values() const {
+    ReadGuard guard(*this);
+    if (m_packed_storage && !m_is_materialized.load(std::memory_order_acquire)) {
+      auto self = const_cast<PolarTable<T> *>(this);
+      std::lock_guard<std::mutex> lock(self->m_mutex);
+      if (!m_is_materialized.load(std::memory_order_relaxed)) {
+        self->m_values.resize(size());
+        const T *data_ = data();
+        for (size_t idx = 0; idx < self->m_values.size(); ++idx) {
+          self->m_values[idx] = data_[idx * m_packed_stride];
+        }
+        m_is_materialized.store(true, std::memory_order_release);
+      }
+    }
     return m_values;
   }
 
   template<typename T>
-  vector<T> &PolarTable<T>::values() {
+  std::vector<T> &PolarTable<T>::values() {
+    unpack();
+    reset();
     return m_values;
   }
 
   template<typename T>
-  void PolarTable<T>::set_values(const vector<T> &new_values) {
-    if (new_values.size() != m_values.size()) {
+  const T *PolarTable<T>::data() const {
+    ReadGuard guard(*this);
+    return m_packed_storage ? m_packed_storage.get() + m_packed_column : m_values.data();
+  }
+
+  template<typename T>
+  ValuesView<T> PolarTable<T>::view() const {
+    return ValuesView<T>(*this);
+  }
+
+  template<typename T>
+  size_t PolarTable<T>::stride() const {
+    return m_packed_storage ? m_packed_stride : 1;
+  }
+
+  template<typename T>
+  bool PolarTable<T>::is_packed() const {
+    return (bool) m_packed_storage;
+  }
+
+  template<typename T>
+  void PolarTable<T>::pack(std::shared_ptr<const std::vector<T>> storage, size_t column, size_t stride) {
+    if (column >= stride || storage->size() != size() * stride) {
+      LogCriticalError("In PolarTable {}, packed storage of size {} does not fit the table of size {} with a "
+                       "stride of {}", m_name, storage->size(), size(), stride);
+      CRITICAL_ERROR_POEM
+    }
+    // Aliasing pointer, keeping the storage alive
+    m_packed_storage = std::shared_ptr<const T>(storage, storage->data());
+    m_packed_column = column;
+    m_packed_stride = stride;
+    m_is_materialized.store(false, std::memory_order_release);
+    std::vector<T>().swap(m_values);
+  }
+
+  template<typename T>
+  void PolarTable<T>::bind_values(std::shared_ptr<const T> storage) {
+    if (!storage) {
+      LogCriticalError("In PolarTable {}, attempting to bind null values", m_name);
+      CRITICAL_ERROR_POEM
+    }
+    unpack();
+    reset();
+    m_packed_storage = std::move(storage);
+    m_packed_column = 0;
+    m_packed_stride = 1;
+    m_is_materialized.store(false, std::memory_order_release);
+    std::vector<T>().swap(m_values);
+  }
+
+  template<typename T>
+  void PolarTable<T>::unpack() {
+    jit_load();
+    if (!m_packed_storage) return;
+    (void) std::as_const(*this).values();  // Materialization, if not already done
+    m_packed_storage.reset();
+    m_packed_column = 0;
+    m_packed_stride = 1;
+    m_is_materialized.store(false, std::memory_order_release);
+  }
+
+  template<typename T>
+  void PolarTable<T>::set_values(const std::vector<T> &new_values) {
+    if (new_values.size() != size()) {
       LogCriticalError("Attempting to set values in PolarTable of different size ({} and {})",
-                       m_values.size(), new_values.size());
+                       size(), new_values.size());
       CRITICAL_ERROR_POEM
     }
+    unpack();
     m_values = new_values;
+    reset();
   }
 
   template<typename T>
   void PolarTable<T>::fill_with(T value) {
+    unpack();
     m_values = std::vector<T>(dimension_grid()->size(), value);
+    reset();
   }
 
   template<typename T>
   std::shared_ptr<PolarTable<T>> PolarTable<T>::copy() const {
+    ReadGuard guard(*this);
     auto polar_table = std::make_shared<PolarTable<T>>(m_name, m_unit, m_description, m_type, m_dimension_grid);
-    polar_table->set_values(m_values);
+    polar_table->set_values(values());
+    polar_table->set_interpolation_method(m_interpolation_method);
     return polar_table;
   }
 
   template<typename T>
   void PolarTable<T>::multiply_by(const T &coeff) {
+    unpack();
     for (auto &val: m_values) {
       val *= coeff;
     }
+    reset();
   }
 
   template<typename T>
   void PolarTable<T>::offset(const T &val) {
+    unpack();
     for (auto &val_: m_values) {
       val_ += val;
     }
+    reset();
   }
 
   template<typename T>
@@ -144,33 +247,49 @@ namespace poem {
       LogCriticalError("Attempting to sum two PolarTable of different size ({} and {}", size(), other->size());
       CRITICAL_ERROR_POEM
     }
+    unpack();
+    auto other_values = other->view();
     for (size_t idx = 0; idx < size(); ++idx) {
-      m_values[idx] += other->m_values[idx];
+      m_values[idx] += other_values[idx];
     }
+    reset();
   }
 
   template<typename T>
   void PolarTable<T>::abs() {
+    unpack();
     for (auto &val: m_values) {
       val = std::abs(val);
     }
+    reset();
   }
 
   template<typename T>
   T PolarTable<T>::min() const {
-    return *std::min_element(m_values.cbegin(), m_values.cend());
+    auto values_ = view();
+    T min = values_[0];
+    for (size_t idx = 1; idx < values_.size(); ++idx) {
+      min = std::min(min, values_[idx]);
+    }
+    return min;
   }
 
   template<typename T>
   T PolarTable<T>::max() const {
-    return *std::max_element(m_values.cbegin(), m_values.cend());
+    auto values_ = view();
+    T max = values_[0];
+    for (size_t idx = 1; idx < values_.size(); ++idx) {
+      max = std::max(max, values_[idx]);
+    }
+    return max;
   }
 
   template<typename T>
   T PolarTable<T>::mean() const {
+    auto values_ = view();
     T mean = 0;
-    for (const auto &val: m_values) {
-      mean += val;
+    for (size_t idx = 0; idx < values_.size(); ++idx) {
+      mean += values_[idx];
     }
     return mean / (T) size();
   }
@@ -181,8 +300,14 @@ namespace poem {
     auto other_ = static_cast<const PolarTable<T> *>(&other);
     bool equal = *m_dimension_grid == *other_->m_dimension_grid;
     equal &= PolarNode::operator==(other);
-    equal &= m_values == other_->m_values;
-    return equal;
+    if (!equal) return false;
+
+    auto values_ = view();
+    auto other_values = other_->view();
+    for (size_t idx = 0; idx < values_.size(); ++idx) {
+      if (values_[idx] != other_values[idx]) return false;
+    }
+    return true;
   }
 
   template<typename T>
@@ -198,53 +323,236 @@ namespace poem {
       CRITICAL_ERROR_POEM
     }
 
-    std::vector<size_t> indices(dim());
-    size_t index = 0;
-    for (const auto &coord: dimension_point) {
-      double coord_ = coord;
-
-      // Out of Bound management
-      if (coord_ < m_dimension_grid->min(index) || coord_ > m_dimension_grid->max(index)) {
-        switch (oob_method_) {
-          case ERROR: {
-            LogCriticalError("In PolarTable {}, while calling nearest, out of bound value found for"
-                             "dimension {}. Min: {}, Max: {}, Value: {}",
-                             m_name, m_dimension_grid->dimension_set()->name(index),
-                             m_dimension_grid->min(index), m_dimension_grid->max(index),
-                             coord);
-            CRITICAL_ERROR_POEM
-          }
-          default: {
-            coord_ = coord_ < m_dimension_grid->min(index) ?
-                     m_dimension_grid->min(index) : m_dimension_grid->max(index);
-          }
-        }
+    ReadGuard guard(*this);
+    size_t index;
+    nearest_index([&dimension_point](size_t idim) { return dimension_point[idim]; },
+                  [this, oob_method_](size_t idim, double &coord) {
+                    coord = nearest_bound(idim, coord, oob_method_);
+                    return true;
+                  },
+                  index);
+    return data()[stride() * index];
+  }
+
+  template<typename T>
+  void PolarTable<T>::nearest_batch(const std::vector<const double *> &coords,
+                                    size_t n_points,
+                                    T *values,
+                                    OUT_OF_BOUND_METHOD oob_method) const {
+    if (coords.size() != dim()) {
+      LogCriticalError("[PolarTable::nearest_batch] In PolarTable {} of dimension {}, "
+                       "got coordinates for {} dimensions", m_name, dim(), coords.size());
+      CRITICAL_ERROR_POEM
+    }
+
+    ReadGuard guard(*this);
+    const T *data_ = data();
+    const size_t stride_ = stride();
+    auto bound = [this, oob_method](size_t idim, double &coord) {
+      coord = nearest_bound(idim, coord, oob_method);
+      return true;
+    };
+    size_t index;
+    for (size_t ipoint = 0; ipoint < n_points; ++ipoint) {
+      nearest_index([&coords, ipoint](size_t idim) { return coords[idim][ipoint]; }, bound, index);
+      values[ipoint] = data_[stride_ * index];
+    }
+  }
+
+  template<typename T>
+  QUERY_STATUS PolarTable<T>::query(const DimensionPoint &dimension_point,
+                                    const OutOfBoundPolicy &oob_policy,
+                                    T &value) const {
+    if (dimension_point.dimension_set() != m_dimension_grid->dimension_set()) {
+      LogCriticalError("[PolarTable::query] DimensionPoint has not the same DimensionSet as the PolarTable");
+      CRITICAL_ERROR_POEM
+    }
+
+    std::array<OUT_OF_BOUND_METHOD, POEM_MAX_DIMS> oob_methods;
+    query_methods(oob_policy, oob_methods.data());
+
+    ReadGuard guard(*this);
+    QUERY_STATUS status = IN_RANGE;
+    size_t index;
+    if (nearest_index([&dimension_point](size_t idim) { return dimension_point[idim]; },
+                      [this, &oob_methods, &status](size_t idim, double &coord) {
+                        return nearest_query_bound(idim, coord, oob_methods[idim], status);
+                      },
+                      index)) {
+      value = data()[stride() * index];
+    } else {
+      value = rejected_value<T>();
+    }
+    return status;
+  }
+
+  template<typename T>
+  void PolarTable<T>::query_batch(const std::vector<const double *> &coords,
+                                  size_t n_points,
+                                  T *values,
+                                  QUERY_STATUS *statuses,
+                                  const OutOfBoundPolicy &oob_policy) const {
+    if (coords.size() != dim()) {
+      LogCriticalError("[PolarTable::query_batch] In PolarTable {} of dimension {}, "
+                       "got coordinates for {} dimensions", m_name, dim(), coords.size());
+      CRITICAL_ERROR_POEM
+    }
+
+    std::array<OUT_OF_BOUND_METHOD, POEM_MAX_DIMS> oob_methods;
+    query_methods(oob_policy, oob_methods.data());
+
+    ReadGuard guard(*this);
+    const T *data_ = data();
+    const size_t stride_ = stride();
+    size_t index;
+    for (size_t ipoint = 0; ipoint < n_points; ++ipoint) {
+      QUERY_STATUS &status = statuses[ipoint] = IN_RANGE;
+      if (nearest_index([&coords, ipoint](size_t idim) { return coords[idim][ipoint]; },
+                        [this, &oob_methods, &status](size_t idim, double &coord) {
+                          return nearest_query_bound(idim, coord, oob_methods[idim], status);
+                        },
+                        index)) {
+        values[ipoint] = data_[stride_ * index];
+      } else {
+        values[ipoint] = rejected_value<T>();
       }
+    }
+  }
 
-      // Get nearest index
-      auto values = m_dimension_grid->values(index);
-      auto it = std::min_element(values.begin(), values.end(),
-                                 [coord_](double a, double b) {
-                                   return std::abs(a - coord_) < std::abs(b - coord_);
-                                 });
+  template<typename T>
+  void PolarTable<T>::query_methods(const OutOfBoundPolicy &oob_policy, OUT_OF_BOUND_METHOD *oob_methods) const {
+    if (dim() > POEM_MAX_DIMS) {
+      LogCriticalError("[PolarTable::query] In PolarTable {}, queries not supported for dimensions higher "
+                       "than {} (found {})", m_name, POEM_MAX_DIMS, dim());
+      CRITICAL_ERROR_POEM
+    }
+    oob_policy.methods(*m_dimension_grid->dimension_set(), oob_methods);
+  }
 
-      indices[index] = std::distance(values.begin(), it);
-      index++;
+  template<typename T>
+  template<class Coords, class Bound>
+  bool PolarTable<T>::nearest_index(Coords &&coord, Bound &&bound, size_t &index) const {
+    const auto &dimension_grid = *m_dimension_grid;
+
+    // Row major index computed on the fly, from the last dimension
+    index = 0;
+    size_t stride = 1;
+    for (int idim = (int) dimension_grid.ndims() - 1; idim >= 0; --idim) {
+      double coord_ = dimension_grid.wrap(idim, coord(idim));
+      if (!bound(idim, coord_)) return false;
+
+      index += dimension_grid.nearest_index(idim, coord_) * stride;
+      stride *= dimension_grid.values(idim).size();
     }
 
-    index = m_dimension_grid->grid_to_index(indices);
+    return true;
+  }
 
-    return m_values[index];
+  template<typename T>
+  double PolarTable<T>::nearest_bound(size_t idim, double coord, OUT_OF_BOUND_METHOD oob_method) const {
+    // No extrapolation with nearest, the coordinate is saturated
+    double min = m_dimension_grid->min(idim);
+    double max = m_dimension_grid->range_max(idim);
+    return bound_coordinate(coord, min, max, oob_method == ERROR ? ERROR : SATURATE, [&]() {
+      return fmt::format("In PolarTable {}, while calling nearest, out of bound value found for dimension {}",
+                         m_name, m_dimension_grid->dimension_set()->name(idim));
+    });
+  }
+
+  template<typename T>
+  bool PolarTable<T>::nearest_query_bound(size_t idim,
+                                          double &coord,
+                                          OUT_OF_BOUND_METHOD oob_method,
+                                          QUERY_STATUS &status) const {
+    double min = m_dimension_grid->min(idim);
+    double max = m_dimension_grid->range_max(idim);
+    QUERY_STATUS coord_status = apply_out_of_bound_method(coord, min, max, oob_method);
+    if (coord_status == EXTRAPOLATED) {
+      // No extrapolation with nearest, the coordinate is saturated
+      coord = coord < min ? min : max;
+      coord_status = SATURATED;
+    }
+    status = std::max(status, coord_status);
+    return coord_status != REJECTED;
   }
 
   template<typename T>
-  // FIXME: potentiellement supprimer si ca fout la grouille
   T PolarTable<T>::interp(const DimensionPoint &dimension_point, OUT_OF_BOUND_METHOD oob_method) const {
+    return interp(dimension_point, oob_method, m_interpolation_method);
+  }
+
+  template<typename T>
+  // FIXME: potentiellement supprimer si ca fout la grouille
+  T PolarTable<T>::interp(const DimensionPoint &dimension_point,
+                          OUT_OF_BOUND_METHOD oob_method,
+                          INTERPOLATION_METHOD interpolation_method) const {
     T val;
     LogCriticalError("interp is unable to deal with type {}", typeid(val).name());
     CRITICAL_ERROR_POEM
   }
 
+  template<typename T>
+  T PolarTable<T>::interp_coords(const double *coords,
+                                 OUT_OF_BOUND_METHOD oob_method,
+                                 INTERPOLATION_METHOD interpolation_method) const {
+    LogCriticalError("interp_coords is unable to deal with type {}", typeid(T).name());
+    CRITICAL_ERROR_POEM
+  }
+
+  template<typename T>
+  void PolarTable<T>::interp_batch(const std::vector<const double *> &coords,
+                                   size_t n_points,
+                                   T *values,
+                                   OUT_OF_BOUND_METHOD oob_method) const {
+    interp_batch(coords, n_points, values, oob_method, m_interpolation_method);
+  }
+
+  template<typename T>
+  void PolarTable<T>::interp_batch(const std::vector<const double *> &coords,
+                                   size_t n_points,
+                                   T *values,
+                                   OUT_OF_BOUND_METHOD oob_method,
+                                   INTERPOLATION_METHOD interpolation_method) const {
+    LogCriticalError("interp_batch is unable to deal with type {}", typeid(T).name());
+    CRITICAL_ERROR_POEM
+  }
+
+  template<typename T>
+  T PolarTable<T>::interp_with_gradient(const DimensionPoint &dimension_point,
+                                        double *gradient,
+                                        OUT_OF_BOUND_METHOD oob_method) const {
+    return interp_with_gradient(dimension_point, gradient, oob_method, m_interpolation_method);
+  }
+
+  template<typename T>
+  T PolarTable<T>::interp_with_gradient(const DimensionPoint &dimension_point,
+                                        double *gradient,
+                                        OUT_OF_BOUND_METHOD oob_method,
+                                        INTERPOLATION_METHOD interpolation_method) const {
+    LogCriticalError("interp_with_gradient is unable to deal with type {}", typeid(T).name());
+    CRITICAL_ERROR_POEM
+  }
+
+  template<typename T>
+  void PolarTable<T>::interp_with_gradient_batch(const std::vector<const double *> &coords,
+                                                 size_t n_points,
+                                                 T *values,
+                                                 const std::vector<double *> &gradients,
+                                                 OUT_OF_BOUND_METHOD oob_method) const {
+    interp_with_gradient_batch(coords, n_points, values, gradients, oob_method, m_interpolation_method);
+  }
+
+  template<typename T>
+  void PolarTable<T>::interp_with_gradient_batch(const std::vector<const double *> &coords,
+                                                 size_t n_points,
+                                                 T *values,
+                                                 const std::vector<double *> &gradients,
+                                                 OUT_OF_BOUND_METHOD oob_method,
+                                                 INTERPOLATION_METHOD interpolation_method) const {
+    LogCriticalError("interp_with_gradient_batch is unable to deal with type {}", typeid(T).name());
+    CRITICAL_ERROR_POEM
+  }
+
   template<typename T>
   std::shared_ptr<PolarTable<T>>
   PolarTable<T>::slice(std::unordered_map<std::string, double> prescribed_values,
@@ -364,7 +672,8 @@ namespace poem {
       CRITICAL_ERROR_POEM
     }
 
-    for (size_t idim = 0; idim < dim(); ++idim) {
+    // Other out of bound methods allow resampling out of the range of the table
+    for (size_t idim = 0; idim < dim() && oob_method == ERROR; ++idim) {
       if (new_dimension_grid->min(idim) < m_dimension_grid->min(idim) ||
           new_dimension_grid->max(idim) > m_dimension_grid->max(idim)) {
         LogCriticalError("Out of range values for resampling");
@@ -385,39 +694,205 @@ namespace poem {
     return resampled_polar_table;
   }
 
+  template<typename T>
+  void PolarTable<T>::warm_up() const {
+    // Nothing to prepare for non double tables, nearest is used instead of interp
+  }
+
+  template<typename T>
+  void PolarTable<T>::enable_cache(size_t capacity, const std::unordered_map<std::string, double> &resolutions) {
+    if (m_type != POEM_DOUBLE) {
+      LogCriticalError("In PolarTable {}, cache is only available for double tables", m_name);
+      CRITICAL_ERROR_POEM
+    }
+    m_cache = std::make_shared<QueryCache>(capacity,
+                                           cache_resolutions(*m_dimension_grid->dimension_set(), resolutions), 1);
+  }
+
+  template<typename T>
+  void PolarTable<T>::disable_cache() {
+    m_cache.reset();
+  }
+
+  template<typename T>
+  std::shared_ptr<QueryCache> PolarTable<T>::cache() const {
+    return m_cache;
+  }
+
   template<typename T>
   void PolarTable<T>::reset() {
-    m_interpolator.reset();
+    m_version.fetch_add(1, std::memory_order_release);
+    if (m_cache) m_cache->clear();
+    // Values now differ from the source of the loader, or the grid changed with values not resident
+    jit_load();
+    m_jit_loader = nullptr;
+    drop_interpolators();
+  }
+
+  template<typename T>
+  void PolarTable<T>::drop_interpolators() {
+    bool built = false;
+    for (const auto &interpolator_ptr: m_interpolator_ptrs) {
+      built |= interpolator_ptr.load(std::memory_order_acquire) != nullptr;
+    }
+    if (!built) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t method = 0; method < N_INTERPOLATION_METHODS; ++method) {
+      m_interpolator_ptrs[method].store(nullptr, std::memory_order_release);
+      m_interpolators[method].reset();
+    }
+  }
+
+  template<typename T>
+  size_t PolarTable<T>::memsize() const {
+    auto self = const_cast<PolarTable<T> *>(this);
+    std::lock_guard<std::mutex> lock(self->m_mutex);
+    size_t size = sizeof(*this) + m_values.capacity() * sizeof(T);
+    for (const auto &interpolator_ptr: m_interpolator_ptrs) {
+      auto interpolator = interpolator_ptr.load(std::memory_order_acquire);
+      if (interpolator) size += interpolator->memsize();
+    }
+    return size;
+  }
+
+  template<typename T>
+  void PolarTable<T>::set_jit_loader(std::function<void(T *)> loader) {
+    unpack();
+    m_jit_loader = std::move(loader);
+    // Kept once set, a detached table possibly being still pinned by a view
+    if (m_jit_loader) m_is_tracked = true;
+    jit_unload();
+  }
+
+  template<typename T>
+  bool PolarTable<T>::has_jit_loader() const {
+    return (bool) m_jit_loader;
+  }
+
+  template<typename T>
+  bool PolarTable<T>::is_loaded() const {
+    return m_is_loaded.load(std::memory_order_acquire);
   }
 
   template<typename T>
-  void PolarTable<T>::build_interpolator() {
-    // FIXME: ce switch devrait plutot se trouver dans la classe Interpolator !
-    switch (dim()) {
+  void PolarTable<T>::jit_load() const {
+    if (m_is_loaded.load(std::memory_order_acquire)) return;
+
+    {
+      auto self = const_cast<PolarTable<T> *>(this);
+      std::lock_guard<std::mutex> lock(self->m_mutex);
+      // Another thread may have loaded it while we were waiting for the lock
+      if (m_is_loaded.load(std::memory_order_relaxed)) return;
+      self->m_values.resize(size());
+      m_jit_loader(self->m_values.data());
+      m_is_loaded.store(true, std::memory_order_release);
+    }
+    // Outside of the lock, the MemoryManager taking it to evict other tables
+    notify_loaded();
+  }
+
+  template<typename T>
+  void PolarTable<T>::jit_unload() {
+    if (!m_jit_loader) {
+      LogWarningError("PolarTable {} has no JIT loader and is kept in memory", m_name);
+      return;
+    }
+    if (!m_is_loaded.load(std::memory_order_acquire)) return;
+
+    if (m_cache) m_cache->clear();
+    drop_interpolators();
+    // Against a concurrent jit_load from an unpinned access
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_packed_storage.reset();
+    m_packed_column = 0;
+    m_packed_stride = 1;
+    m_is_materialized.store(false, std::memory_order_release);
+    std::vector<T>().swap(m_values);
+    m_is_loaded.store(false, std::memory_order_release);
+  }
+
+  template<typename T>
+  InterpolatorBase *PolarTable<T>::interpolator(INTERPOLATION_METHOD interpolation_method) const {
+    auto interpolator = m_interpolator_ptrs[interpolation_method].load(std::memory_order_acquire);
+    if (!interpolator) {
+      // Outside of the lock, taken by jit_load too
+      jit_load();
+      auto self = const_cast<PolarTable<T> *>(this);
+      std::lock_guard<std::mutex> lock(self->m_mutex);
+      // Another thread may have built it while we were waiting for the lock
+      interpolator = m_interpolator_ptrs[interpolation_method].load(std::memory_order_relaxed);
+      if (!interpolator) {
+        self->build_interpolator(interpolation_method);
+        interpolator = m_interpolators[interpolation_method].get();
+        m_interpolator_ptrs[interpolation_method].store(interpolator, std::memory_order_release);
+      }
+    }
+    return interpolator;
+  }
+
+  /**
+   * Interpolator of a given method for a table with ndims dimensions: compile time number of dimensions up to 6,
+   * runtime number of dimensions above
+   */
+  template<typename T, INTERPOLATION_METHOD method>
+  std::unique_ptr<InterpolatorBase> make_interpolator(const PolarTable<T> *polar_table, size_t ndims) {
+    std::unique_ptr<InterpolatorBase> interpolator;
+    switch (ndims) {
       case 1:
-        m_interpolator = std::make_unique<Interpolator<T, 1>>(this);
+        interpolator = std::make_unique<Interpolator<T, 1, method>>(polar_table);
         break;
       case 2:
-        m_interpolator = std::make_unique<Interpolator<T, 2>>(this);
+        interpolator = std::make_unique<Interpolator<T, 2, method>>(polar_table);
         break;
       case 3:
-        m_interpolator = std::make_unique<Interpolator<T, 3>>(this);
+        interpolator = std::make_unique<Interpolator<T, 3, method>>(polar_table);
         break;
       case 4:
-        m_interpolator = std::make_unique<Interpolator<T, 4>>(this);
+        interpolator = std::make_unique<Interpolator<T, 4, method>>(polar_table);
         break;
       case 5:
-        m_interpolator = std::make_unique<Interpolator<T, 5>>(this);
+        interpolator = std::make_unique<Interpolator<T, 5, method>>(polar_table);
         break;
       case 6:
-        m_interpolator = std::make_unique<Interpolator<T, 6>>(this);
+        interpolator = std::make_unique<Interpolator<T, 6, method>>(polar_table);
         break;
       default:
-        LogCriticalError("ND interpolation not supported for dimensions higher than 6 (found {})", dim());
+        // Runtime number of dimensions, limited to POEM_MAX_DIMS
+        interpolator = std::make_unique<Interpolator<T, 0, method>>(polar_table);
+    }
+    return interpolator;
+  }
+
+  template<typename T>
+  void PolarTable<T>::build_interpolator(INTERPOLATION_METHOD interpolation_method) {
+    std::unique_ptr<InterpolatorBase> interpolator;
+    if constexpr (std::is_same_v<T, double>) {
+      switch (interpolation_method) {
+        case LINEAR:
+          interpolator = make_interpolator<T, LINEAR>(this, dim());
+          break;
+        case CUBIC:
+          interpolator = make_interpolator<T, CUBIC>(this, dim());
+          break;
+        case PCHIP:
+          interpolator = make_interpolator<T, PCHIP>(this, dim());
+          break;
+        case AKIMA:
+          interpolator = make_interpolator<T, AKIMA>(this, dim());
+          break;
+      }
+    } else {
+      if (interpolation_method != LINEAR) {
+        LogCriticalError("In PolarTable {}, {} interpolation method is only available for double tables",
+                         m_name, interpolation_method_to_string(interpolation_method));
         CRITICAL_ERROR_POEM
+      }
+      interpolator = make_interpolator<T, LINEAR>(this, dim());
     }
 
-    m_interpolator->build();
+    interpolator->build();
+    m_interpolators[interpolation_method] = std::move(interpolator);
   }
 
 }  // poem
@@ -0,0 +1,211 @@
+#include "QueryCache.h"
+
+#include <bit>
+#include <cmath>
+
+#include "exceptions.h"
+#include "DimensionSet.h"
+#include "DimensionGrid.h"
+
+namespace poem {
+
+  namespace {
+    // Maximum number of shards, each shard holding at least one entry
+    constexpr size_t max_shards = 16;
+  }  // namespace
+
+  QueryCache::QueryCache(size_t capacity, const std::vector<double> &resolutions, size_t n_values) :
+      m_capacity(capacity),
+      m_resolutions(resolutions),
+      m_n_values(n_values),
+      m_hits(0),
+      m_misses(0) {
+
+    if (capacity == 0) {
+      LogCriticalError("QueryCache capacity must be positive");
+      CRITICAL_ERROR_POEM
+    }
+    if (resolutions.size() > POEM_MAX_DIMS) {
+      LogCriticalError("QueryCache not supported for dimensions higher than {} (found {})",
+                       POEM_MAX_DIMS, resolutions.size());
+      CRITICAL_ERROR_POEM
+    }
+    for (double resolution: resolutions) {
+      if (!(resolution >= 0.)) {
+        LogCriticalError("QueryCache resolutions must be positive or null (found {})", resolution);
+        CRITICAL_ERROR_POEM
+      }
+    }
+
+    size_t n_shards = std::min(max_shards, capacity);
+    m_shard_capacity = (capacity + n_shards - 1) / n_shards;
+    m_shards.reserve(n_shards);
+    for (size_t ishard = 0; ishard < n_shards; ++ishard) {
+      m_shards.push_back(std::make_unique<Shard>());
+    }
+  }
+
+  size_t QueryCache::capacity() const {
+    return m_capacity;
+  }
+
+  const std::vector<double> &QueryCache::resolutions() const {
+    return m_resolutions;
+  }
+
+  size_t QueryCache::n_values() const {
+    return m_n_values;
+  }
+
+  size_t QueryCache::hits() const {
+    return m_hits.load(std::memory_order_relaxed);
+  }
+
+  size_t QueryCache::misses() const {
+    return m_misses.load(std::memory_order_relaxed);
+  }
+
+  double QueryCache::hit_rate() const {
+    size_t hits_ = hits();
+    size_t n_queries = hits_ + misses();
+    return n_queries == 0 ? 0. : (double) hits_ / (double) n_queries;
+  }
+
+  void QueryCache::reset_counters() {
+    m_hits = 0;
+    m_misses = 0;
+  }
+
+  size_t QueryCache::size() const {
+    size_t size = 0;
+    for (const auto &shard: m_shards) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      size += shard->slots.size();
+    }
+    return size;
+  }
+
+  void QueryCache::clear() {
+    for (const auto &shard: m_shards) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->slots.clear();
+      shard->keys.clear();
+      shard->referenced.clear();
+      shard->values.clear();
+      shard->hand = 0;
+    }
+  }
+
+  size_t QueryCache::KeyHash::operator()(const Key &key) const {
+    // FNV-1a on the 64 bits words, followed by a final mix so that the low bits select the shard evenly
+    uint64_t hash = 14695981039346656037ULL;
+    for (int64_t word: key) {
+      hash ^= (uint64_t) word;
+      hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return (size_t) hash;
+  }
+
+  bool QueryCache::make_key(const DimensionGrid &dimension_grid, const double *coords, int64_t tag, Key &key,
+                            double *snapped_coords) const {
+    // Quantized coordinates beyond this bound are not cached
+    constexpr double max_key = 4.e18;
+
+    // The grid lost dimensions (squeezed) since the cache was built
+    if (dimension_grid.ndims() != m_resolutions.size()) return false;
+
+    key.fill(0);
+    int64_t bound_flags = 0;
+    for (size_t idim = 0; idim < m_resolutions.size(); ++idim) {
+      double coord = dimension_grid.wrap(idim, coords[idim]);
+      if (std::isnan(coord)) return false;
+      double resolution = m_resolutions[idim];
+      if (resolution == 0.) {
+        // Exact key, -0. and 0. being the same coordinate
+        key[idim] = std::bit_cast<int64_t>(coord + 0.);
+        snapped_coords[idim] = coord;
+        continue;
+      }
+
+      double q = std::round(coord / resolution);
+      if (std::abs(q) > max_key) return false;
+      key[idim] = (int64_t) q;
+      double snapped_coord = q * resolution;
+
+      // A coordinate in the grid is not snapped out of it. Flagged in the key, as out of bound coordinates with the
+      // same q are computed at q * resolution.
+      double min = dimension_grid.min(idim);
+      double max = dimension_grid.range_max(idim);
+      if (coord >= min && coord <= max) {
+        if (snapped_coord < min) {
+          snapped_coord = min;
+          bound_flags |= int64_t(1) << (2 * idim);
+        } else if (snapped_coord > max) {
+          snapped_coord = max;
+          bound_flags |= int64_t(1) << (2 * idim + 1);
+        }
+      }
+      snapped_coords[idim] = snapped_coord;
+    }
+    key[POEM_MAX_DIMS] = bound_flags;
+    key[POEM_MAX_DIMS + 1] = tag;
+    return true;
+  }
+
+  bool QueryCache::lookup(Shard &shard, const Key &key, double *values) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.slots.find(key);
+    if (it == shard.slots.end()) return false;
+    size_t slot = it->second;
+    shard.referenced[slot] = true;
+    std::copy_n(shard.values.begin() + slot * m_n_values, m_n_values, values);
+    return true;
+  }
+
+  void QueryCache::insert(Shard &shard, const Key &key, const double *values) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // Computed concurrently by another thread
+    if (shard.slots.contains(key)) return;
+
+    size_t slot;
+    if (shard.keys.size() < m_shard_capacity) {
+      slot = shard.keys.size();
+      shard.keys.push_back(key);
+      shard.referenced.push_back(false);
+      shard.values.resize(shard.values.size() + m_n_values);
+    } else {
+      // CLOCK: entries referenced since the last pass of the hand get a second chance
+      while (shard.referenced[shard.hand]) {
+        shard.referenced[shard.hand] = false;
+        shard.hand = (shard.hand + 1) % m_shard_capacity;
+      }
+      slot = shard.hand;
+      shard.hand = (shard.hand + 1) % m_shard_capacity;
+      shard.slots.erase(shard.keys[slot]);
+      shard.keys[slot] = key;
+      shard.referenced[slot] = false;
+    }
+    shard.slots[key] = slot;
+    std::copy_n(values, m_n_values, shard.values.begin() + slot * m_n_values);
+  }
+
+  std::vector<double> cache_resolutions(const DimensionSet &dimension_set,
+                                        const std::unordered_map<std::string, double> &resolutions) {
+    for (const auto &pair: resolutions) {
+      if (!dimension_set.contains(pair.first)) {
+        LogCriticalError("Cache resolution given for unknown dimension {}", pair.first);
+        CRITICAL_ERROR_POEM
+      }
+    }
+    std::vector<double> resolutions_(dimension_set.size(), 0.);
+    for (size_t idim = 0; idim < dimension_set.size(); ++idim) {
+      auto it = resolutions.find(dimension_set.name(idim));
+      if (it != resolutions.end()) resolutions_[idim] = it->second;
+    }
+    return resolutions_;
+  }
+
+}  // poem
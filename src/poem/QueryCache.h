@@ -0,0 +1,166 @@
+#ifndef POEM_QUERYCACHE_H
+#define POEM_QUERYCACHE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Interpolator.h"
+
+namespace poem {
+
+  // Forward declaration
+  class DimensionSet;
+
+  class DimensionGrid;
+
+  /**
+   * Bounded concurrent memoization cache of query results, keyed by quantized coordinates
+   *
+   * Each coordinate is quantized to the resolution of its dimension: the key is round(coord / resolution) and the
+   * query is computed at the snapped coordinate round(coord / resolution) * resolution, so that the cached result does
+   * not depend on the order of the queries. A null resolution keys on the exact coordinate. An integer tag (e.g. out of
+   * bound method) completes the key.
+   *
+   * Coordinates are wrapped on PERIODIC and SYMMETRIC dimensions before being quantized. A coordinate within the
+   * bounds of the DimensionGrid is never snapped out of them: near a bound, it is snapped to the bound itself, so that
+   * cached queries do not fail or extrapolate where uncached queries would not.
+   *
+   * Entries are spread over shards, each with its own lock, and evicted by the CLOCK algorithm (second chance, an
+   * approximation of LRU without any list update on hit). Queries are computed outside of the locks, so two threads
+   * missing the same key at once both compute it.
+   *
+   * The cache does not know the data it memoizes: its owner clears it when they change.
+   */
+  class QueryCache {
+   public:
+    /**
+     * @param capacity maximum number of entries
+     * @param resolutions quantization step of each dimension (0 for exact keys)
+     * @param n_values number of values of a query result
+     */
+    QueryCache(size_t capacity, const std::vector<double> &resolutions, size_t n_values);
+
+    [[nodiscard]] size_t capacity() const;
+
+    [[nodiscard]] const std::vector<double> &resolutions() const;
+
+    [[nodiscard]] size_t n_values() const;
+
+    /**
+     * Gets into values the n_values() results of the query at coords with tag, computing them by
+     * compute(snapped_coords, values) on a miss
+     *
+     * dimension_grid is the grid queried, giving the bounds and periodicities of the dimensions. Points with a NaN
+     * coordinate on a quantized dimension are computed without the cache. If compute throws, nothing is cached.
+     */
+    template<class Compute>
+    void get(const DimensionGrid &dimension_grid, const double *coords, int64_t tag, double *values,
+             Compute &&compute);
+
+    /**
+     * Number of queries served by the cache
+     */
+    [[nodiscard]] size_t hits() const;
+
+    /**
+     * Number of queries computed
+     */
+    [[nodiscard]] size_t misses() const;
+
+    /**
+     * Fraction of the queries served by the cache, 0 without query
+     */
+    [[nodiscard]] double hit_rate() const;
+
+    void reset_counters();
+
+    /**
+     * Number of entries held
+     */
+    [[nodiscard]] size_t size() const;
+
+    /**
+     * Removes every entry, counters being kept
+     */
+    void clear();
+
+   private:
+    // Quantized coordinates, flags of the coordinates snapped to a bound of the grid, tag
+    using Key = std::array<int64_t, POEM_MAX_DIMS + 2>;
+
+    struct KeyHash {
+      size_t operator()(const Key &key) const;
+    };
+
+    /**
+     * A part of the cache with its own lock and clock hand
+     */
+    struct Shard {
+      std::mutex mutex;
+      std::unordered_map<Key, size_t, KeyHash> slots;
+      std::vector<Key> keys;
+      std::vector<bool> referenced;
+      std::vector<double> values;
+      size_t hand = 0;
+    };
+
+    /**
+     * Builds the key of coords, snapped coordinates being written into snapped_coords. Returns false if the point
+     * cannot be cached.
+     */
+    bool make_key(const DimensionGrid &dimension_grid, const double *coords, int64_t tag, Key &key,
+                  double *snapped_coords) const;
+
+    bool lookup(Shard &shard, const Key &key, double *values);
+
+    void insert(Shard &shard, const Key &key, const double *values);
+
+   private:
+    size_t m_capacity;
+    std::vector<double> m_resolutions;
+    size_t m_n_values;
+
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    size_t m_shard_capacity;
+
+    std::atomic<size_t> m_hits;
+    std::atomic<size_t> m_misses;
+  };
+
+  template<class Compute>
+  void QueryCache::get(const DimensionGrid &dimension_grid, const double *coords, int64_t tag, double *values,
+                       Compute &&compute) {
+    Key key;
+    std::array<double, POEM_MAX_DIMS> snapped_coords;
+    if (!make_key(dimension_grid, coords, tag, key, snapped_coords.data())) {
+      compute(coords, values);
+      return;
+    }
+
+    auto &shard = *m_shards[KeyHash()(key) % m_shards.size()];
+    if (lookup(shard, key, values)) {
+      m_hits.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    compute(snapped_coords.data(), values);
+    insert(shard, key, values);
+  }
+
+  /**
+   * Resolutions in the order of dimension_set from a map of resolutions per Dimension name (0 for Dimensions not in
+   * the map). Unknown Dimension names and negative resolutions are an error.
+   */
+  std::vector<double> cache_resolutions(const DimensionSet &dimension_set,
+                                        const std::unordered_map<std::string, double> &resolutions);
+
+}  // poem
+
+#endif //POEM_QUERYCACHE_H
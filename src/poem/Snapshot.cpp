@@ -0,0 +1,572 @@
+#include "Snapshot.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "exceptions.h"
+#include "MemoryManager.h"
+#include "PolarTable.h"
+#include "Polar.h"
+#include "PolarSet.h"
+
+namespace poem {
+
+  namespace {
+
+    constexpr char snapshot_magic[8] = {'P', 'O', 'E', 'M', 'S', 'N', 'A', 'P'};
+    // Written as a native integer, read back differently on a machine of other byte order
+    constexpr uint32_t byte_order_mark = 0x01020304;
+    constexpr size_t alignment = 64;
+
+    struct Header {
+      char magic[8];
+      uint32_t format_version;
+      uint32_t byte_order;
+      uint64_t file_size;
+      uint64_t index_offset;
+      uint64_t index_size;
+      uint64_t content_hash;
+      uint8_t reserved[16];
+    };
+    static_assert(sizeof(Header) == alignment);
+
+    size_t align(size_t offset) {
+      return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    /**
+     * 64 bits FNV-1a hash, fed incrementally
+     */
+    class ContentHash {
+     public:
+      void update(const void *data, size_t size) {
+        auto bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i) {
+          m_hash = (m_hash ^ bytes[i]) * 0x100000001b3ull;
+        }
+      }
+
+      [[nodiscard]] uint64_t value() const {
+        return m_hash;
+      }
+
+     private:
+      uint64_t m_hash = 0xcbf29ce484222325ull;
+    };
+
+    /**
+     * Serialization of the index into a byte buffer
+     */
+    class IndexWriter {
+     public:
+      template<typename T>
+      size_t write(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        size_t position = m_buffer.size();
+        m_buffer.resize(position + sizeof(T));
+        std::memcpy(m_buffer.data() + position, &value, sizeof(T));
+        return position;
+      }
+
+      void write(const std::string &str) {
+        write<uint64_t>(str.size());
+        m_buffer.insert(m_buffer.end(), str.begin(), str.end());
+      }
+
+      void write(const std::vector<double> &values) {
+        write<uint64_t>(values.size());
+        auto bytes = reinterpret_cast<const char *>(values.data());
+        m_buffer.insert(m_buffer.end(), bytes, bytes + values.size() * sizeof(double));
+      }
+
+      /**
+       * Overwrites a value written at position
+       */
+      template<typename T>
+      void patch(size_t position, const T &value) {
+        std::memcpy(m_buffer.data() + position, &value, sizeof(T));
+      }
+
+      [[nodiscard]] const std::vector<char> &buffer() const {
+        return m_buffer;
+      }
+
+     private:
+      std::vector<char> m_buffer;
+    };
+
+    /**
+     * Bound checked parsing of the index
+     */
+    class IndexReader {
+     public:
+      IndexReader(const char *begin, size_t size, const std::string &filename) :
+          m_cursor(begin), m_end(begin + size), m_filename(filename) {}
+
+      template<typename T>
+      T read() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+      }
+
+      /**
+       * Number of items following in the index, each one taking at least one byte
+       */
+      size_t read_count() {
+        auto count = read<uint64_t>();
+        if (count > (size_t) (m_end - m_cursor)) truncated();
+        return count;
+      }
+
+      std::string read_string() {
+        auto size = read<uint64_t>();
+        return {take(size), size};
+      }
+
+      std::vector<double> read_doubles() {
+        auto size = read<uint64_t>();
+        if (size > (size_t) (m_end - m_cursor) / sizeof(double)) truncated();
+        std::vector<double> values(size);
+        std::memcpy(values.data(), take(size * sizeof(double)), size * sizeof(double));
+        return values;
+      }
+
+     private:
+      const char *take(size_t size) {
+        if (size > (size_t) (m_end - m_cursor)) truncated();
+        const char *data = m_cursor;
+        m_cursor += size;
+        return data;
+      }
+
+      [[noreturn]] void truncated() const {
+        LogCriticalError("Snapshot {} has a truncated index", m_filename);
+        CRITICAL_ERROR_POEM
+      }
+
+     private:
+      const char *m_cursor;
+      const char *m_end;
+      const std::string &m_filename;
+    };
+
+    /**
+     * Read only mapping of a whole file, unmapped with the last table referring to it
+     */
+    struct Mapping {
+      const char *data = nullptr;
+      size_t size = 0;
+
+      ~Mapping() {
+        if (data) munmap(const_cast<char *>(data), size);
+      }
+    };
+
+    std::shared_ptr<Mapping> map_file(const std::string &filename) {
+      int fd = open(filename.c_str(), O_RDONLY);
+      if (fd < 0) {
+        LogCriticalError("Snapshot file not found: {}", filename);
+        CRITICAL_ERROR_POEM
+      }
+      struct stat file_stat{};
+      if (fstat(fd, &file_stat) != 0 || (size_t) file_stat.st_size < sizeof(Header)) {
+        close(fd);
+        LogCriticalError("{} is not a POEM snapshot", filename);
+        CRITICAL_ERROR_POEM
+      }
+
+      auto mapping = std::make_shared<Mapping>();
+      mapping->size = file_stat.st_size;
+      void *data = mmap(nullptr, mapping->size, PROT_READ, MAP_PRIVATE, fd, 0);
+      // The mapping keeps its own reference to the file
+      close(fd);
+      if (data == MAP_FAILED) {
+        LogCriticalError("Cannot map snapshot {} into memory", filename);
+        CRITICAL_ERROR_POEM
+      }
+      mapping->data = static_cast<const char *>(data);
+      return mapping;
+    }
+
+    Header read_header(const char *data, size_t size, const std::string &filename) {
+      Header header{};
+      std::memcpy(&header, data, sizeof(Header));
+      if (std::memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) != 0) {
+        LogCriticalError("{} is not a POEM snapshot", filename);
+        CRITICAL_ERROR_POEM
+      }
+      if (header.byte_order != byte_order_mark) {
+        LogCriticalError("Snapshot {} was written on a machine of other byte order", filename);
+        CRITICAL_ERROR_POEM
+      }
+      if (header.format_version != snapshot_format_version) {
+        LogCriticalError("Snapshot {} has format version {}, expected {}",
+                         filename, header.format_version, snapshot_format_version);
+        CRITICAL_ERROR_POEM
+      }
+      if (header.file_size != size || header.index_offset < sizeof(Header) || header.index_offset > size ||
+          header.index_size > size - header.index_offset) {
+        LogCriticalError("Snapshot {} is truncated", filename);
+        CRITICAL_ERROR_POEM
+      }
+      return header;
+    }
+
+    /**
+     * Nodes of the tree starting at polar_node, in pre order, with the index of their parent (-1 for polar_node)
+     */
+    void collect(const std::shared_ptr<PolarNode> &polar_node,
+                 int64_t parent,
+                 std::vector<std::pair<std::shared_ptr<PolarNode>, int64_t>> &nodes) {
+      int64_t index = (int64_t) nodes.size();
+      nodes.emplace_back(polar_node, parent);
+      if (polar_node->polar_node_type() == POLAR_TABLE) return;
+      for (const auto &child: polar_node->children<PolarNode>()) {
+        collect(child, index, nodes);
+      }
+    }
+
+    template<typename T>
+    void write_values(std::ofstream &file, ContentHash &hash, const PolarTable<T> &polar_table) {
+      ReadGuard guard(polar_table);
+      const T *data = polar_table.data();
+      size_t stride = polar_table.stride();
+      std::vector<T> gathered;
+      if (stride != 1) {
+        // Packed table
+        gathered.resize(polar_table.size());
+        for (size_t idx = 0; idx < gathered.size(); ++idx) {
+          gathered[idx] = data[idx * stride];
+        }
+        data = gathered.data();
+      }
+      size_t size = polar_table.size() * sizeof(T);
+      file.write(reinterpret_cast<const char *>(data), (std::streamsize) size);
+      hash.update(data, size);
+    }
+
+    template<typename T>
+    std::shared_ptr<PolarTableBase> map_polar_table(const std::string &name,
+                                                    const std::string &unit,
+                                                    const std::string &description,
+                                                    POEM_DATATYPE type,
+                                                    const std::shared_ptr<DimensionGrid> &dimension_grid,
+                                                    const std::shared_ptr<Mapping> &mapping,
+                                                    uint64_t offset,
+                                                    uint64_t size,
+                                                    const std::string &filename) {
+      if (size != dimension_grid->size() || offset % alignment != 0 || offset > mapping->size ||
+          size > (mapping->size - offset) / sizeof(T)) {
+        LogCriticalError("In snapshot {}, PolarTable {} has inconsistent values", filename, name);
+        CRITICAL_ERROR_POEM
+      }
+      // Aliasing pointer, keeping the mapping alive
+      std::shared_ptr<const T> storage(mapping, reinterpret_cast<const T *>(mapping->data + offset));
+      return std::make_shared<PolarTable<T>>(name, unit, description, type, dimension_grid, std::move(storage));
+    }
+
+  }  // namespace
+
+  void to_snapshot(std::shared_ptr<PolarNode> polar_node, const std::string &filename) {
+    std::vector<std::pair<std::shared_ptr<PolarNode>, int64_t>> nodes;
+    collect(polar_node, -1, nodes);
+
+    IndexWriter index;
+
+    // DimensionGrids, shared ones being written once
+    std::unordered_map<const DimensionGrid *, uint64_t> grid_indices;
+    std::vector<std::shared_ptr<DimensionGrid>> dimension_grids;
+    for (const auto &[node, parent]: nodes) {
+      std::shared_ptr<DimensionGrid> dimension_grid;
+      if (node->polar_node_type() == POLAR) {
+        dimension_grid = node->as_polar()->dimension_grid();
+      } else if (node->polar_node_type() == POLAR_TABLE) {
+        dimension_grid = node->as_polar_table()->dimension_grid();
+      }
+      if (dimension_grid && grid_indices.emplace(dimension_grid.get(), dimension_grids.size()).second) {
+        dimension_grids.push_back(dimension_grid);
+      }
+    }
+    index.write<uint64_t>(dimension_grids.size());
+    for (const auto &dimension_grid: dimension_grids) {
+      index.write<uint64_t>(dimension_grid->ndims());
+      size_t idim = 0;
+      for (const auto &dimension: *dimension_grid->dimension_set()) {
+        index.write(dimension->name());
+        index.write(dimension->unit());
+        index.write(dimension->description());
+        index.write<uint32_t>(dimension->periodicity());
+        index.write<double>(dimension->period());
+        index.write(dimension_grid->values(idim++));
+      }
+    }
+
+    // PolarNodes, the positions of the values of PolarTables being patched once the index size is known
+    std::vector<std::pair<size_t, std::shared_ptr<PolarTableBase>>> payloads;
+    index.write<uint64_t>(nodes.size());
+    for (const auto &[node, parent]: nodes) {
+      index.write<uint32_t>(node->polar_node_type());
+      index.write<int64_t>(parent);
+      index.write(node->name());
+      index.write(node->description());
+      index.write<uint64_t>(std::distance(node->attributes().begin(), node->attributes().end()));
+      for (const auto &attribute: node->attributes()) {
+        index.write(attribute.first);
+        index.write(attribute.second);
+      }
+
+      switch (node->polar_node_type()) {
+        case POLAR: {
+          auto polar = node->as_polar();
+          index.write<uint32_t>(polar->mode());
+          index.write<uint64_t>(grid_indices.at(polar->dimension_grid().get()));
+          break;
+        }
+        case POLAR_TABLE: {
+          auto polar_table = node->as_polar_table();
+          index.write<uint32_t>(polar_table->type());
+          index.write<uint32_t>(polar_table->interpolation_method());
+          index.write(polar_table->unit());
+          index.write<uint64_t>(grid_indices.at(polar_table->dimension_grid().get()));
+          payloads.emplace_back(index.write<uint64_t>(0), polar_table);
+          index.write<uint64_t>(polar_table->dimension_grid()->size());
+          break;
+        }
+        default:
+          break;
+      }
+    }
+
+    // Layout of the values
+    size_t offset = align(sizeof(Header) + index.buffer().size());
+    std::vector<size_t> offsets;
+    for (const auto &[position, polar_table]: payloads) {
+      index.patch<uint64_t>(position, offset);
+      offsets.push_back(offset);
+      size_t type_size = polar_table->type() == POEM_DOUBLE ? sizeof(double) : sizeof(int);
+      offset = align(offset + polar_table->dimension_grid()->size() * type_size);
+    }
+    size_t file_size = payloads.empty() ? sizeof(Header) + index.buffer().size() : offset;
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      LogCriticalError("Cannot open snapshot {} for writing", filename);
+      CRITICAL_ERROR_POEM
+    }
+
+    // Header written last, with the content hash
+    Header header{};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+
+    ContentHash hash;
+    file.write(index.buffer().data(), (std::streamsize) index.buffer().size());
+    hash.update(index.buffer().data(), index.buffer().size());
+    size_t position = sizeof(Header) + index.buffer().size();
+
+    const std::vector<char> padding(alignment, 0);
+    for (size_t i = 0; i < payloads.size(); ++i) {
+      size_t n_padding = offsets[i] - position;
+      file.write(padding.data(), (std::streamsize) n_padding);
+      hash.update(padding.data(), n_padding);
+
+      const auto &polar_table = payloads[i].second;
+      switch (polar_table->type()) {
+        case POEM_DOUBLE:
+          write_values(file, hash, *polar_table->as_polar_table_double());
+          position = offsets[i] + polar_table->dimension_grid()->size() * sizeof(double);
+          break;
+        case POEM_INT:
+          write_values(file, hash, *polar_table->as_polar_table_int());
+          position = offsets[i] + polar_table->dimension_grid()->size() * sizeof(int);
+          break;
+        default:
+          LogCriticalError("Type not supported");
+          CRITICAL_ERROR_POEM
+      }
+    }
+    file.write(padding.data(), (std::streamsize) (file_size - position));
+    hash.update(padding.data(), file_size - position);
+
+    std::memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+    header.format_version = snapshot_format_version;
+    header.byte_order = byte_order_mark;
+    header.file_size = file_size;
+    header.index_offset = sizeof(Header);
+    header.index_size = index.buffer().size();
+    header.content_hash = hash.value();
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+
+    file.close();
+    if (!file) {
+      LogCriticalError("Failed to write snapshot {}", filename);
+      CRITICAL_ERROR_POEM
+    }
+  }
+
+  std::shared_ptr<PolarNode> load_snapshot(const std::string &filename, bool verify_hash, bool verbose) {
+    if (verbose)
+      LogNormalInfo("Reading snapshot: {}", fs::absolute(filename).string());
+
+    auto start = std::chrono::steady_clock::now();
+    auto mapping = map_file(filename);
+    auto header = read_header(mapping->data, mapping->size, filename);
+
+    if (verify_hash) {
+      ContentHash hash;
+      hash.update(mapping->data + sizeof(Header), mapping->size - sizeof(Header));
+      if (hash.value() != header.content_hash) {
+        LogCriticalError("Snapshot {} is corrupted (content hash mismatch)", filename);
+        CRITICAL_ERROR_POEM
+      }
+    }
+
+    IndexReader index(mapping->data + header.index_offset, header.index_size, filename);
+
+    std::vector<std::shared_ptr<DimensionGrid>> dimension_grids(index.read_count());
+    for (auto &dimension_grid: dimension_grids) {
+      auto ndims = index.read<uint64_t>();
+      std::vector<std::shared_ptr<Dimension>> dimensions;
+      std::vector<std::vector<double>> values;
+      for (size_t idim = 0; idim < ndims; ++idim) {
+        auto name = index.read_string();
+        auto unit = index.read_string();
+        auto description = index.read_string();
+        auto periodicity = (DIMENSION_PERIODICITY) index.read<uint32_t>();
+        auto period = index.read<double>();
+        dimensions.push_back(make_dimension(name, unit, description, periodicity, period));
+        values.push_back(index.read_doubles());
+      }
+      dimension_grid = make_dimension_grid(make_dimension_set(dimensions));
+      for (size_t idim = 0; idim < ndims; ++idim) {
+        dimension_grid->set_values(dimensions[idim]->name(), values[idim]);
+      }
+    }
+
+    auto dimension_grid = [&](uint64_t igrid) {
+      if (igrid >= dimension_grids.size()) {
+        LogCriticalError("Snapshot {} refers to an unknown DimensionGrid", filename);
+        CRITICAL_ERROR_POEM
+      }
+      return dimension_grids[igrid];
+    };
+
+    std::vector<std::shared_ptr<PolarNode>> nodes(index.read_count());
+    for (size_t inode = 0; inode < nodes.size(); ++inode) {
+      auto type = (POLAR_NODE_TYPE) index.read<uint32_t>();
+      auto parent = index.read<int64_t>();
+      auto name = index.read_string();
+      auto description = index.read_string();
+      Attributes attributes;
+      auto n_attributes = index.read<uint64_t>();
+      for (size_t i = 0; i < n_attributes; ++i) {
+        auto key = index.read_string();
+        attributes.add_attribute(key, index.read_string());
+      }
+
+      // Parents come first in pre order
+      if ((parent < 0) != (inode == 0) || parent >= (int64_t) inode ||
+          (parent >= 0 && nodes[parent]->polar_node_type() == POLAR_TABLE)) {
+        LogCriticalError("Snapshot {} has an inconsistent tree", filename);
+        CRITICAL_ERROR_POEM
+      }
+
+      std::shared_ptr<PolarNode> polar_node;
+      switch (type) {
+        case POLAR_NODE:
+          polar_node = make_polar_node(name, description);
+          break;
+
+        case POLAR_SET:
+          polar_node = make_polar_set(name, description);
+          break;
+
+        case POLAR: {
+          auto mode = (POLAR_MODE) index.read<uint32_t>();
+          polar_node = make_polar(name, mode, dimension_grid(index.read<uint64_t>()));
+          polar_node->change_description(description);
+          break;
+        }
+
+        case POLAR_TABLE: {
+          auto datatype = (POEM_DATATYPE) index.read<uint32_t>();
+          auto interpolation_method = (INTERPOLATION_METHOD) index.read<uint32_t>();
+          auto unit = index.read_string();
+          auto dimension_grid_ = dimension_grid(index.read<uint64_t>());
+          auto offset = index.read<uint64_t>();
+          auto size = index.read<uint64_t>();
+
+          std::shared_ptr<PolarTableBase> polar_table;
+          switch (datatype) {
+            case POEM_DOUBLE:
+              polar_table = map_polar_table<double>(name, unit, description, datatype, dimension_grid_,
+                                                    mapping, offset, size, filename);
+              break;
+            case POEM_INT:
+              polar_table = map_polar_table<int>(name, unit, description, datatype, dimension_grid_,
+                                                 mapping, offset, size, filename);
+              break;
+            default:
+              LogCriticalError("In snapshot {}, PolarTable {} has an unknown type", filename, name);
+              CRITICAL_ERROR_POEM
+          }
+          polar_table->set_interpolation_method(interpolation_method);
+          polar_node = polar_table;
+          break;
+        }
+
+        default:
+          LogCriticalError("Snapshot {} has a node of unknown type", filename);
+          CRITICAL_ERROR_POEM
+      }
+
+      polar_node->attributes() = attributes;
+      if (parent >= 0 && type == POLAR_TABLE) {
+        nodes[parent]->add_child(polar_node, false);
+      } else if (parent >= 0) {
+        nodes[parent]->add_child(polar_node);
+      }
+      nodes[inode] = polar_node;
+    }
+
+    if (nodes.empty()) {
+      LogCriticalError("Snapshot {} is empty", filename);
+      CRITICAL_ERROR_POEM
+    }
+
+    if (verbose) {
+      std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+      LogNormalInfo("Snapshot of {} nodes opened in {:.1f} ms", nodes.size(), elapsed.count());
+    }
+
+    MemoryManager::instance().track(nodes.front(), fs::absolute(filename).string());
+
+    return nodes.front();
+  }
+
+  uint64_t snapshot_hash(const std::string &filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+      LogCriticalError("Snapshot file not found: {}", filename);
+      CRITICAL_ERROR_POEM
+    }
+    Header header{};
+    file.read(reinterpret_cast<char *>(&header), sizeof(Header));
+    if (!file) {
+      LogCriticalError("{} is not a POEM snapshot", filename);
+      CRITICAL_ERROR_POEM
+    }
+    read_header(reinterpret_cast<const char *>(&header), (size_t) fs::file_size(filename), filename);
+    return header.content_hash;
+  }
+
+}  // poem
@@ -0,0 +1,54 @@
+#ifndef POEM_SNAPSHOT_H
+#define POEM_SNAPSHOT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace poem {
+
+  // Forward declaration
+  class PolarNode;
+
+  /**
+   * Version of the snapshot format written by to_snapshot
+   */
+  constexpr uint32_t snapshot_format_version = 1;
+
+  /**
+   * Writes the tree starting at polar_node to a POEM binary snapshot, to be opened by load_snapshot
+   *
+   * A snapshot is made for fast restarts of services querying the same files again and again, not for exchange: it is
+   * tied to the byte order of the machine and to the version of the format. It holds:
+   *  - a 64 bytes header: magic "POEMSNAP", format version, byte order mark, file size, index position and a content
+   *  hash of everything after the header,
+   *  - a flat index of the tree, in pre order: DimensionGrids (each shared grid written once), then PolarNodes with
+   *  their type, parent, name, description, attributes, mode, unit, datatype, interpolation method and the position of
+   *  the values of PolarTables,
+   *  - the values of every PolarTable, as raw native arrays aligned on 64 bytes.
+   *
+   * Tables with a JIT loader are fetched for the time of their writing. Conversion is lossless both ways: the snapshot
+   * of a tree given by load opens to an equal tree, which to_netcdf writes back with the same values.
+   */
+  void to_snapshot(std::shared_ptr<PolarNode> polar_node, const std::string &filename);
+
+  /**
+   * Opens a snapshot written by to_snapshot, with PolarTable values read in place from a read only memory mapping of
+   * the file (see PolarTable::bind_values)
+   *
+   * Only the index is parsed: load time depends on the number of nodes and grid values, not on the size of the tables,
+   * pages of values being brought in by the system at first query. The mapping lives as long as a table of the tree.
+   * PolarTable::values() and modifications of a table copy its values into memory (see PolarTable::is_packed).
+   *
+   * @param verify_hash checks the content hash of the file, reading it entirely
+   */
+  std::shared_ptr<PolarNode> load_snapshot(const std::string &filename, bool verify_hash = false, bool verbose = true);
+
+  /**
+   * Content hash recorded in the header of a snapshot, e.g. to know if a cached snapshot is up to date
+   */
+  uint64_t snapshot_hash(const std::string &filename);
+
+}  // poem
+
+#endif //POEM_SNAPSHOT_H
@@ -0,0 +1,255 @@
+#include "Spline.h"
+
+#include <cmath>
+
+#include "exceptions.h"
+#include "DimensionGrid.h"
+
+namespace poem {
+
+  INTERPOLATION_METHOD string_to_interpolation_method(const std::string &method_str) {
+    INTERPOLATION_METHOD method;
+    if (method_str == "linear") {
+      method = LINEAR;
+    } else if (method_str == "cubic") {
+      method = CUBIC;
+    } else if (method_str == "pchip") {
+      method = PCHIP;
+    } else if (method_str == "akima") {
+      method = AKIMA;
+    } else {
+      LogCriticalError("Unknown interpolation method {}. "
+                       "Available values are linear, cubic, pchip or akima", method_str);
+      CRITICAL_ERROR_POEM
+    }
+    return method;
+  }
+
+  std::string interpolation_method_to_string(INTERPOLATION_METHOD method) {
+    std::string method_str;
+    switch (method) {
+      case LINEAR:
+        method_str = "linear";
+        break;
+      case CUBIC:
+        method_str = "cubic";
+        break;
+      case PCHIP:
+        method_str = "pchip";
+        break;
+      case AKIMA:
+        method_str = "akima";
+        break;
+    }
+    return method_str;
+  }
+
+  namespace {
+
+    /**
+     * Natural cubic spline slopes, solving the C2 continuity tridiagonal system with the Thomas algorithm
+     */
+    void cubic_slopes(const double *h, const double *delta, size_t n, double *slopes) {
+      // Natural end conditions: 2 m0 + m1 = 3 delta0 and m(n-2) + 2 m(n-1) = 3 delta(n-2)
+      std::vector<double> c(n);
+      double b = 2.;
+      c[0] = 1. / b;
+      slopes[0] = 3. * delta[0] / b;
+      for (size_t i = 1; i < n; ++i) {
+        double a, d, r;
+        if (i < n - 1) {
+          a = h[i];
+          b = 2. * (h[i - 1] + h[i]);
+          d = h[i - 1];
+          r = 3. * (h[i] * delta[i - 1] + h[i - 1] * delta[i]);
+        } else {
+          a = 1.;
+          b = 2.;
+          d = 0.;
+          r = 3. * delta[n - 2];
+        }
+        double denominator = b - a * c[i - 1];
+        c[i] = d / denominator;
+        slopes[i] = (r - a * slopes[i - 1]) / denominator;
+      }
+      for (size_t i = n - 1; i-- > 0;) {
+        slopes[i] -= c[i] * slopes[i + 1];
+      }
+    }
+
+    /**
+     * End slope of PCHIP, shape preserving three points formula
+     */
+    double pchip_end_slope(double h0, double h1, double delta0, double delta1) {
+      double slope = ((2. * h0 + h1) * delta0 - h0 * delta1) / (h0 + h1);
+      if (std::signbit(slope) != std::signbit(delta0) || slope == 0. || delta0 == 0.) {
+        slope = 0.;
+      } else if (std::signbit(delta0) != std::signbit(delta1) && std::abs(slope) > 3. * std::abs(delta0)) {
+        slope = 3. * delta0;
+      }
+      return slope;
+    }
+
+    /**
+     * Fritsch-Carlson monotone slopes (weighted harmonic mean of the secants, null at local extrema)
+     */
+    void pchip_slopes(const double *h, const double *delta, size_t n, double *slopes) {
+      for (size_t i = 1; i < n - 1; ++i) {
+        if (delta[i - 1] * delta[i] <= 0.) {
+          slopes[i] = 0.;
+        } else {
+          double w1 = 2. * h[i] + h[i - 1];
+          double w2 = h[i] + 2. * h[i - 1];
+          slopes[i] = (w1 + w2) / (w1 / delta[i - 1] + w2 / delta[i]);
+        }
+      }
+      slopes[0] = pchip_end_slope(h[0], h[1], delta[0], delta[1]);
+      slopes[n - 1] = pchip_end_slope(h[n - 2], h[n - 3], delta[n - 2], delta[n - 3]);
+    }
+
+    /**
+     * Akima slopes, secants being extended by two on each side by linear extrapolation
+     */
+    void akima_slopes(const double *delta, size_t n, double *slopes) {
+      // m[i + 2] is the secant delta[i], for i in [-2, n]
+      std::vector<double> m(n + 3);
+      for (size_t i = 0; i < n - 1; ++i) {
+        m[i + 2] = delta[i];
+      }
+      m[1] = 2. * m[2] - m[3];
+      m[0] = 2. * m[1] - m[2];
+      m[n + 1] = 2. * m[n] - m[n - 1];
+      m[n + 2] = 2. * m[n + 1] - m[n];
+
+      for (size_t i = 0; i < n; ++i) {
+        // Slope at node i, between secants m[i + 1] (left) and m[i + 2] (right)
+        double w1 = std::abs(m[i + 3] - m[i + 2]);
+        double w2 = std::abs(m[i + 1] - m[i]);
+        if (w1 + w2 > 0.) {
+          slopes[i] = (w1 * m[i + 1] + w2 * m[i + 2]) / (w1 + w2);
+        } else {
+          slopes[i] = 0.5 * (m[i + 1] + m[i + 2]);
+        }
+      }
+    }
+
+    /**
+     * Slopes along a line of a PERIODIC dimension, the sampling being extended by one period on each side so that the
+     * slopes at both ends account for the values across the seam. The closing value of a closed sampling (last value
+     * = first value + period) is not repeated.
+     */
+    void periodic_spline_slopes(INTERPOLATION_METHOD method,
+                                const double *x,
+                                size_t n,
+                                double period,
+                                bool is_closed,
+                                const double *y,
+                                size_t y_stride,
+                                double *slopes,
+                                size_t slopes_stride) {
+      // Number of distinct nodes in a period
+      const size_t m = is_closed ? n - 1 : n;
+      std::vector<double> x_(2 * m + n);
+      std::vector<double> y_(2 * m + n);
+      for (size_t i = 0; i < m; ++i) {
+        x_[i] = x[i] - period;
+        y_[i] = y[i * y_stride];
+        x_[m + n + i] = x[n - m + i] + period;
+        y_[m + n + i] = y[(n - m + i) * y_stride];
+      }
+      for (size_t i = 0; i < n; ++i) {
+        x_[m + i] = x[i];
+        y_[m + i] = y[i * y_stride];
+      }
+
+      std::vector<double> slopes_(x_.size());
+      spline_slopes(method, x_.data(), x_.size(), y_.data(), 1, slopes_.data(), 1);
+      for (size_t i = 0; i < n; ++i) {
+        slopes[i * slopes_stride] = slopes_[m + i];
+      }
+    }
+
+  }  // namespace
+
+  void spline_slopes(INTERPOLATION_METHOD method,
+                     const double *x,
+                     size_t n,
+                     const double *y,
+                     size_t y_stride,
+                     double *slopes,
+                     size_t slopes_stride) {
+    if (n == 1) {
+      slopes[0] = 0.;
+      return;
+    }
+
+    std::vector<double> h(n - 1);
+    std::vector<double> delta(n - 1);
+    for (size_t i = 0; i < n - 1; ++i) {
+      h[i] = x[i + 1] - x[i];
+      delta[i] = (y[(i + 1) * y_stride] - y[i * y_stride]) / h[i];
+    }
+
+    std::vector<double> slopes_(n);
+    if (n == 2) {
+      slopes_[0] = slopes_[1] = delta[0];
+    } else {
+      switch (method) {
+        case CUBIC:
+          cubic_slopes(h.data(), delta.data(), n, slopes_.data());
+          break;
+        case PCHIP:
+          pchip_slopes(h.data(), delta.data(), n, slopes_.data());
+          break;
+        case AKIMA:
+          akima_slopes(delta.data(), n, slopes_.data());
+          break;
+        case LINEAR:
+          LogCriticalError("No slopes for linear interpolation method");
+          CRITICAL_ERROR_POEM
+      }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+      slopes[i * slopes_stride] = slopes_[i];
+    }
+  }
+
+  void hermite_slopes(INTERPOLATION_METHOD method,
+                      const DimensionGrid &dimension_grid,
+                      const double *values,
+                      size_t stride,
+                      std::vector<double> &slopes) {
+    const size_t ndims = dimension_grid.ndims();
+    const size_t size = dimension_grid.size();
+    slopes.assign(size * ndims, 0.);
+
+    // Row major strides of the grid
+    std::vector<size_t> strides(ndims);
+    for (size_t idim = ndims, stride_ = 1; idim-- > 0;) {
+      strides[idim] = stride_;
+      stride_ *= dimension_grid.values(idim).size();
+    }
+
+    for (size_t idim = 0; idim < ndims; ++idim) {
+      const auto &axis = dimension_grid.values(idim);
+      const size_t n = axis.size();
+      const bool is_periodic = dimension_grid.periodicity(idim) == PERIODIC;
+
+      // Every line along idim starts at a node whose index along idim is 0
+      for (size_t idx = 0; idx < size; ++idx) {
+        if ((idx / strides[idim]) % n != 0) continue;
+        if (is_periodic) {
+          periodic_spline_slopes(method, axis.data(), n, dimension_grid.period(idim), dimension_grid.is_closed(idim),
+                                 values + idx * stride, strides[idim] * stride,
+                                 slopes.data() + idx * ndims + idim, strides[idim] * ndims);
+        } else {
+          spline_slopes(method, axis.data(), n,
+                        values + idx * stride, strides[idim] * stride,
+                        slopes.data() + idx * ndims + idim, strides[idim] * ndims);
+        }
+      }
+    }
+  }
+
+}  // poem
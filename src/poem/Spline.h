@@ -0,0 +1,182 @@
+#ifndef POEM_SPLINE_H
+#define POEM_SPLINE_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace poem {
+
+  // Forward declaration
+  class DimensionGrid;
+
+  /**
+   * Interpolation method of a PolarTable<double>
+   *
+   * Every method other than LINEAR is a tensor product cubic Hermite interpolation. The slopes along each axis are
+   * precomputed once per table with the 1D method, the mixed derivatives being approximated at evaluation by centered
+   * differences of these slopes, so that an evaluation costs a fixed number of operations. They are C1 across cell
+   * boundaries, where LINEAR is C0 only.
+   */
+  enum INTERPOLATION_METHOD {
+    /// Multilinear interpolation
+    LINEAR,
+    /// Natural cubic spline (C2), tensor product
+    CUBIC,
+    /// Monotone piecewise cubic Hermite (Fritsch-Carlson), no overshoot along axes
+    PCHIP,
+    /// Akima slopes, local and with little overshoot near steep changes
+    AKIMA
+  };
+
+  constexpr size_t N_INTERPOLATION_METHODS = 4;
+
+  /**
+   * Maximum number of dimensions supported by the cubic interpolation methods
+   *
+   * Evaluation runs over the 4^ndims coefficients of the cell corners, held on the stack.
+   */
+  constexpr size_t POEM_MAX_SPLINE_DIMS = 6;
+
+  /**
+   * Maximum memory in bytes of the slopes precomputed by a cubic interpolation method for a table, ndims times the
+   * memory of the table (see hermite_slopes)
+   */
+  constexpr size_t POEM_MAX_SPLINE_MEMSIZE = (size_t) 1 << 30;
+
+  INTERPOLATION_METHOD string_to_interpolation_method(const std::string &method_str);
+
+  std::string interpolation_method_to_string(INTERPOLATION_METHOD method);
+
+  /**
+   * Slopes of the 1D interpolation method at the n nodes x of the values y
+   *
+   * y and slopes are read and written with strides (in number of doubles). A single node is given a null slope.
+   */
+  void spline_slopes(INTERPOLATION_METHOD method,
+                     const double *x,
+                     size_t n,
+                     const double *y,
+                     size_t y_stride,
+                     double *slopes,
+                     size_t slopes_stride);
+
+  /**
+   * Slopes of a table along each dimension for a cubic interpolation method
+   *
+   * For every node of the grid, the ndims slopes are stored contiguously: slopes[node * ndims + idim] is the slope
+   * along dimension idim of the line of the table through the node. Along a PERIODIC dimension, the lines are extended
+   * across the seam. Singleton dimensions are given null slopes.
+   *
+   * values are read with stride (see PolarTable::stride).
+   */
+  void hermite_slopes(INTERPOLATION_METHOD method,
+                      const DimensionGrid &dimension_grid,
+                      const double *values,
+                      size_t stride,
+                      std::vector<double> &slopes);
+
+  /**
+   * Cubic Hermite basis at the normalized position t into a cell of width h: weights of the value and of the slope at
+   * the lower node, then of the value and of the slope at the upper node
+   */
+  inline std::array<double, 4> hermite_basis(double t, double h) {
+    double t2 = t * t;
+    double t3 = t2 * t;
+    return {2. * t3 - 3. * t2 + 1., h * (t3 - 2. * t2 + t), -2. * t3 + 3. * t2, h * (t3 - t2)};
+  }
+
+  /**
+   * Derivative of the cubic Hermite basis with respect to the coordinate (not to t). Null for a singleton dimension
+   * (h = 0).
+   */
+  inline std::array<double, 4> hermite_basis_derivative(double t, double h) {
+    if (h == 0.) return {0., 0., 0., 0.};
+    double t2 = t * t;
+    return {(6. * t2 - 6. * t) / h, 3. * t2 - 4. * t + 1., (-6. * t2 + 6. * t) / h, 3. * t2 - 2. * t};
+  }
+
+  /**
+   * Tensor product cubic Hermite combination in a cell, basis[idim] being the basis to apply along dimension idim (see
+   * hermite_basis)
+   *
+   * corners holds the 2^ndims coefficients of each of the 2^ndims corners of the cell (see corner_offsets), coefficient
+   * S (a subset of dimensions, bit idim of S standing for dimension idim) of corner icorner being at
+   * corners[icorner * 2^ndims + S]. It is the mixed derivative of the table along the dimensions of S at the corner, the
+   * coefficient 0 being the value itself. work must hold 4^ndims / 2 values.
+   */
+  inline double hermite_reduce(const double *corners,
+                               const std::array<double, 4> *basis,
+                               size_t ndims,
+                               double *work) {
+    // Successive reduction along dimensions, from the first one, (corner, S) being at index corner * n_subsets + S.
+    // The remaining dimensions after reducing dimension idim are given by the upper bits of the corner and S indices.
+    // The first reduction reads the coefficients of the corners in place.
+    size_t n_subsets = (size_t) 1 << ndims;
+    size_t n_corners = n_subsets;
+    for (size_t idim = 0; idim < ndims; ++idim) {
+      const auto [b00, b01, b10, b11] = basis[idim];
+
+      n_subsets /= 2;
+      n_corners /= 2;
+      const double *source = idim == 0 ? corners : work;
+      for (size_t icorner = 0; icorner < n_corners; ++icorner) {
+        const double *lower = source + (2 * icorner) * (2 * n_subsets);
+        const double *upper = lower + 2 * n_subsets;
+        for (size_t isubset = 0; isubset < n_subsets; ++isubset) {
+          work[icorner * n_subsets + isubset] = b00 * lower[2 * isubset] + b01 * lower[2 * isubset + 1] +
+                                                b10 * upper[2 * isubset] + b11 * upper[2 * isubset + 1];
+        }
+      }
+    }
+    return ndims == 0 ? corners[0] : work[0];
+  }
+
+  /**
+   * Tensor product cubic Hermite evaluation in a cell
+   *
+   * weights are the normalized positions into the cell and widths the widths of the cell along each dimension (see
+   * hermite_reduce for the other arguments).
+   */
+  template<size_t max_dims>
+  inline double hermite(const double *corners,
+                        const double *weights,
+                        const double *widths,
+                        size_t ndims,
+                        double *work) {
+    std::array<std::array<double, 4>, max_dims> basis;
+    for (size_t idim = 0; idim < ndims; ++idim) {
+      basis[idim] = hermite_basis(weights[idim], widths[idim]);
+    }
+    return hermite_reduce(corners, basis.data(), ndims, work);
+  }
+
+  /**
+   * Same as hermite, also giving into gradient the ndims partial derivatives with respect to the coordinates
+   *
+   * Each partial derivative is a reduction of the same coefficients, the basis along its dimension being replaced by
+   * its derivative.
+   */
+  template<size_t max_dims>
+  inline double hermite_gradient(const double *corners,
+                                 const double *weights,
+                                 const double *widths,
+                                 size_t ndims,
+                                 double *work,
+                                 double *gradient) {
+    std::array<std::array<double, 4>, max_dims> basis;
+    for (size_t idim = 0; idim < ndims; ++idim) {
+      basis[idim] = hermite_basis(weights[idim], widths[idim]);
+    }
+    for (size_t idim = 0; idim < ndims; ++idim) {
+      auto basis_ = basis[idim];
+      basis[idim] = hermite_basis_derivative(weights[idim], widths[idim]);
+      gradient[idim] = hermite_reduce(corners, basis.data(), ndims, work);
+      basis[idim] = basis_;
+    }
+    return hermite_reduce(corners, basis.data(), ndims, work);
+  }
+
+}  // poem
+
+#endif //POEM_SPLINE_H
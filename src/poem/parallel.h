@@ -0,0 +1,81 @@
+#ifndef POEM_PARALLEL_H
+#define POEM_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace poem {
+
+  /**
+   * Get the number of threads to use for a parallel operation
+   *
+   * @param n_threads requested number of threads. 0 means one thread per hardware core
+   */
+  inline size_t get_n_threads(size_t n_threads) {
+    if (n_threads == 0) {
+      n_threads = std::thread::hardware_concurrency();
+    }
+    return n_threads == 0 ? 1 : n_threads;
+  }
+
+  /**
+   * Calls func(i) for every i in [0, n) using a pool of n_threads threads
+   *
+   * Indices are distributed dynamically so that unbalanced work items are well spread over the threads. The first
+   * exception thrown by func stops the distribution of new indices and is rethrown in the calling thread once every
+   * thread has been joined.
+   *
+   * @param n number of work items
+   * @param func callable taking a size_t index
+   * @param n_threads number of threads. 0 means one thread per hardware core
+   */
+  template<class Func>
+  void parallel_for(size_t n, Func &&func, size_t n_threads = 0) {
+    n_threads = std::min(get_n_threads(n_threads), n);
+
+    if (n_threads <= 1) {
+      for (size_t i = 0; i < n; ++i) {
+        func(i);
+      }
+      return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+
+    auto worker = [&]() {
+      size_t i;
+      while ((i = next.fetch_add(1)) < n) {
+        try {
+          func(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(exception_mutex);
+          if (!exception) exception = std::current_exception();
+          next = n;
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads - 1);
+    for (size_t ithread = 1; ithread < n_threads; ++ithread) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread: threads) {
+      thread.join();
+    }
+
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+}  // poem
+
+#endif //POEM_PARALLEL_H
@@ -10,11 +10,21 @@
 #include "Dimension.h"
 #include "DimensionSet.h"
 #include "DimensionGrid.h"
+#include "OutOfBound.h"
+#include "Spline.h"
 #include "PolarTable.h"
 #include "Polar.h"
+#include "PolarConversion.h"
+#include "PolarQuery.h"
+#include "PolarCurve.h"
+#include "QueryCache.h"
+#include "simd.h"
 #include "PolarSet.h"
+#include "PolarSetQuery.h"
+#include "MemoryManager.h"
 #include "PolarNode.h"
 #include "IO.h"
+#include "Snapshot.h"
 #include "Splitter.h"
 #include "specifications/specs.h"
 
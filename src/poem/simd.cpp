@@ -0,0 +1,204 @@
+// Bit identity with the scalar kernel requires that no multiply-add is fused, which the compiler could otherwise do
+// on vector operations once FMA is enabled by the target attributes
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#include <array>
+#include <atomic>
+
+#include "simd.h"
+#include "Interpolator.h"
+#include "exceptions.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define POEM_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace poem {
+
+  namespace {
+
+    constexpr size_t max_corners = 1 << POEM_MAX_DIMS;
+
+    void multilinear_batch_scalar(const double *values, const size_t *steps, size_t ndims, size_t n_points,
+                                  const size_t *offsets, const double *const *weights, double *results) {
+      std::array<size_t, max_corners> corners_offsets;
+      std::array<double, POEM_MAX_DIMS> point_weights;
+      for (size_t ipoint = 0; ipoint < n_points; ++ipoint) {
+        corner_offsets(offsets[ipoint], steps, ndims, corners_offsets.data());
+        for (size_t idim = 0; idim < ndims; ++idim) {
+          point_weights[idim] = weights[idim][ipoint];
+        }
+        results[ipoint] = multilinear<double, max_corners>(values, 1, corners_offsets.data(), point_weights.data(),
+                                                           ndims);
+      }
+    }
+
+#ifdef POEM_SIMD_X86
+
+    __attribute__((target("avx2")))
+    void multilinear_batch_avx2(const double *values, const size_t *steps, size_t ndims, size_t n_points,
+                                const size_t *offsets, const double *const *weights, double *results) {
+      constexpr size_t width = 4;
+      const size_t n_corners = (size_t) 1 << ndims;
+
+      // Corner offsets relative to the lower corner, the same for every point
+      std::array<size_t, max_corners> deltas;
+      corner_offsets(0, steps, ndims, deltas.data());
+
+      std::array<__m256d, max_corners> corners;
+      size_t ipoint = 0;
+      for (; ipoint + width <= n_points; ipoint += width) {
+        __m256i base = _mm256_loadu_si256((const __m256i *) (offsets + ipoint));
+        for (size_t icorner = 0; icorner < n_corners; ++icorner) {
+          __m256i index = _mm256_add_epi64(base, _mm256_set1_epi64x((long long) deltas[icorner]));
+          corners[icorner] = _mm256_i64gather_pd(values, index, 8);
+        }
+
+        for (size_t idim = 0, n = n_corners / 2; idim < ndims; ++idim, n /= 2) {
+          __m256d weight = _mm256_loadu_pd(weights[idim] + ipoint);
+          for (size_t icorner = 0; icorner < n; ++icorner) {
+            __m256d lower = corners[2 * icorner];
+            __m256d delta = _mm256_sub_pd(corners[2 * icorner + 1], lower);
+            corners[icorner] = _mm256_add_pd(lower, _mm256_mul_pd(weight, delta));
+          }
+        }
+        _mm256_storeu_pd(results + ipoint, corners[0]);
+      }
+
+      // Remaining points
+      std::array<const double *, POEM_MAX_DIMS> remaining_weights;
+      for (size_t idim = 0; idim < ndims; ++idim) {
+        remaining_weights[idim] = weights[idim] + ipoint;
+      }
+      multilinear_batch_scalar(values, steps, ndims, n_points - ipoint, offsets + ipoint, remaining_weights.data(),
+                               results + ipoint);
+    }
+
+    __attribute__((target("avx512f")))
+    void multilinear_batch_avx512(const double *values, const size_t *steps, size_t ndims, size_t n_points,
+                                  const size_t *offsets, const double *const *weights, double *results) {
+      constexpr size_t width = 8;
+      const size_t n_corners = (size_t) 1 << ndims;
+
+      std::array<size_t, max_corners> deltas;
+      corner_offsets(0, steps, ndims, deltas.data());
+
+      std::array<__m512d, max_corners> corners;
+      size_t ipoint = 0;
+      for (; ipoint + width <= n_points; ipoint += width) {
+        __m512i base = _mm512_loadu_si512((const void *) (offsets + ipoint));
+        for (size_t icorner = 0; icorner < n_corners; ++icorner) {
+          __m512i index = _mm512_add_epi64(base, _mm512_set1_epi64((long long) deltas[icorner]));
+          corners[icorner] = _mm512_i64gather_pd(index, values, 8);
+        }
+
+        for (size_t idim = 0, n = n_corners / 2; idim < ndims; ++idim, n /= 2) {
+          __m512d weight = _mm512_loadu_pd(weights[idim] + ipoint);
+          for (size_t icorner = 0; icorner < n; ++icorner) {
+            __m512d lower = corners[2 * icorner];
+            __m512d delta = _mm512_sub_pd(corners[2 * icorner + 1], lower);
+            corners[icorner] = _mm512_add_pd(lower, _mm512_mul_pd(weight, delta));
+          }
+        }
+        _mm512_storeu_pd(results + ipoint, corners[0]);
+      }
+
+      std::array<const double *, POEM_MAX_DIMS> remaining_weights;
+      for (size_t idim = 0; idim < ndims; ++idim) {
+        remaining_weights[idim] = weights[idim] + ipoint;
+      }
+      multilinear_batch_scalar(values, steps, ndims, n_points - ipoint, offsets + ipoint, remaining_weights.data(),
+                               results + ipoint);
+    }
+
+#endif  // POEM_SIMD_X86
+
+    std::atomic<SIMD_INSTRUCTION_SET> &current_instruction_set() {
+      static std::atomic<SIMD_INSTRUCTION_SET> instruction_set(simd_detected_instruction_set());
+      return instruction_set;
+    }
+
+  }  // namespace
+
+  std::string simd_instruction_set_to_string(SIMD_INSTRUCTION_SET instruction_set) {
+    std::string str;
+    switch (instruction_set) {
+      case SIMD_SCALAR:
+        str = "scalar";
+        break;
+      case SIMD_AVX2:
+        str = "avx2";
+        break;
+      case SIMD_AVX512:
+        str = "avx512";
+        break;
+    }
+    return str;
+  }
+
+  bool simd_supported(SIMD_INSTRUCTION_SET instruction_set) {
+    bool supported = false;
+    switch (instruction_set) {
+      case SIMD_SCALAR:
+        supported = true;
+        break;
+#ifdef POEM_SIMD_X86
+      case SIMD_AVX2:
+        supported = __builtin_cpu_supports("avx2");
+        break;
+      case SIMD_AVX512:
+        supported = __builtin_cpu_supports("avx512f");
+        break;
+#endif
+      default:
+        break;
+    }
+    return supported;
+  }
+
+  SIMD_INSTRUCTION_SET simd_detected_instruction_set() {
+    static const SIMD_INSTRUCTION_SET detected = simd_supported(SIMD_AVX512) ? SIMD_AVX512 :
+                                                 simd_supported(SIMD_AVX2) ? SIMD_AVX2 : SIMD_SCALAR;
+    return detected;
+  }
+
+  SIMD_INSTRUCTION_SET simd_instruction_set() {
+    return current_instruction_set().load(std::memory_order_relaxed);
+  }
+
+  void set_simd_instruction_set(SIMD_INSTRUCTION_SET instruction_set) {
+    if (!simd_supported(instruction_set)) {
+      LogCriticalError("Instruction set {} is not supported by the CPU",
+                       simd_instruction_set_to_string(instruction_set));
+      CRITICAL_ERROR_POEM
+    }
+    current_instruction_set().store(instruction_set, std::memory_order_relaxed);
+  }
+
+  void multilinear_batch(const double *values,
+                         const size_t *steps,
+                         size_t ndims,
+                         size_t n_points,
+                         const size_t *offsets,
+                         const double *const *weights,
+                         double *results) {
+    switch (simd_instruction_set()) {
+#ifdef POEM_SIMD_X86
+      case SIMD_AVX512:
+        multilinear_batch_avx512(values, steps, ndims, n_points, offsets, weights, results);
+        break;
+      case SIMD_AVX2:
+        multilinear_batch_avx2(values, steps, ndims, n_points, offsets, weights, results);
+        break;
+#endif
+      default:
+        multilinear_batch_scalar(values, steps, ndims, n_points, offsets, weights, results);
+    }
+  }
+
+}  // poem
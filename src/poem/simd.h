@@ -0,0 +1,66 @@
+#ifndef POEM_SIMD_H
+#define POEM_SIMD_H
+
+#include <cstddef>
+#include <string>
+
+namespace poem {
+
+  /**
+   * Instruction sets available for the batched multilinear kernel
+   */
+  enum SIMD_INSTRUCTION_SET {
+    /// Portable scalar kernel
+    SIMD_SCALAR,
+    /// 4 query points per instruction
+    SIMD_AVX2,
+    /// 8 query points per instruction
+    SIMD_AVX512
+  };
+
+  std::string simd_instruction_set_to_string(SIMD_INSTRUCTION_SET instruction_set);
+
+  /**
+   * Tells if the running CPU (and the build) supports instruction_set
+   */
+  bool simd_supported(SIMD_INSTRUCTION_SET instruction_set);
+
+  /**
+   * Best instruction set supported by the running CPU, detected at first call
+   */
+  SIMD_INSTRUCTION_SET simd_detected_instruction_set();
+
+  /**
+   * Instruction set used by the batched multilinear kernel. Defaults to simd_detected_instruction_set().
+   */
+  SIMD_INSTRUCTION_SET simd_instruction_set();
+
+  /**
+   * Forces the instruction set used by the batched multilinear kernel (tests and benchmarks). It must be supported by
+   * the running CPU.
+   */
+  void set_simd_instruction_set(SIMD_INSTRUCTION_SET instruction_set);
+
+  /**
+   * Batched multilinear combination of the 2^ndims corners of n_points cells
+   *
+   * Every offset is given in number of elements of values (data strides included):
+   *  - offsets[ipoint] is the position of the lower corner of the cell of point ipoint,
+   *  - steps[idim] is the distance between the lower and the upper corners along dimension idim.
+   * weights[idim][ipoint] is the normalized position of point ipoint into its cell along dimension idim.
+   *
+   * Vector kernels process several points per instruction, corners being loaded with gathers. They use the same
+   * operations in the same order as multilinear (without fused multiply-add), so that results are bit identical to
+   * the scalar kernel.
+   */
+  void multilinear_batch(const double *values,
+                         const size_t *steps,
+                         size_t ndims,
+                         size_t n_points,
+                         const size_t *offsets,
+                         const double *const *weights,
+                         double *results);
+
+}  // poem
+
+#endif //POEM_SIMD_H
@@ -4,10 +4,12 @@
 
 #include "spec_v1.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <dunits/dunits.h>
 
 #include "poem/exceptions.h"
+#include "poem/IO.h"
 #include "semver/semver.hpp"
 
 namespace fs = std::filesystem;
@@ -89,38 +91,6 @@ namespace poem::v1 {
         rule, rule);
   }
 
-  template<class T>
-  inline bool is_poem_object(const T &object) {
-    return object.getAtts().contains("POEM_NODE_TYPE");
-  }
-
-  template<class T>
-  inline std::string get_attribute(const T &object, const std::string &att_name) {
-    // Warning, check of existence of attribute must be done outside of this function
-    std::string att;
-    object.getAtt(att_name).getValues(att);
-    return att;
-  }
-
-  bool has_at_least_one_polar(const netCDF::NcGroup &group) {
-    bool has_polar = false;
-    if (is_poem_object(group)) {
-      auto node_type = get_attribute(group, "POEM_NODE_TYPE");
-      if (node_type == "POLAR") {
-        has_polar = true;
-      }
-    }
-    // Keep searching
-    if (!has_polar) {
-      for (const auto &group_: group.getGroups()) {
-        has_polar = has_at_least_one_polar(group_.second);
-        if (has_polar) break;
-      }
-    }
-
-    return has_polar;
-  }
-
   inline std::string group_name(const netCDF::NcGroup &group) {
     std::string group_name;
     if (group.isRootGroup()) {
@@ -132,506 +102,484 @@ namespace poem::v1 {
   }
 
 
-  bool check_R1(const netCDF::NcGroup &group) {
-    bool compliant = true;
+  // ===================================================================================================================
+  // METADATA AND RULES CHECKING
+  // ===================================================================================================================
 
-    if (group.getAtts().contains("POEM_NODE_TYPE")) {
+  std::string VariableMetadata::attribute(const std::string &name) const {
+    auto it = attributes.find(name);
+    return it == attributes.end() ? std::string() : it->second;
+  }
 
-      // Parent of this group MUST be a POEM group
-      if (!group.isRootGroup()) {
-        if (!is_poem_object(group.getParentGroup())) {
-          LogWarningError("In group {}, POEM_NODE_TYPE attribute found but not in parent group."
-                          "Continuous POEM group is mandatory",
-                          group_name(group));
-          compliant = false;
-        }
+  const std::vector<double> &VariableMetadata::values() const {
+    if (!m_values_read) {
+      m_values_read = true;
+      bool is_numerical = type != netCDF::NcType::nc_CHAR && type != netCDF::NcType::nc_STRING &&
+                          type <= netCDF::NcType::nc_DOUBLE;
+      if (is_coord_var && shape.size() == 1 && is_numerical) {
+        m_values.resize(shape.front());
+        nc_var.getVar(m_values.data());
       }
+    }
+    return m_values;
+  }
 
-      // Check group POEM_NODE_TYPE value
-      std::string node_type = get_attribute(group, "POEM_NODE_TYPE");
-      if (std::find(known_poem_node_types_groups.begin(), known_poem_node_types_groups.end(), node_type) ==
-          known_poem_node_types_groups.end()) {
-        LogWarningError("In group {}, POEM_NODE_TYPE attribute found but with bad value. "
-                        "Excepted on of POLAR_NODE, POLAR_SET or POLAR. Found {}",
-                        group_name(group), node_type);
-        compliant = false;
-      }
+  std::string GroupMetadata::attribute(const std::string &name) const {
+    auto it = attributes.find(name);
+    return it == attributes.end() ? std::string() : it->second;
+  }
 
-      // Variables
-      for (const auto &nc_var: group.getVars()) {
-        if (is_poem_object(nc_var.second)) {
-          // Check that PolarTable and Dimension are in a Polar group
-          if (node_type !=
-              "POLAR") { // TODO: ajouter cette règle (pas de PolarTable ou Dimension in group other thant Polar)
-            LogWarningError("In group {}, found Variable with attribute POEM_NODE_TYPE set to {}, "
-                            "but group is not a POLAR.");
-            compliant = false;
-          }
+  const VariableMetadata *GroupMetadata::variable(const std::string &name) const {
+    for (const auto &variable: variables) {
+      if (variable.name == name) return &variable;
+    }
+    return nullptr;
+  }
 
-          // Check Dimension and PolarTable POEM_NODE_TYPE value
-          std::string var_node_type = get_attribute(nc_var.second, "POEM_NODE_TYPE");
-          if (group.getCoordVars().contains(nc_var.second.getName())) {
-            if (var_node_type != "POLAR_DIMENSION") {
-              LogWarningError("In group {}, Coordinate Variable {} seen as a Dimension has incorrect "
-                              "POEM_NODE_TYPE attribute. Expected POLAR_DIMENSION, found {}.",
-                              group_name(group), nc_var.second.getName(), var_node_type);
-              compliant = false;
-            }
-          } else {
-            if (var_node_type != "POLAR_TABLE") {
-              LogWarningError("In group {}, Variable {} seen as a PolarTable has incorrect "
-                              "POEM_NODE_TYPE attribute. Expected POLAR_TABLE, found {}",
-                              group_name(group), nc_var.second.getName(), var_node_type);
-              compliant = false;
-            }
+  namespace {
+
+    /**
+     * Reads attributes according to their type: text attributes into attributes, numerical attributes of one value into
+     * numerical_attributes if not null. Other attributes are skipped.
+     */
+    template<class Atts>
+    void read_typed_attributes(const Atts &atts,
+                               std::map<std::string, std::string> &attributes,
+                               std::map<std::string, double> *numerical_attributes) {
+      for (const auto &[name, att]: atts) {
+        switch (att.getType().getTypeClass()) {
+          case netCDF::NcType::nc_CHAR:
+          case netCDF::NcType::nc_STRING: {
+            std::string value;
+            att.getValues(value);
+            attributes[name] = value;
+            break;
           }
+          case netCDF::NcType::nc_BYTE:
+          case netCDF::NcType::nc_UBYTE:
+          case netCDF::NcType::nc_SHORT:
+          case netCDF::NcType::nc_USHORT:
+          case netCDF::NcType::nc_INT:
+          case netCDF::NcType::nc_UINT:
+          case netCDF::NcType::nc_INT64:
+          case netCDF::NcType::nc_UINT64:
+          case netCDF::NcType::nc_FLOAT:
+          case netCDF::NcType::nc_DOUBLE:
+            if (numerical_attributes && att.getAttLength() == 1) {
+              double value;
+              att.getValues(&value);
+              (*numerical_attributes)[name] = value;
+            }
+            break;
+          default:
+            break;
         }
       }
     }
 
-    for (const auto &group_: group.getGroups()) {
-      compliant &= check_R1(group_.second);
+    bool has_at_least_one_polar(const GroupMetadata &group) {
+      if (group.is_poem_object() && group.attribute("POEM_NODE_TYPE") == "POLAR") return true;
+      return std::any_of(group.groups.begin(), group.groups.end(),
+                         [](const GroupMetadata &group_) { return has_at_least_one_polar(group_); });
     }
 
-    return compliant;
-  }
-
-  bool check_R2(const netCDF::NcGroup &group) { // TODO: verifier
+    void check_R1(const GroupMetadata &group, const GroupScope &scope, std::vector<Violation> &violations) {
+      if (!group.is_poem_object()) return;
 
-    bool compliant = true;
-
-    if (!group.isRootGroup()) {
-      LogCriticalError("check_R2 function is expecting root group");
-      CRITICAL_ERROR_POEM
-    }
+      if (!group.is_root && !scope.parent_is_poem) {
+        violations.push_back({1, group.path, "", fmt::format(
+            "In group {}, POEM_NODE_TYPE attribute found but not in parent group. "
+            "Continuous POEM group is mandatory", group.path)});
+      }
 
-    // Root group mandatory attribute POEM_SPECIFICATION_VERSION
-    if (group.getAtts().contains("POEM_SPECIFICATION_VERSION")) {
-      std::string version_str = get_attribute(group, "POEM_SPECIFICATION_VERSION");
-      int version = (int) semver::version::parse(version_str, false).major();
-      if (version != 1) {
-        LogWarningError("In root group, POEM_SPECIFICATION_VERSION attribute found but version number is {}."
-                        "Version expected to check against is 1",
-                        version);
-        compliant = false;
+      auto node_type = group.attribute("POEM_NODE_TYPE");
+      if (std::find(known_poem_node_types_groups.begin(), known_poem_node_types_groups.end(), node_type) ==
+          known_poem_node_types_groups.end()) {
+        violations.push_back({1, group.path, "", fmt::format(
+            "In group {}, POEM_NODE_TYPE attribute found but with bad value. "
+            "Excepted on of POLAR_NODE, POLAR_SET or POLAR. Found {}", group.path, node_type)});
       }
-    } else {
-      LogWarningError("In root group, POEM_SPECIFICATION_VERSION attribute not found.");
-      compliant = false;
-    }
 
-    // Root group mandatory attribute VESSEL_NAME
-    if (!group.getAtts().contains("VESSEL_NAME")) {
-      LogWarningError("In root group, VESSEL_NAME attribute not found");
-      compliant = false;
-    }
+      for (const auto &variable: group.variables) {
+        if (!variable.is_poem_object()) continue;
+        auto var_node_type = variable.attribute("POEM_NODE_TYPE");
+
+        if (node_type != "POLAR") {
+          violations.push_back({1, group.path, variable.name, fmt::format(
+              "In group {}, found Variable {} with attribute POEM_NODE_TYPE set to {}, but group is not a POLAR.",
+              group.path, variable.name, var_node_type)});
+        }
 
-    // Root group mandatory attribute POEM_NODE_TYPE
-    if (!group.getAtts().contains("POEM_NODE_TYPE")) {
-      LogWarningError("In root group, POEM_NODE_TYPE attribute not found");
-      compliant = false;
+        if (variable.is_coord_var) {
+          if (var_node_type != "POLAR_DIMENSION") {
+            violations.push_back({1, group.path, variable.name, fmt::format(
+                "In group {}, Coordinate Variable {} seen as a Dimension has incorrect "
+                "POEM_NODE_TYPE attribute. Expected POLAR_DIMENSION, found {}.",
+                group.path, variable.name, var_node_type)});
+          }
+        } else if (var_node_type != "POLAR_TABLE") {
+          violations.push_back({1, group.path, variable.name, fmt::format(
+              "In group {}, Variable {} seen as a PolarTable has incorrect "
+              "POEM_NODE_TYPE attribute. Expected POLAR_TABLE, found {}",
+              group.path, variable.name, var_node_type)});
+        }
+      }
     }
 
-    return compliant;
-  }
+    void check_R2(const GroupMetadata &group, std::vector<Violation> &violations) {
+      if (!group.is_root) return;
+
+      if (group.attributes.contains("POEM_SPECIFICATION_VERSION")) {
+        auto version_str = group.attribute("POEM_SPECIFICATION_VERSION");
+        int version = -1;
+        try {
+          version = (int) semver::version::parse(version_str, false).major();
+        } catch (const std::exception &) {
+          violations.push_back({2, group.path, "", fmt::format(
+              "In root group, POEM_SPECIFICATION_VERSION attribute {} is not a valid version", version_str)});
+        }
+        if (version >= 0 && version != 1) {
+          violations.push_back({2, group.path, "", fmt::format(
+              "In root group, POEM_SPECIFICATION_VERSION attribute found but version number is {}. "
+              "Version expected to check against is 1", version)});
+        }
+      } else {
+        violations.push_back({2, group.path, "", "In root group, POEM_SPECIFICATION_VERSION attribute not found."});
+      }
 
-  bool check_R3(const netCDF::NcGroup &group) {
+      if (!group.attributes.contains("VESSEL_NAME")) {
+        violations.push_back({2, group.path, "", "In root group, VESSEL_NAME attribute not found"});
+      }
 
-    bool compliant = true;
+      if (!group.attributes.contains("POEM_NODE_TYPE")) {
+        violations.push_back({2, group.path, "", "In root group, POEM_NODE_TYPE attribute not found"});
+      }
+    }
 
-    if (is_poem_object(group)) {
-      std::string node_type = get_attribute(group, "POEM_NODE_TYPE");
+    void check_R3(const GroupMetadata &group, const GroupScope &scope, std::vector<Violation> &violations) {
+      if (scope.poem_chain) {
+        auto node_type = group.attribute("POEM_NODE_TYPE");
 
-      // A PolarSet ALWAYS owns at least a Polar -> TODO: changer la regle en un PolarSet ne doit contenir que des Polar
-      if (node_type == "POLAR_SET") {
-        bool has_polar = false;
-        for (const auto &group_: group.getGroups()) {
-          if (is_poem_object(group_.second)) {
+        if (node_type == "POLAR_SET") {
+          bool has_polar = false;
+          for (const auto &group_: group.groups) {
+            if (!group_.is_poem_object()) continue;
             has_polar = true;
-
-            // A subgroup of a PolarSet MUST be a Polar
-            auto node_type_ = get_attribute(group_.second, "POEM_NODE_TYPE");
+            auto node_type_ = group_.attribute("POEM_NODE_TYPE");
             if (node_type_ != "POLAR") {
-              LogWarningError("In group {} seen as a PolarSet, POEM subgroups must be of type Polar. "
-                              "Found subgroup {} of type {}",
-                              group_name(group), group_.second.getName(true), node_type_);
-              compliant = false;
+              violations.push_back({3, group.path, "", fmt::format(
+                  "In group {} seen as a PolarSet, POEM subgroups must be of type Polar. "
+                  "Found subgroup {} of type {}", group.path, group_.path, node_type_)});
             }
           }
+          if (!has_polar) {
+            violations.push_back({3, group.path, "", fmt::format(
+                "In group {} seen as a PolarSet, no Polar subgroup found", group.path)});
+          }
         }
-        if (!has_polar) {
-          LogWarningError("In group {} seen as a PolarSet, no Polar subgroup found", group_name(group));
-          compliant = false;
-        }
-      }
 
-      // A Polar ALWAYS owns at least a PolarTable with associated Dimensions
-      if (node_type == "POLAR") {
-        bool has_polar_table = false;
-        std::vector<netCDF::NcDim> dims;
-        std::string table_ref_name;
-        for (const auto &nc_var: group.getVars()) {
-          if (!group.getCoordVars().contains(nc_var.second.getName()) &&
-              is_poem_object(nc_var.second)) {
-            // This is a Variable representing a PolarTable
-
-            // First PolarTable found, registering its name and dimensions for later comparison
-            if (!has_polar_table) {
-              dims = nc_var.second.getDims();
-              table_ref_name = nc_var.first;
-              has_polar_table = true;
-
-              // Check that Dimensions are well present into the group
-              for (const auto &dim: dims) {
-                if (!group.getCoordVars().contains(dim.getName())) {
-                  LogWarningError("In group {}, PolarTable {}'s Dimension {} not found in the group",
-                                  group_name(group), nc_var.first, dim.getName());
-                  compliant = false;
+        if (node_type == "POLAR") {
+          const VariableMetadata *reference = nullptr;
+          for (const auto &variable: group.variables) {
+            if (variable.is_coord_var || !variable.is_poem_object()) continue;
+
+            if (!reference) {
+              reference = &variable;
+              for (const auto &dimension: variable.dimensions) {
+                auto coord_var = group.variable(dimension);
+                if (!coord_var || !coord_var->is_coord_var) {
+                  violations.push_back({3, group.path, variable.name, fmt::format(
+                      "In group {}, PolarTable {}'s Dimension {} not found in the group",
+                      group.path, variable.name, dimension)});
                 }
               }
             }
 
-            // Check Dimension consistency against ref PolarTable
-            auto dims_ = nc_var.second.getDims();
-            if (dims_ != dims) {
-              LogWarningError("In group {}, enclosed PolarTables {} and {} have inconsistent "
-                              "Dimensions definitions",
-                              group_name(group), table_ref_name, nc_var.second.getName());
-              compliant = false;
+            if (variable.dimensions != reference->dimensions) {
+              violations.push_back({3, group.path, variable.name, fmt::format(
+                  "In group {}, enclosed PolarTables {} and {} have inconsistent Dimensions definitions",
+                  group.path, reference->name, variable.name)});
             }
           }
-        }
-        if (!has_polar_table) {
-          LogWarningError("In group {}, seen as a Polar, no PolarTable found", group_name(group));
-          compliant = false;
+          if (!reference) {
+            violations.push_back({3, group.path, "", fmt::format(
+                "In group {}, seen as a Polar, no PolarTable found", group.path)});
+          }
         }
       }
 
-      // Iterating on subgroups
-      for (const auto &group_: group.getGroups()) {
-        compliant &= check_R3(group_.second);
-      }
-
-    }
-
-    if (group.isRootGroup()) {
-      // Checking that we have at least one Polar in the file
-      if (!has_at_least_one_polar(group)) {
-        LogWarningError("No Polar found in the file");
-        compliant = false;
+      if (group.is_root && !has_at_least_one_polar(group)) {
+        violations.push_back({3, group.path, "", "No Polar found in the file"});
       }
     }
 
-    return compliant;
-  }
-
-  bool check_R4(const netCDF::NcGroup &group) {
-    bool compliant = true;
-
-    if (is_poem_object(group)) {
-      auto node_type = get_attribute(group, "POEM_NODE_TYPE");
-      if (node_type == "POLAR") {
-
-        if (group.getAtts().contains("POEM_MODE")) {
+    void check_R4(const GroupMetadata &group, const GroupScope &scope, std::vector<Violation> &violations) {
+      if (!scope.poem_chain) return;
+      if (group.attribute("POEM_NODE_TYPE") != "POLAR") return;
 
-          auto poem_mode = get_attribute(group, "POEM_MODE");
-          if (std::find(known_polar_modes.begin(), known_polar_modes.end(), poem_mode) == known_polar_modes.end()) {
-            LogWarningError("In group {}, seen as a Polar, POEM_MODE attribute is not valid. "
-                            "Expected either MPPP, HPPP, MVPP, HVPP or VPP. Found {}",
-                            group_name(group), poem_mode);
-            compliant = false;
-          }
-
-          if (!group.isRootGroup()) {
-            // group name must equal to POEM_MODE
-            if (group.getName() != poem_mode) {
-              LogWarningError("In group {}, seen as a Polar and not a root group, group name MUST be "
-                              "the same as underlying POEM_MODE attribute. Expected {}, found {}",
-                              group_name(group), poem_mode, group.getName());
-              compliant = false;
-            }
-          }
-        } else {
-          LogWarningError("In group {}, seen as a Polar, attribute POEM_MODE not found",
-                          group_name(group));
-          compliant = false;
-        }
+      if (!group.attributes.contains("POEM_MODE")) {
+        violations.push_back({4, group.path, "", fmt::format(
+            "In group {}, seen as a Polar, attribute POEM_MODE not found", group.path)});
+        return;
+      }
 
+      auto poem_mode = group.attribute("POEM_MODE");
+      if (std::find(known_polar_modes.begin(), known_polar_modes.end(), poem_mode) == known_polar_modes.end()) {
+        violations.push_back({4, group.path, "", fmt::format(
+            "In group {}, seen as a Polar, POEM_MODE attribute is not valid. "
+            "Expected either MPPP, HPPP, MVPP, HVPP or VPP. Found {}", group.path, poem_mode)});
       }
 
-      // Iterating on subgroups
-      for (const auto &group_: group.getGroups()) {
-        compliant &= check_R4(group_.second);
+      if (!group.is_root && group.name != poem_mode) {
+        violations.push_back({4, group.path, "", fmt::format(
+            "In group {}, seen as a Polar and not a root group, group name MUST be "
+            "the same as underlying POEM_MODE attribute. Expected {}, found {}",
+            group.path, poem_mode, group.name)});
       }
     }
 
-    return compliant;
-  }
-
-  bool check_R5(const netCDF::NcGroup &group) {
-    bool compliant = true;
+    void check_R5(const GroupMetadata &group, const GroupScope &scope, std::vector<Violation> &violations) {
+      if (!scope.poem_chain || scope.below_polar) return;
 
-    if (is_poem_object(group)) {
-      if (!group.getAtts().contains("description")) {
-        LogWarningError("Group {} does not have a description attribute", group_name(group));
-        compliant = false;
+      if (!group.attributes.contains("description")) {
+        violations.push_back({5, group.path, "", fmt::format(
+            "Group {} does not have a description attribute", group.path)});
       }
 
-      auto node_type = get_attribute(group, "POEM_NODE_TYPE");
-      if (node_type == "POLAR") {
-        for (const auto nc_var: group.getVars()) {
-          if (is_poem_object(nc_var.second)) {
-            if (!nc_var.second.getAtts().contains("unit")) {
-              LogWarningError("In group {}, Variable {} doe not have unit attribute",
-                              group_name(group), nc_var.first);
-              compliant = false;
-            }
-            if (!nc_var.second.getAtts().contains("description")) {
-              LogWarningError("In group {}, Variable {} doe not have description attribute",
-                              group_name(group), nc_var.first);
-              compliant = false;
-            }
-          }
+      if (group.attribute("POEM_NODE_TYPE") != "POLAR") return;
+      for (const auto &variable: group.variables) {
+        if (!variable.is_poem_object()) continue;
+        if (!variable.attributes.contains("unit")) {
+          violations.push_back({5, group.path, variable.name, fmt::format(
+              "In group {}, Variable {} does not have unit attribute", group.path, variable.name)});
+        }
+        if (!variable.attributes.contains("description")) {
+          violations.push_back({5, group.path, variable.name, fmt::format(
+              "In group {}, Variable {} does not have description attribute", group.path, variable.name)});
         }
-
-        return compliant;
-      }
-
-      // Iterating on subgroups
-      for (const auto &group_: group.getGroups()) {
-        compliant &= check_R5(group_.second);
       }
-
     }
 
-    return compliant;
-  }
+    void check_R6(const GroupMetadata &group, const GroupScope &scope, std::vector<Violation> &violations) {
+      if (!scope.poem_chain || scope.below_polar) return;
+      if (group.attribute("POEM_NODE_TYPE") != "POLAR") return;
 
-  bool check_R6(const netCDF::NcGroup &group) {
-    bool compliant = true;
-
-    if (is_poem_object(group)) {
-      auto node_type = get_attribute(group, "POEM_NODE_TYPE");
-      if (node_type == "POLAR") {
-        for (const auto &coord_var: group.getCoordVars()) {
-          auto var = group.getVar(coord_var.first);
-          if (!is_poem_object(var)) continue;
-
-          std::vector<double> values(var.getDim(0).getSize());
-          var.getVar(values.data());
-          double front_value = values.front();
-
-          // Positive values
-          if (front_value < 0.) {
-            LogWarningError("In group {}, values for Dimension {} MUST be positive. Found {}",
-                            group_name(group), var.getName(), front_value);
-            compliant = false;
-          }
+      for (const auto &variable: group.variables) {
+        if (!variable.is_coord_var || !variable.is_poem_object()) continue;
+        // The only data read by the rules
+        const auto &values = variable.values();
+        if (values.empty()) continue;
 
-          // Strictly increasing values
-          front_value -= 1.;
-          for (const auto &val: values) {
-            if (val <= front_value) {
-              LogWarningError("In group {}, values for Dimension {} MUST be strictly increasing. "
-                              "Found {} <= {}.", group_name(group), var.getName(), val, front_value);
-              compliant = false;
-            }
-            front_value = val;
-          }
+        if (values.front() < 0.) {
+          violations.push_back({6, group.path, variable.name, fmt::format(
+              "In group {}, values for Dimension {} MUST be positive. Found {}",
+              group.path, variable.name, values.front())});
+        }
 
-          // Not higher than 180 for angular values
-          auto unit = get_attribute(var, "unit");
-          if (unit == "deg") {
-            if (values.back() > 180.) {
-              LogWarningError("In group {}, values for angular Dimension {} MUST be between 0 and 180 deg. "
-                              "Found {}",
-                              group_name(group), var.getName(), values.back());
-              compliant = false;
-            }
+        for (size_t i = 1; i < values.size(); ++i) {
+          if (values[i] <= values[i - 1]) {
+            violations.push_back({6, group.path, variable.name, fmt::format(
+                "In group {}, values for Dimension {} MUST be strictly increasing. Found {} <= {}.",
+                group.path, variable.name, values[i], values[i - 1])});
           }
-
         }
 
-      } else {
-        for (const auto &group_: group.getGroups()) {
-          compliant &= check_R6(group_.second);
+        if (variable.attribute("unit") != "deg") continue;
+
+        // Angular values span half a turn from 0 (half the period of a symmetric Dimension, mirrored about 0), or the
+        // period of a periodic Dimension from its first value for a closed sampling
+        double min_value = 0.;
+        double max_value = 180.;
+        if (variable.attributes.contains("periodicity")) {
+          auto periodicity = variable.attribute("periodicity");
+          auto it = variable.numerical_attributes.find("period");
+          double period = it == variable.numerical_attributes.end() ? 360. : it->second;
+          if (periodicity == "periodic") {
+            min_value = values.front();
+            max_value = values.front() + period;
+          } else if (periodicity == "symmetric") {
+            max_value = 0.5 * period;
+          } else if (periodicity != "non_periodic") {
+            violations.push_back({6, group.path, variable.name, fmt::format(
+                "In group {}, periodicity attribute of Dimension {} MUST be non_periodic, periodic or symmetric. "
+                "Found {}", group.path, variable.name, periodicity)});
+          }
+        }
+        if (values.back() > max_value) {
+          violations.push_back({6, group.path, variable.name, fmt::format(
+              "In group {}, values for angular Dimension {} MUST be between {} and {} deg. Found {}",
+              group.path, variable.name, min_value, max_value, values.back())});
         }
       }
-
     }
 
-    return compliant;
-
-  }
+    void check_R7(const GroupMetadata &group, const GroupScope &scope, std::vector<Violation> &violations) {
+      if (!scope.poem_chain || scope.below_polar) return;
+      if (group.attribute("POEM_NODE_TYPE") != "POLAR") return;
+
+      // An unknown mode is a violation of R4, leaving nothing to check against
+      auto polar_mode_str = group.attribute("POEM_MODE");
+      if (std::find(known_polar_modes.begin(), known_polar_modes.end(), polar_mode_str) == known_polar_modes.end())
+        return;
+      auto polar_mode = string_to_polar_mode(polar_mode_str);
+
+      for (const auto &dimension_name: mandatory_dimensions(polar_mode)) {
+        auto variable = group.variable(dimension_name);
+        if (!variable || !variable->is_coord_var) {
+          violations.push_back({7, group.path, dimension_name, fmt::format(
+              "In group {} (with mode {}), mandatory Coordinate Variable {} not found",
+              group.path, polar_mode_str, dimension_name)});
+        } else if (!variable->is_poem_object()) {
+          violations.push_back({7, group.path, dimension_name, fmt::format(
+              "In {}, mandatory Coordinate Variable {} is found, but attribute POEM_NODE_TYPE is not found",
+              group.path, dimension_name)});
+        } else if (variable->attribute("POEM_NODE_TYPE") != "POLAR_DIMENSION") {
+          violations.push_back({7, group.path, dimension_name, fmt::format(
+              "In {}, mandatory Coordinate Variable {} found but its attribute POEM_NODE_TYPE "
+              "is not POLAR_DIMENSION. Found {}",
+              group.path, dimension_name, variable->attribute("POEM_NODE_TYPE"))});
+        }
+      }
 
-  bool has_coord_var(const netCDF::NcGroup &group, const std::string &name) {
-    bool compliant = true;
+      for (const auto &[name, dimensions]: mandatory_polar_tables(polar_mode)) {
+        auto variable = group.variable(name);
+        if (!variable) {
+          violations.push_back({7, group.path, name, fmt::format(
+              "In group {} (with mode {}), mandatory Variable {} not found", group.path, polar_mode_str, name)});
+          continue;
+        }
 
-    std::string node_type = get_attribute(group, "POEM_NODE_TYPE");
-    if (node_type != "POLAR") {
-      LogCriticalError("Group {} must be a POLAR, found a {}", group_name(group), node_type);
-      CRITICAL_ERROR_POEM
-    }
+        if (variable->is_coord_var) {
+          violations.push_back({7, group.path, name, fmt::format(
+              "In group {}, Variable {} should not be a Coordinate Variable", group.path, name)});
+        }
+        if (!variable->is_poem_object()) {
+          violations.push_back({7, group.path, name, fmt::format(
+              "In group {}, mandatory variable {} found but has no attribute POEM_NODE_TYPE", group.path, name)});
+        } else if (variable->attribute("POEM_NODE_TYPE") != "POLAR_TABLE") {
+          violations.push_back({7, group.path, name, fmt::format(
+              "In group {}, mandatory variable {} found but its attribute POEM_NODE_TYPE is not POLAR_TABLE. "
+              "Found {}", group.path, name, variable->attribute("POEM_NODE_TYPE"))});
+        }
 
-    if (group.getCoordVars().contains(name)) {
-      auto var = group.getVar(name);
-      if (var.getAtts().contains("POEM_NODE_TYPE")) {
-        std::string var_type;
-        var.getAtt("POEM_NODE_TYPE").getValues(var_type);
-        if (var_type != "POLAR_DIMENSION") {
-          LogWarningError("In {}, mandatory Coordinate Variable {} found but its attribute POEM_NODE_TYPE "
-                          "is not POLAR_DIMENSION. Found {}",
-                          group_name(group), name, var_type);
-          compliant = false;
+        if (variable->dimensions.size() != dimensions.size()) {
+          violations.push_back({7, group.path, name, fmt::format(
+              "In group {}, mandatory variable {} has not the correct number of dimensions. Expected {}, found {}",
+              group.path, name, dimensions.size(), variable->dimensions.size())});
+        }
+        for (size_t i = 0; i < std::min(dimensions.size(), variable->dimensions.size()); ++i) {
+          if (dimensions[i] != variable->dimensions[i]) {
+            violations.push_back({7, group.path, name, fmt::format(
+                "In group {}, mandatory variable {} has incorrect dimension {}. Expected {}, found {}",
+                group.path, name, i, dimensions[i], variable->dimensions[i])});
+          }
         }
-      } else {
-        LogWarningError("In {}, mandatory Coordinate Variable {} is found, but attribute POEM_NODE_TYPE is not found",
-                        group_name(group), name);
-        compliant = false;
       }
-      // TODO: verifier qu'on a bien POEM_NODE_TYPE qui est DIMENSION_NODE
-    } else {
-      auto polar_mode = get_attribute(group, "POEM_MODE");
-      LogWarningError("In group {} (with mode {}), mandatory Coordinate Variable {} not found",
-                      group_name(group), polar_mode, name);
-      compliant = false;
     }
 
-    return compliant;
-  }
-
-  bool has_var(const netCDF::NcGroup &group, const std::string &name, const std::vector<std::string> &dims) {
-    bool compliant = true;
+    void traverse(const GroupMetadata &group, const GroupScope &scope, GroupVisitor &visitor) {
+      visitor.visit(group, scope);
 
-    if (group.getVars().contains(name)) {
-      if (group.getCoordVars().contains(name)) {
-        LogWarningError("In group {}, Variable {} should not be a Coordinate Variable",
-                        group_name(group), name);
-        compliant = false;
-        // FIXME: cette condition n'existe pas dans les specs
-      }
-      auto nc_var = group.getVar(name);
-      if (nc_var.getAtts().contains("POEM_NODE_TYPE")) {
-        std::string node_type = get_attribute(nc_var, "POEM_NODE_TYPE");
-//        nc_var.getAtt("POEM_NODE_TYPE").getValues(node_type);
-        if (node_type != "POLAR_TABLE") {
-          LogWarningError("In group {}, mandatory variable {} found but its attribute "
-                          "POEM_NODE_TYPE is not POLAR_TABLE. Found {}",
-                          group_name(group), name, node_type);
-          compliant = false;
-        }
-      } else {
-        LogWarningError("In group {}, mandatory variable {} found but has no attribute POEM_NODE_TYPE",
-                        group_name(group), name);
-        compliant = false;
+      bool is_poem = group.is_poem_object();
+      bool is_polar = scope.poem_chain && group.attribute("POEM_NODE_TYPE") == "POLAR";
+      for (const auto &group_: group.groups) {
+        // The chain of POEM groups is broken by a non POEM subgroup
+        GroupScope scope_{scope.poem_chain && group_.is_poem_object(), is_poem, scope.below_polar || is_polar};
+        traverse(group_, scope_, visitor);
       }
+    }
 
-      auto var_dims = nc_var.getDims();
-      if (var_dims.size() != dims.size()) {
-        LogWarningError("In group {}, mandatory variable {} has not the correct number of dimensions. "
-                        "Expected {}, found {}",
-                        group_name(group), name, dims.size(), var_dims.size());
-        compliant = false;
-      }
-      for (size_t i = 0; i < dims.size(); ++i) {
-        if (dims[i] != var_dims[i].getName()) {
-          LogWarningError("In group {}, mandatory variable {} has incorrect dimension {}. "
-                          "Expected {}, found {}",
-                          group_name(group), name, i, dims[i], var_dims[i].getName());
-          compliant = false;
-        }
+  }  // namespace
+
+  GroupMetadata read_metadata(const netCDF::NcGroup &group) {
+    GroupMetadata metadata;
+    metadata.is_root = group.isRootGroup();
+    metadata.name = group.getName(false);
+    metadata.path = group_name(group);
+    read_typed_attributes(group.getAtts(), metadata.attributes, nullptr);
+
+    auto coord_vars = group.getCoordVars();
+    auto nc_vars = group.getVars();
+    metadata.variables.reserve(nc_vars.size());
+    for (const auto &[name, nc_var]: nc_vars) {
+      VariableMetadata variable;
+      variable.nc_var = nc_var;
+      variable.name = name;
+      variable.type = nc_var.getType().getTypeClass();
+      variable.is_coord_var = coord_vars.contains(name);
+      for (const auto &nc_dim: nc_var.getDims()) {
+        variable.dimensions.push_back(nc_dim.getName());
+        variable.shape.push_back(nc_dim.getSize());
       }
+      read_typed_attributes(nc_var.getAtts(), variable.attributes, &variable.numerical_attributes);
+      metadata.variables.push_back(std::move(variable));
+    }
 
-      // TODO: verifier qu'on a bien toutes les dims dans le bon ordre et que la variable est a bien un POEM_NODE_TYPE
-      //  a POLAR_TABLE
-    } else {
-      std::string polar_mode = get_attribute(group, "POEM_MODE");
-//      group.getAtt("POLAR_MODE").getValues(polar_mode);
-      LogWarningError("In group {} (with mode {}), mandatory Variable {} not found",
-                      group_name(group), polar_mode, name);
-      compliant = false;
+    for (const auto &[name, nc_group]: group.getGroups()) {
+      metadata.groups.push_back(read_metadata(nc_group));
     }
 
-    return compliant;
+    return metadata;
   }
 
-  bool check_R7(const netCDF::NcGroup &group) {
-    bool compliant = true;
-
-    if (is_poem_object(group)) {
-      std::string node_type = get_attribute(group, "POEM_NODE_TYPE");
+  void traverse(const GroupMetadata &root, GroupVisitor &visitor) {
+    traverse(root, {root.is_poem_object(), false, false}, visitor);
+  }
 
-      if (node_type == "POLAR") {
-        auto polar_mode = string_to_polar_mode(get_attribute(group, "POEM_MODE"));
+  void RuleChecker::visit(const GroupMetadata &group, const GroupScope &scope) {
+    auto &violations = m_report.violations;
+    check_R1(group, scope, violations);
+    check_R2(group, violations);
+    check_R3(group, scope, violations);
+    check_R4(group, scope, violations);
+    check_R5(group, scope, violations);
+    check_R6(group, scope, violations);
+    check_R7(group, scope, violations);
+  }
 
-        for (const auto& dimension_name : mandatory_dimensions(polar_mode)) {
-          compliant &= has_coord_var(group, dimension_name);
-        }
+  Report check(const GroupMetadata &root) {
+    RuleChecker rule_checker;
+    traverse(root, rule_checker);
+    return rule_checker.report();
+  }
 
-        for (const auto& polar_table : mandatory_polar_tables(polar_mode)) {
-          compliant &= has_var(group, polar_table.first, polar_table.second);
-        }
+  std::vector<int> Report::violated_rules() const {
+    std::vector<int> rules;
+    for (const auto &violation: violations) {
+      if (std::find(rules.begin(), rules.end(), violation.rule) == rules.end()) rules.push_back(violation.rule);
+    }
+    std::sort(rules.begin(), rules.end());
+    return rules;
+  }
 
-      } else {
-        for (const auto &group_: group.getGroups()) {
-          compliant &= check_R7(group_.second);
-        }
+  void Report::log() const {
+    for (int rule: violated_rules()) {
+      for (const auto &violation: violations) {
+        if (violation.rule == rule) LogWarningError(violation.message);
       }
+      not_compliant_warning(rule);
     }
-
-    return compliant;
   }
 
 }
 
-bool poem::check_v1(const std::string &filename) {
+poem::v1::Report poem::check_v1_report(const std::string &filename) {
 
   if (!fs::exists(filename)) {
     LogCriticalError("NetCDF file not found: {}", filename);
     CRITICAL_ERROR_POEM
   }
 
+  std::lock_guard<std::recursive_mutex> lock(poem::netcdf_mutex());
   netCDF::NcFile root_group(filename, netCDF::NcFile::read);
-
-  bool compliant = true;
-
-  if (!v1::check_R1(root_group)) {
-    v1::not_compliant_warning(1);
-    compliant = false;
-  }
-
-  if (!v1::check_R2(root_group)) {
-    v1::not_compliant_warning(2);
-    compliant = false;
-  }
-
-  if (!v1::check_R3(root_group)) {
-    v1::not_compliant_warning(3);
-    compliant = false;
-  }
-
-  if (!v1::check_R4(root_group)) {
-    v1::not_compliant_warning(4);
-    compliant = false;
-  }
-
-  if (!v1::check_R5(root_group)) {
-    v1::not_compliant_warning(5);
-    compliant = false;
-  }
-
-  if (!v1::check_R6(root_group)) {
-    v1::not_compliant_warning(6);
-    compliant = false;
-  }
-
-  if (!v1::check_R7(root_group)) {
-    v1::not_compliant_warning(7);
-    compliant = false;
-  }
-
+  auto report = v1::check(v1::read_metadata(root_group));
   root_group.close();
 
-  return compliant;
+  return report;
+}
 
-}  // poem::v1
+bool poem::check_v1(const std::string &filename) {
+  auto report = check_v1_report(filename);
+  report.log();
+  return report.compliant();
+}
@@ -5,37 +5,186 @@
 #ifndef POEM_SPEC_V1_H
 #define POEM_SPEC_V1_H
 
+#include <map>
 #include <string>
 #include <netcdf>
 #include <unordered_map>
+#include <vector>
 #include "poem/enums.h"
 
 namespace poem {
 
   namespace v1 {
 
+    /**
+     * Violation of a rule of the POEM specification v1
+     */
+    struct Violation {
+      // Rule number, from 1 to 7
+      int rule;
+      // Full path of the group, "root" for the root group
+      std::string group;
+      // Variable concerned, empty for the group itself
+      std::string variable;
+      std::string message;
+    };
+
+    /**
+     * Every violation of the rules found in a file, in the order of the groups
+     */
+    struct Report {
+      std::vector<Violation> violations;
+
+      [[nodiscard]] bool compliant() const {
+        return violations.empty();
+      }
+
+      /**
+       * Rules with at least one violation, in increasing order
+       */
+      [[nodiscard]] std::vector<int> violated_rules() const;
+
+      /**
+       * Logs violations rule by rule, each violated rule being followed by a link to its documentation
+       */
+      void log() const;
+    };
+
+    /**
+     * Metadata of a netCDF variable, read once from the file (see read_metadata)
+     */
+    struct VariableMetadata {
+      netCDF::NcVar nc_var;
+      std::string name;
+      netCDF::NcType::ncType type;
+      bool is_coord_var = false;
+      // Names of the Dimensions of the variable
+      std::vector<std::string> dimensions;
+      std::vector<size_t> shape;
+      // Text attributes
+      std::map<std::string, std::string> attributes;
+      // Numerical attributes holding a single value
+      std::map<std::string, double> numerical_attributes;
+
+      [[nodiscard]] bool is_poem_object() const {
+        return attributes.contains("POEM_NODE_TYPE");
+      }
+
+      /**
+       * Value of a text attribute, empty if not found
+       */
+      [[nodiscard]] std::string attribute(const std::string &name) const;
+
+      /**
+       * Values of a numerical coordinate variable, read from the file at first call, which must still be open. Empty
+       * for other variables.
+       */
+      [[nodiscard]] const std::vector<double> &values() const;
+
+     private:
+      mutable std::vector<double> m_values;
+      mutable bool m_values_read = false;
+    };
+
+    /**
+     * Metadata of a netCDF group and of its subgroups, read once from the file (see read_metadata)
+     */
+    struct GroupMetadata {
+      std::string name;
+      // Full path of the group, "root" for the root group
+      std::string path;
+      bool is_root = false;
+      // Text attributes
+      std::map<std::string, std::string> attributes;
+      // Variables, coordinate variables included, in the order of the file
+      std::vector<VariableMetadata> variables;
+      std::vector<GroupMetadata> groups;
+
+      [[nodiscard]] bool is_poem_object() const {
+        return attributes.contains("POEM_NODE_TYPE");
+      }
+
+      /**
+       * Value of a text attribute, empty if not found
+       */
+      [[nodiscard]] std::string attribute(const std::string &name) const;
+
+      /**
+       * Variable of the group with the given name, nullptr if not found
+       */
+      [[nodiscard]] const VariableMetadata *variable(const std::string &name) const;
+    };
+
+    /**
+     * Reads the metadata of group and of its subgroups in a single traversal of the file: every attribute is read once,
+     * with its type (no exception is used for non text attributes). Values of variables are not read.
+     */
+    GroupMetadata read_metadata(const netCDF::NcGroup &group);
+
+    /**
+     * Position of a group in the tree, deciding which rules apply to it
+     */
+    struct GroupScope {
+      // Every group from the root to this one is a POEM group, rules R3 to R7 only following POEM groups
+      bool poem_chain;
+      // The parent is a POEM group, false for the root group
+      bool parent_is_poem;
+      // An ancestor is a Polar, where rules R5 to R7 stop
+      bool below_polar;
+    };
+
+    /**
+     * Visitor of the groups of a file (see traverse)
+     */
+    class GroupVisitor {
+     public:
+      virtual ~GroupVisitor() = default;
+
+      virtual void visit(const GroupMetadata &group, const GroupScope &scope) = 0;
+    };
+
+    /**
+     * Visits root and its subgroups in pre order
+     */
+    void traverse(const GroupMetadata &root, GroupVisitor &visitor);
+
+    /**
+     * Visitor applying every rule R1 to R7 to each group, from its metadata only except for R6 that reads the values of
+     * the Dimensions of Polars
+     */
+    class RuleChecker : public GroupVisitor {
+     public:
+      void visit(const GroupMetadata &group, const GroupScope &scope) override;
+
+      [[nodiscard]] const Report &report() const {
+        return m_report;
+      }
+
+     private:
+      Report m_report;
+    };
+
+    /**
+     * Checks the tree of root against every rule, in a single traversal
+     */
+    Report check(const GroupMetadata &root);
+
     std::vector<std::string> mandatory_dimensions(POLAR_MODE polar_mode);
 
     std::unordered_map<std::string, std::vector<std::string>> mandatory_polar_tables(POLAR_MODE polar_mode);
 
-    bool check_R1(const netCDF::NcGroup &group);
-
-    bool check_R2(const netCDF::NcGroup &group);
-
-    bool check_R3(const netCDF::NcGroup &group);
-
-    bool check_R4(const netCDF::NcGroup &group);
-
-    bool check_R5(const netCDF::NcGroup &group);
-
-    bool check_R6(const netCDF::NcGroup &group);
-
-    bool check_R7(const netCDF::NcGroup &group);
-
   }  // poem::v1
 
+  /**
+   * Checks a file against every rule of the POEM specification v1, logging the violations found
+   */
   bool check_v1(const std::string &filename);
 
+  /**
+   * Report of every violation of the rules of the POEM specification v1 found in a file. Nothing is logged.
+   */
+  v1::Report check_v1_report(const std::string &filename);
+
 }  // poem
 
 #endif //POEM_SPEC_V1_H
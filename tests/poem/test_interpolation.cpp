@@ -0,0 +1,1010 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+#include <MathUtils/VectorGeneration.h>
+
+#include "poem/poem.h"
+
+using namespace poem;
+
+std::shared_ptr<PolarTable<double>> make_trilinear_polar_table() {
+  auto STW = make_dimension("STW", "kt", "Speed Through Water");
+  auto TWS = make_dimension("TWS", "kt", "True Wind Speed");
+  auto TWA = make_dimension("TWA", "deg", "True Wind Angle");
+
+  auto dimension_grid = make_dimension_grid(make_dimension_set({STW, TWS, TWA}));
+  dimension_grid->set_values("STW", {0, 2, 4, 6, 8});
+  dimension_grid->set_values("TWS", {0, 10, 20, 30});
+  dimension_grid->set_values("TWA", {0, 45, 90, 135, 180});
+
+  // f(STW, TWS, TWA) = 2 STW + 0.5 TWS - 0.1 TWA + 3 is reproduced exactly by multilinear interpolation
+  auto polar_table = make_polar_table_double("VAR", "-", "VAR", dimension_grid);
+  size_t idx = 0;
+  for (const auto &dimension_point: dimension_grid->dimension_points()) {
+    polar_table->set_value(idx, 2. * dimension_point[0] + 0.5 * dimension_point[1] - 0.1 * dimension_point[2] + 3.);
+    idx++;
+  }
+  return polar_table;
+}
+
+TEST(interpolation, interp_batch) {
+  auto polar_table = make_trilinear_polar_table();
+  auto dimension_set = polar_table->dimension_grid()->dimension_set();
+
+  std::vector<double> STW{0., 1.3, 7.9, 8., 3.};
+  std::vector<double> TWS{0., 12.5, 29., 30., 0.1};
+  std::vector<double> TWA{180., 33., 91., 0., 179.};
+  std::vector<double> values(STW.size());
+
+  polar_table->interp_batch({STW.data(), TWS.data(), TWA.data()}, STW.size(), values.data(), ERROR);
+
+  for (size_t i = 0; i < STW.size(); ++i) {
+    DimensionPoint dimension_point(dimension_set, {STW[i], TWS[i], TWA[i]});
+    ASSERT_DOUBLE_EQ(values[i], polar_table->interp(dimension_point, ERROR));
+    ASSERT_NEAR(values[i], 2. * STW[i] + 0.5 * TWS[i] - 0.1 * TWA[i] + 3., 1e-10);
+  }
+
+  // Out of bound management
+  STW[2] = 9.;
+  ASSERT_ANY_THROW(polar_table->interp_batch({STW.data(), TWS.data(), TWA.data()}, STW.size(), values.data(), ERROR));
+  polar_table->interp_batch({STW.data(), TWS.data(), TWA.data()}, STW.size(), values.data(), SATURATE);
+  ASSERT_NEAR(values[2], 2. * 8. + 0.5 * TWS[2] - 0.1 * TWA[2] + 3., 1e-10);
+
+  // Bad number of coordinate arrays
+  ASSERT_ANY_THROW(polar_table->interp_batch({STW.data(), TWS.data()}, STW.size(), values.data(), ERROR));
+}
+
+TEST(interpolation, concurrent_first_queries) {
+  auto polar_table = make_trilinear_polar_table();
+  auto dimension_set = polar_table->dimension_grid()->dimension_set();
+
+  // Several threads hitting a fresh table at the same time
+  std::vector<double> results(8);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&, i]() {
+      DimensionPoint dimension_point(dimension_set, {1.5, 15., 100.});
+      results[i] = polar_table->interp(dimension_point, ERROR);
+    });
+  }
+  for (auto &thread: threads) thread.join();
+
+  for (const auto &result: results) {
+    ASSERT_NEAR(result, 2. * 1.5 + 0.5 * 15. - 0.1 * 100. + 3., 1e-10);
+  }
+}
+
+TEST(interpolation, prepare) {
+  auto vessel = make_polar_node("vessel", "my vessel");
+  auto polar_set = make_polar_set("polar_set", "polar set");
+  vessel->attach_polar_set(polar_set);
+
+  auto polar_table = make_trilinear_polar_table();
+  auto polar = polar_set->create_polar(MPPP, polar_table->dimension_grid());
+  polar->attach_polar_table(polar_table);
+  polar->create_polar_table<int>("SOLVER_STATUS", "-", "Solver Status", POEM_INT)->fill_with(1);
+
+  std::vector<std::shared_ptr<PolarTableBase>> polar_tables;
+  vessel->polar_tables(polar_tables);
+  ASSERT_EQ(polar_tables.size(), 2);
+
+  ASSERT_NO_THROW(vessel->prepare());
+  ASSERT_NO_THROW(vessel->prepare(1));
+
+  DimensionPoint dimension_point(polar_table->dimension_grid()->dimension_set(), {1.5, 15., 100.});
+  ASSERT_NEAR(polar_table->interp(dimension_point, ERROR), 2. * 1.5 + 0.5 * 15. - 0.1 * 100. + 3., 1e-10);
+}
+
+std::shared_ptr<PolarTable<double>> make_affine_polar_table(size_t ndims) {
+  // f(x) = 1 + sum_i (i+1) x_i is reproduced exactly by multilinear interpolation
+  std::vector<std::shared_ptr<Dimension>> dimensions;
+  for (size_t idim = 0; idim < ndims; ++idim) {
+    dimensions.push_back(make_dimension("DIM_" + std::to_string(idim), "-", "Dimension"));
+  }
+  auto dimension_grid = make_dimension_grid(make_dimension_set(dimensions));
+  for (size_t idim = 0; idim < ndims; ++idim) {
+    // Non uniform sampling, with a singleton dimension
+    if (idim == 1) {
+      dimension_grid->set_values("DIM_1", {0.5});
+    } else {
+      dimension_grid->set_values("DIM_" + std::to_string(idim), {0., 1., 3., 3.5});
+    }
+  }
+
+  auto polar_table = make_polar_table_double("AFFINE", "-", "Affine function", dimension_grid);
+  size_t idx = 0;
+  for (const auto &dimension_point: dimension_grid->dimension_points()) {
+    double val = 1.;
+    for (size_t idim = 0; idim < ndims; ++idim) {
+      val += (double) (idim + 1) * dimension_point[idim];
+    }
+    polar_table->set_value(idx, val);
+    idx++;
+  }
+  return polar_table;
+}
+
+TEST(interpolation, multilinear_kernel) {
+  // Above 6 dimensions, the runtime dimension interpolator is used
+  for (size_t ndims = 1; ndims <= 9; ++ndims) {
+    auto polar_table = make_affine_polar_table(ndims);
+    auto dimension_set = polar_table->dimension_grid()->dimension_set();
+
+    for (double x: {0., 0.3, 1., 2.2, 3.5}) {
+      std::vector<double> coords(ndims);
+      double expected = 1.;
+      for (size_t idim = 0; idim < ndims; ++idim) {
+        coords[idim] = idim == 1 ? 0.5 : x - 0.1 * (double) idim * (x > 0.5);
+        expected += (double) (idim + 1) * coords[idim];
+      }
+      ASSERT_NEAR(polar_table->interp(DimensionPoint(dimension_set, coords), ERROR), expected, 1e-10);
+    }
+  }
+
+  // The interpolator reads directly into the table values, no copy is kept
+  auto polar_table = make_affine_polar_table(2);
+  auto dimension_point = DimensionPoint(polar_table->dimension_grid()->dimension_set(), {1., 0.5});
+  ASSERT_NEAR(polar_table->interp(dimension_point, ERROR), 3., 1e-10);
+  polar_table->multiply_by(2.);
+  ASSERT_NEAR(polar_table->interp(dimension_point, ERROR), 6., 1e-10);
+}
+
+TEST(interpolation, runtime_dimension_kernel) {
+  // Interpolator<T, 0> gives the same results as the compile time dimension interpolators
+  for (size_t ndims = 1; ndims <= 6; ++ndims) {
+    auto polar_table = make_affine_polar_table(ndims);
+    polar_table->multiply_by(1.1);  // Slightly breaks the exactness to compare rounding too
+    Interpolator<double, 0> interpolator(polar_table.get());
+    interpolator.build();
+    ASSERT_EQ(interpolator.ndims(), ndims);
+
+    for (double x: {0., 0.3, 1., 2.2, 3.5}) {
+      std::vector<double> coords(ndims);
+      for (size_t idim = 0; idim < ndims; ++idim) {
+        coords[idim] = idim == 1 ? 0.5 : x - 0.1 * (double) idim * (x > 0.5);
+      }
+      DimensionPoint dimension_point(polar_table->dimension_grid()->dimension_set(), coords);
+      ASSERT_DOUBLE_EQ(interpolator.interp(coords.data(), ERROR), polar_table->interp(dimension_point, ERROR));
+    }
+  }
+
+  // Above POEM_MAX_DIMS, building the interpolator is an error
+  std::vector<std::shared_ptr<Dimension>> dimensions;
+  for (size_t idim = 0; idim <= POEM_MAX_DIMS; ++idim) {
+    dimensions.push_back(make_dimension("DIM_" + std::to_string(idim), "-", "Dimension"));
+  }
+  auto dimension_grid = make_dimension_grid(make_dimension_set(dimensions));
+  for (size_t idim = 0; idim <= POEM_MAX_DIMS; ++idim) {
+    dimension_grid->set_values("DIM_" + std::to_string(idim), {0., 1.});
+  }
+  auto polar_table = make_polar_table_double("TOO_MANY_DIMS", "-", "Too many dimensions", dimension_grid);
+  ASSERT_THROW(polar_table->warm_up(), PoemException);
+}
+
+TEST(interpolation, cell_location) {
+  auto X = make_dimension("X", "-", "Uniform");
+  auto Y = make_dimension("Y", "-", "Non uniform");
+  auto Z = make_dimension("Z", "-", "Singleton");
+  auto W = make_dimension("W", "-", "Uniform, with a step not representable exactly");
+  auto dimension_grid = make_dimension_grid(make_dimension_set({X, Y, Z, W}));
+  dimension_grid->set_values("X", mathutils::linspace(0., 180., 37));
+  dimension_grid->set_values("Y", {0., 0.3, 1., 2.5, 4., 4.1, 7., 10., 12., 20., 35.});
+  dimension_grid->set_values("Z", {1.});
+  dimension_grid->set_values("W", mathutils::linspace(0., 1., 11));
+
+  ASSERT_TRUE(dimension_grid->is_uniform(0));
+  ASSERT_FALSE(dimension_grid->is_uniform(1));
+  ASSERT_FALSE(dimension_grid->is_uniform(2));
+  ASSERT_TRUE(dimension_grid->is_uniform(3));
+
+  // Reference: std::upper_bound and a linear search of the nearest value
+  std::mt19937 generator(0);
+  for (size_t idim: {0, 1, 3}) {
+    const auto &values = dimension_grid->values(idim);
+    std::uniform_real_distribution<double> distribution(values.front() - 1., values.back() + 1.);
+
+    std::vector<double> coords(values);  // Exactly on the sampling values
+    for (size_t i = 0; i < 1000; ++i) {
+      coords.push_back(distribution(generator));
+    }
+
+    for (double coord: coords) {
+      size_t index = std::upper_bound(values.begin(), values.end(), coord) - values.begin();
+      index = index == 0 ? 0 : std::min(index - 1, values.size() - 2);
+      ASSERT_EQ(dimension_grid->cell_index(idim, coord), index);
+
+      auto it = std::min_element(values.begin(), values.end(), [coord](double a, double b) {
+        return std::abs(a - coord) < std::abs(b - coord);
+      });
+      ASSERT_EQ(dimension_grid->nearest_index(idim, coord), it - values.begin());
+    }
+  }
+
+  double weight;
+  ASSERT_EQ(dimension_grid->locate(0, 12.5, weight), 2);
+  ASSERT_DOUBLE_EQ(weight, 0.5);
+  ASSERT_EQ(dimension_grid->locate(2, 3., weight), 0);
+  ASSERT_EQ(weight, 0.);
+  ASSERT_EQ(dimension_grid->nearest_index(2, 3.), 0);
+
+  // Setting values by index keeps the cell location in sync
+  dimension_grid->set_values(0, mathutils::linspace(0., 90., 10));
+  ASSERT_EQ(dimension_grid->values(0).size(), 10);
+  ASSERT_EQ(dimension_grid->locate(0, 12.5, weight), 1);
+  ASSERT_DOUBLE_EQ(weight, 0.25);
+  ASSERT_ANY_THROW(dimension_grid->set_values(4, {0., 1.}));
+  ASSERT_ANY_THROW(dimension_grid->set_values(0, {1., 0.}));
+}
+
+TEST(interpolation, nearest_batch) {
+  auto STW = make_dimension("STW", "kt", "Speed Through Water");
+  auto TWA = make_dimension("TWA", "deg", "True Wind Angle");
+  auto dimension_grid = make_dimension_grid(make_dimension_set({STW, TWA}));
+  dimension_grid->set_values("STW", {0., 1., 3., 3.5, 8.});
+  dimension_grid->set_values("TWA", mathutils::linspace(0., 180., 13));
+
+  auto polar_table = make_polar_table_int("SOLVER_STATUS", "-", "Solver status", dimension_grid);
+  for (size_t idx = 0; idx < polar_table->size(); ++idx) {
+    polar_table->set_value(idx, (int) idx);
+  }
+
+  std::vector<double> stw = {0., 0.4, 0.5, 2.1, 3.2, 7.9, 8., 9.};
+  std::vector<double> twa = {0., 7.4, 7.5, 45., 100., 179., 180., -10.};
+  std::vector<int> values(stw.size());
+  polar_table->nearest_batch({stw.data(), twa.data()}, stw.size(), values.data(), SATURATE);
+
+  auto dimension_set = dimension_grid->dimension_set();
+  for (size_t i = 0; i < stw.size(); ++i) {
+    ASSERT_EQ(values[i], polar_table->nearest(DimensionPoint(dimension_set, {stw[i], twa[i]}), SATURATE));
+  }
+  // Ties go to the lower sampling value
+  ASSERT_EQ(values[2], 0);
+  ASSERT_EQ(values[3], 2 * 13 + 3);
+  ASSERT_EQ(values[7], 4 * 13);
+
+  // interp_batch on an int table is nearest_batch
+  std::vector<int> interp_values(stw.size());
+  polar_table->interp_batch({stw.data(), twa.data()}, stw.size(), interp_values.data(), SATURATE);
+  ASSERT_EQ(interp_values, values);
+
+  ASSERT_THROW(polar_table->nearest_batch({stw.data(), twa.data()}, stw.size(), values.data(), ERROR), PoemException);
+}
+
+TEST(interpolation, polar_query) {
+  auto STW = make_dimension("STW", "kt", "Speed Through Water");
+  auto TWS = make_dimension("TWS", "kt", "True Wind Speed");
+  auto TWA = make_dimension("TWA", "deg", "True Wind Angle");
+  auto dimension_grid = make_dimension_grid(make_dimension_set({STW, TWS, TWA}));
+  dimension_grid->set_values("STW", {0., 1., 3., 3.5, 8.});
+  dimension_grid->set_values("TWS", {0., 10., 20.});
+  dimension_grid->set_values("TWA", mathutils::linspace(0., 180., 13));
+
+  auto polar = make_polar("MPPP", MPPP, dimension_grid);
+  auto power = polar->create_polar_table<double>("TOTAL_POWER", "kW", "Total power", POEM_DOUBLE);
+  auto leeway = polar->create_polar_table<double>("LEEWAY", "deg", "Leeway", POEM_DOUBLE);
+  auto status = polar->create_polar_table<int>("SOLVER_STATUS", "-", "Solver status", POEM_INT);
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(0., 1.);
+  for (size_t idx = 0; idx < power->size(); ++idx) {
+    power->set_value(idx, 1000. * distribution(generator));
+    leeway->set_value(idx, distribution(generator));
+    status->set_value(idx, (int) idx % 3);
+  }
+
+  std::vector<std::string> names = {"SOLVER_STATUS", "TOTAL_POWER", "LEEWAY"};
+  auto query = polar->query(names);
+  ASSERT_EQ(query.size(), 3);
+
+  std::vector<double> stw = {0., 0.4, 2.1, 3.2, 7.9, 8., 9.};
+  std::vector<double> tws = {0., 5., 12., 20., 3.3, 19., 25.};
+  std::vector<double> twa = {0., 7.4, 45., 100., 179., 180., 200.};
+  std::vector<std::vector<double>> results(names.size(), std::vector<double>(stw.size()));
+  query.interp_batch({stw.data(), tws.data(), twa.data()}, stw.size(),
+                     {results[0].data(), results[1].data(), results[2].data()}, SATURATE);
+
+  auto dimension_set = dimension_grid->dimension_set();
+  for (size_t i = 0; i < stw.size(); ++i) {
+    DimensionPoint dimension_point(dimension_set, {stw[i], tws[i], twa[i]});
+    // Same results as querying the tables one by one
+    auto point_results = polar->interp(dimension_point, names, SATURATE);
+    ASSERT_EQ(point_results[0], status->nearest(dimension_point, SATURATE));
+    ASSERT_EQ(point_results[1], power->interp(dimension_point, SATURATE));
+    ASSERT_EQ(point_results[2], leeway->interp(dimension_point, SATURATE));
+    for (size_t itable = 0; itable < names.size(); ++itable) {
+      ASSERT_EQ(results[itable][i], point_results[itable]);
+    }
+  }
+
+  // The interpolation method of each table is honored
+  power->set_interpolation_method(PCHIP);
+  for (size_t i = 0; i < stw.size(); ++i) {
+    DimensionPoint dimension_point(dimension_set, {stw[i], tws[i], twa[i]});
+    auto point_results = query.interp(dimension_point, SATURATE);
+    ASSERT_EQ(point_results[1], power->interp(dimension_point, SATURATE));
+    ASSERT_EQ(point_results[2], leeway->interp(dimension_point, SATURATE));
+  }
+  power->set_interpolation_method(LINEAR);
+
+  DimensionPoint out_of_bound(dimension_set, {9., 0., 0.});
+  ASSERT_THROW(query.interp(out_of_bound, ERROR), PoemException);
+  ASSERT_THROW(polar->query({"UNKNOWN"}), PoemException);
+}
+
+TEST(interpolation, packed_polar) {
+  auto STW = make_dimension("STW", "kt", "Speed Through Water");
+  auto TWA = make_dimension("TWA", "deg", "True Wind Angle");
+  auto dimension_grid = make_dimension_grid(make_dimension_set({STW, TWA}));
+  dimension_grid->set_values("STW", {0., 1., 3., 3.5, 8.});
+  dimension_grid->set_values("TWA", mathutils::linspace(0., 180., 13));
+
+  auto polar = make_polar("MPPP", MPPP, dimension_grid);
+  std::vector<std::shared_ptr<PolarTable<double>>> polar_tables;
+  std::vector<std::string> names;
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(0., 1.);
+  for (size_t itable = 0; itable < 4; ++itable) {
+    names.push_back("VAR_" + std::to_string(itable));
+    polar_tables.push_back(polar->create_polar_table<double>(names.back(), "-", "Variable", POEM_DOUBLE));
+    for (size_t idx = 0; idx < polar_tables.back()->size(); ++idx) {
+      polar_tables.back()->set_value(idx, distribution(generator));
+    }
+  }
+  auto status = polar->create_polar_table<int>("SOLVER_STATUS", "-", "Solver status", POEM_INT);
+  names.push_back("SOLVER_STATUS");
+
+  std::vector<std::vector<double>> values;
+  for (const auto &polar_table: polar_tables) {
+    values.push_back(polar_table->values());
+  }
+  auto dimension_point = DimensionPoint(dimension_grid->dimension_set(), {2.2, 100.});
+  auto unpacked_results = polar->interp(dimension_point, names, ERROR);
+
+  ASSERT_FALSE(polar->is_packed());
+  polar->pack();
+  ASSERT_TRUE(polar->is_packed());
+  ASSERT_FALSE(status->is_packed());
+
+  for (size_t itable = 0; itable < polar_tables.size(); ++itable) {
+    const auto &polar_table = polar_tables[itable];
+    ASSERT_TRUE(polar_table->is_packed());
+    ASSERT_EQ(polar_table->stride(), polar_tables.size());
+    // Materialization of the values
+    ASSERT_EQ(std::as_const(*polar_table).values(), values[itable]);
+    ASSERT_EQ(polar_table->mean(), polar_table->copy()->mean());
+  }
+
+  // Same results with the packed storage
+  ASSERT_EQ(polar->interp(dimension_point, names, ERROR), unpacked_results);
+  ASSERT_EQ(polar_tables[1]->interp(dimension_point, ERROR), unpacked_results[1]);
+  ASSERT_EQ(polar_tables[2]->nearest(dimension_point, ERROR), polar_tables[2]->copy()->nearest(dimension_point, ERROR));
+
+  // Modifying a table unpacks it, the other ones remaining packed
+  polar_tables[0]->multiply_by(2.);
+  ASSERT_FALSE(polar_tables[0]->is_packed());
+  ASSERT_TRUE(polar_tables[1]->is_packed());
+  ASSERT_DOUBLE_EQ(polar_tables[0]->interp(dimension_point, ERROR), 2. * unpacked_results[0]);
+  ASSERT_EQ(polar_tables[1]->interp(dimension_point, ERROR), unpacked_results[1]);
+
+  polar->unpack();
+  ASSERT_FALSE(polar->is_packed());
+  ASSERT_EQ(polar_tables[3]->values(), values[3]);
+}
+
+TEST(interpolation, simd_batch_kernel) {
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(0., 3.5);
+
+  for (size_t ndims = 1; ndims <= 7; ++ndims) {
+    auto polar_table = make_affine_polar_table(ndims);
+    // Random values, not to be exactly reproduced by any interpolation
+    for (size_t idx = 0; idx < polar_table->size(); ++idx) {
+      polar_table->set_value(idx, distribution(generator));
+    }
+    auto dimension_set = polar_table->dimension_grid()->dimension_set();
+
+    // Not a multiple of the vector widths, nor of the chunk size
+    size_t n_points = 203;
+    std::vector<std::vector<double>> coords(ndims, std::vector<double>(n_points));
+    std::vector<const double *> coords_ptr;
+    for (size_t idim = 0; idim < ndims; ++idim) {
+      for (auto &coord: coords[idim]) {
+        coord = idim == 1 ? 0.5 : distribution(generator);
+      }
+      coords_ptr.push_back(coords[idim].data());
+    }
+
+    std::vector<double> expected(n_points);
+    for (size_t ipoint = 0; ipoint < n_points; ++ipoint) {
+      std::vector<double> point(ndims);
+      for (size_t idim = 0; idim < ndims; ++idim) {
+        point[idim] = coords[idim][ipoint];
+      }
+      expected[ipoint] = polar_table->interp(DimensionPoint(dimension_set, point), ERROR);
+    }
+
+    // Bit identical results whatever the instruction set
+    for (auto instruction_set: {SIMD_SCALAR, SIMD_AVX2, SIMD_AVX512}) {
+      if (!simd_supported(instruction_set)) continue;
+      set_simd_instruction_set(instruction_set);
+      std::vector<double> values(n_points);
+      polar_table->interp_batch(coords_ptr, n_points, values.data(), ERROR);
+      ASSERT_EQ(values, expected) << simd_instruction_set_to_string(instruction_set) << " " << ndims << "D";
+    }
+    set_simd_instruction_set(simd_detected_instruction_set());
+  }
+}
+
+TEST(interpolation, query_out_of_bound_policy) {
+  auto polar_table = make_trilinear_polar_table();
+  auto dimension_set = polar_table->dimension_grid()->dimension_set();
+  auto f = [](double STW, double TWS, double TWA) { return 2. * STW + 0.5 * TWS - 0.1 * TWA + 3.; };
+
+  // Saturate TWA, extrapolate TWS, reject STW
+  OutOfBoundPolicy policy(ERROR);
+  policy.set("TWA", SATURATE).set("TWS", EXTRAPOLATE);
+
+  double value;
+  ASSERT_EQ(polar_table->query(DimensionPoint(dimension_set, {1., 5., 50.}), policy, value), IN_RANGE);
+  ASSERT_NEAR(value, f(1., 5., 50.), 1e-10);
+
+  ASSERT_EQ(polar_table->query(DimensionPoint(dimension_set, {1., 5., 200.}), policy, value), SATURATED);
+  ASSERT_NEAR(value, f(1., 5., 180.), 1e-10);
+
+  // Linear extrapolation is exact on an affine function, on both sides
+  ASSERT_EQ(polar_table->query(DimensionPoint(dimension_set, {1., 45., 200.}), policy, value), EXTRAPOLATED);
+  ASSERT_NEAR(value, f(1., 45., 180.), 1e-10);
+  ASSERT_EQ(polar_table->query(DimensionPoint(dimension_set, {1., -5., 50.}), policy, value), EXTRAPOLATED);
+  ASSERT_NEAR(value, f(1., -5., 50.), 1e-10);
+
+  ASSERT_EQ(polar_table->query(DimensionPoint(dimension_set, {9., 45., 50.}), policy, value), REJECTED);
+  ASSERT_TRUE(std::isnan(value));
+  ASSERT_EQ(polar_table->query(DimensionPoint(dimension_set, {NAN, 5., 50.}), policy, value), REJECTED);
+  ASSERT_TRUE(std::isnan(value));
+
+  // Unknown dimension in the policy
+  ASSERT_ANY_THROW(polar_table->query(DimensionPoint(dimension_set, {1., 5., 50.}),
+                                      OutOfBoundPolicy({{"Hs", SATURATE}}), value));
+
+  // Batch gives the same values and statuses as single point queries, without throwing
+  std::vector<double> STW{1., 1., 1., 9., -1., 4.};
+  std::vector<double> TWS{5., 5., 45., 45., 12., -10.};
+  std::vector<double> TWA{50., 200., 200., 50., 60., 0.};
+  std::vector<double> values(STW.size());
+  std::vector<QUERY_STATUS> statuses(STW.size());
+  polar_table->query_batch({STW.data(), TWS.data(), TWA.data()}, STW.size(), values.data(), statuses.data(), policy);
+
+  for (size_t i = 0; i < STW.size(); ++i) {
+    double expected;
+    ASSERT_EQ(statuses[i], polar_table->query(DimensionPoint(dimension_set, {STW[i], TWS[i], TWA[i]}), policy,
+                                              expected));
+    if (statuses[i] == REJECTED) {
+      ASSERT_TRUE(std::isnan(values[i]));
+    } else {
+      ASSERT_DOUBLE_EQ(values[i], expected);
+    }
+  }
+
+  // EXTRAPOLATE out of bound method for interp
+  ASSERT_NEAR(polar_table->interp(DimensionPoint(dimension_set, {10., 40., 200.}), EXTRAPOLATE),
+              f(10., 40., 200.), 1e-10);
+}
+
+TEST(interpolation, query_nearest) {
+  auto polar_table = make_trilinear_polar_table();
+  auto dimension_grid = polar_table->dimension_grid();
+  auto dimension_set = dimension_grid->dimension_set();
+
+  auto polar_table_int = make_polar_table_int("INT", "-", "INT", dimension_grid);
+  for (size_t idx = 0; idx < polar_table_int->size(); ++idx) {
+    polar_table_int->set_value(idx, (int) idx);
+  }
+
+  // No extrapolation for nearest, the point is saturated
+  int value;
+  ASSERT_EQ(polar_table_int->query(DimensionPoint(dimension_set, {9., 5., 50.}), OutOfBoundPolicy(EXTRAPOLATE), value),
+            SATURATED);
+  ASSERT_EQ(value, polar_table_int->nearest(DimensionPoint(dimension_set, {8., 5., 50.}), ERROR));
+
+  ASSERT_EQ(polar_table_int->query(DimensionPoint(dimension_set, {9., 5., 50.}), OutOfBoundPolicy(ERROR), value),
+            REJECTED);
+  ASSERT_EQ(value, 0);
+
+  std::vector<double> STW{1., 9.};
+  std::vector<double> TWS{5., 5.};
+  std::vector<double> TWA{50., 50.};
+  std::vector<int> values(2);
+  std::vector<QUERY_STATUS> statuses(2);
+  polar_table_int->query_batch({STW.data(), TWS.data(), TWA.data()}, 2, values.data(), statuses.data(), ERROR);
+  ASSERT_EQ(statuses[0], IN_RANGE);
+  ASSERT_EQ(values[0], polar_table_int->nearest(DimensionPoint(dimension_set, {1., 5., 50.}), ERROR));
+  ASSERT_EQ(statuses[1], REJECTED);
+}
+
+TEST(interpolation, resample_extrapolate) {
+  auto polar_table = make_trilinear_polar_table();
+  auto dimension_set = polar_table->dimension_grid()->dimension_set();
+
+  auto new_dimension_grid = make_dimension_grid(dimension_set);
+  new_dimension_grid->set_values("STW", {-2, 5, 10});
+  new_dimension_grid->set_values("TWS", {0, 40});
+  new_dimension_grid->set_values("TWA", {0, 90, 180});
+
+  auto resampled_polar_table = polar_table->resample(new_dimension_grid, EXTRAPOLATE);
+  size_t idx = 0;
+  for (const auto &dimension_point: new_dimension_grid->dimension_points()) {
+    ASSERT_NEAR(resampled_polar_table->values()[idx],
+                2. * dimension_point[0] + 0.5 * dimension_point[1] - 0.1 * dimension_point[2] + 3., 1e-10);
+    idx++;
+  }
+}
+
+TEST(interpolation, periodic_dimensions) {
+  auto STW = make_dimension("STW", "kt", "Speed Through Water");
+  auto TWA = make_dimension("TWA", "deg", "True Wind Angle", SYMMETRIC);
+  auto WA = make_dimension("WA", "deg", "Mean Waves Angle", PERIODIC);
+
+  auto dimension_grid = make_dimension_grid(make_dimension_set({STW, TWA, WA}));
+  dimension_grid->set_values("STW", {0, 5, 10});
+  dimension_grid->set_values("TWA", {0, 30, 60, 90, 135, 180});
+  dimension_grid->set_values("WA", {0, 90, 180, 270, 360});
+
+  // Symmetric samplings span half a period at most, periodic samplings one period
+  ASSERT_ANY_THROW(dimension_grid->set_values("TWA", {-90, 0, 90, 180}));
+  ASSERT_ANY_THROW(dimension_grid->set_values("WA", {-180, 0, 270}));
+
+  auto polar_table = make_polar_table_double("VAR", "-", "VAR", dimension_grid);
+  size_t idx = 0;
+  for (const auto &dimension_point: dimension_grid->dimension_points()) {
+    // Same value at WA = 0 and WA = 360 as required for a closed periodic sampling
+    double WA_ = dimension_point[2] == 360. ? 0. : dimension_point[2];
+    polar_table->set_value(idx, dimension_point[0] + 0.01 * dimension_point[1] + 0.001 * WA_);
+    idx++;
+  }
+  auto dimension_set = dimension_grid->dimension_set();
+  auto interp = [&](double STW_, double TWA_, double WA_) {
+    return polar_table->interp(DimensionPoint(dimension_set, {STW_, TWA_, WA_}), ERROR);
+  };
+
+  // Raw relative angles are wrapped without out of bound errors
+  ASSERT_DOUBLE_EQ(interp(3., -40., 45.), interp(3., 40., 45.));
+  ASSERT_DOUBLE_EQ(interp(3., 320., 45.), interp(3., 40., 45.));
+  ASSERT_DOUBLE_EQ(interp(3., 200., 45.), interp(3., 160., 45.));
+  ASSERT_NEAR(interp(3., 40., 405.), interp(3., 40., 45.), 1e-12);
+  ASSERT_NEAR(interp(3., 40., -45.), interp(3., 40., 315.), 1e-12);
+  ASSERT_ANY_THROW(interp(11., 40., 45.));
+
+  // Batch, nearest and non throwing queries honor the periodicity as well
+  std::vector<double> STW_{3., 3., 3.};
+  std::vector<double> TWA_{-40., 320., 200.};
+  std::vector<double> WA_{405., -45., 45.};
+  std::vector<double> values(3);
+  polar_table->interp_batch({STW_.data(), TWA_.data(), WA_.data()}, 3, values.data(), ERROR);
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_DOUBLE_EQ(values[i], interp(STW_[i], TWA_[i], WA_[i]));
+  }
+
+  ASSERT_EQ(polar_table->nearest(DimensionPoint(dimension_set, {5., -55., -80.}), ERROR),
+            polar_table->nearest(DimensionPoint(dimension_set, {5., 60., 270.}), ERROR));
+
+  double value;
+  ASSERT_EQ(polar_table->query(DimensionPoint(dimension_set, {3., -40., 405.}), ERROR, value), IN_RANGE);
+  ASSERT_NEAR(value, interp(3., 40., 45.), 1e-12);
+
+  // A periodic sampling that is not closed is interpolated across the seam, between the last and the first values
+  auto open_grid = make_dimension_grid(make_dimension_set({STW, WA}));
+  open_grid->set_values("STW", {0, 5, 10});
+  open_grid->set_values("WA", {0, 60, 120, 180, 240, 300});
+  auto open_table = make_polar_table_double("VAR", "-", "VAR", open_grid);
+  idx = 0;
+  for (const auto &dimension_point: open_grid->dimension_points()) {
+    open_table->set_value(idx++, dimension_point[0] + std::cos(dimension_point[1] * M_PI / 180.));
+  }
+  auto open_set = open_grid->dimension_set();
+  auto open_interp = [&](double STW_, double WA_, INTERPOLATION_METHOD method) {
+    return open_table->interp(DimensionPoint(open_set, {STW_, WA_}), ERROR, method);
+  };
+  ASSERT_DOUBLE_EQ(open_interp(5., 330., LINEAR), 5. + 0.5 * (0.5 + 1.));
+  ASSERT_DOUBLE_EQ(open_interp(5., -30., LINEAR), open_interp(5., 330., LINEAR));
+  ASSERT_DOUBLE_EQ(open_interp(5., 690., LINEAR), open_interp(5., 330., LINEAR));
+  double open_value;
+  ASSERT_EQ(open_table->query(DimensionPoint(open_set, {5., 310.}), ERROR, open_value), IN_RANGE);
+  ASSERT_DOUBLE_EQ(open_value, open_interp(5., 310., LINEAR));
+  ASSERT_EQ(open_table->nearest(DimensionPoint(open_set, {5., 320.}), ERROR), open_table->values()[11]);
+  ASSERT_EQ(open_table->nearest(DimensionPoint(open_set, {5., 340.}), ERROR), open_table->values()[6]);
+
+  // Batches, with points in the wrap cell among others, and gradients across the seam
+  std::vector<double> open_STW{5., 2., 5., 7.5, 1.};
+  std::vector<double> open_WA{330., 45., 359., -10., 300.};
+  std::vector<double> open_values(open_STW.size());
+  open_table->interp_batch({open_STW.data(), open_WA.data()}, open_STW.size(), open_values.data(), ERROR);
+  for (size_t i = 0; i < open_STW.size(); ++i) {
+    ASSERT_DOUBLE_EQ(open_values[i], open_interp(open_STW[i], open_WA[i], LINEAR));
+  }
+  std::array<double, 2> open_gradient;
+  open_table->interp_with_gradient(DimensionPoint(open_set, {5., 330.}), open_gradient.data(), ERROR);
+  ASSERT_NEAR(open_gradient[1], (1. - 0.5) / 60., 1e-12);
+
+  // Cubic methods are C1 across the seam as well
+  double eps = 1e-6;
+  for (auto method: {CUBIC, PCHIP, AKIMA}) {
+    double left = (open_interp(5., 360., method) - open_interp(5., 360. - eps, method)) / eps;
+    double right = (open_interp(5., eps, method) - open_interp(5., 0., method)) / eps;
+    ASSERT_NEAR(left, right, 1e-4);
+    ASSERT_NEAR(open_interp(5., 330., method), 5. + std::cos(330. * M_PI / 180.), 0.05);
+  }
+
+  // Symmetric dimensions are mirrored about 0, whatever their first value
+  auto symmetric_grid = make_dimension_grid(make_dimension_set({TWA}));
+  symmetric_grid->set_values("TWA", {30, 60, 90, 135, 180});
+  ASSERT_ANY_THROW(symmetric_grid->set_values("TWA", {30, 90, 210}));
+  auto symmetric_table = make_polar_table_double("VAR", "-", "VAR", symmetric_grid);
+  for (size_t i = 0; i < symmetric_table->size(); ++i) {
+    symmetric_table->set_value(i, 0.01 * symmetric_grid->values(0)[i]);
+  }
+  auto symmetric_set = symmetric_grid->dimension_set();
+  auto symmetric_interp = [&](double TWA_, OUT_OF_BOUND_METHOD oob_method) {
+    return symmetric_table->interp(DimensionPoint(symmetric_set, {TWA_}), oob_method);
+  };
+  ASSERT_DOUBLE_EQ(symmetric_interp(-40., ERROR), 0.4);
+  ASSERT_DOUBLE_EQ(symmetric_interp(200., ERROR), 1.6);
+  ASSERT_DOUBLE_EQ(symmetric_interp(-160., ERROR), 1.6);
+  ASSERT_ANY_THROW(symmetric_interp(-10., ERROR));
+  ASSERT_ANY_THROW(symmetric_interp(350., ERROR));
+  ASSERT_DOUBLE_EQ(symmetric_interp(350., SATURATE), 0.3);
+}
+
+TEST(interpolation, cubic_methods) {
+  auto polar_table = make_trilinear_polar_table();
+  auto dimension_set = polar_table->dimension_grid()->dimension_set();
+  auto f = [](double STW, double TWS, double TWA) { return 2. * STW + 0.5 * TWS - 0.1 * TWA + 3.; };
+
+  // Every method reproduces affine functions and the values at nodes
+  std::vector<double> STW{1.3, 7.9, 4., 0.};
+  std::vector<double> TWS{12.5, 29., 20., 30.};
+  std::vector<double> TWA{33., 91., 45., 180.};
+  for (auto method: {LINEAR, CUBIC, PCHIP, AKIMA}) {
+    std::vector<double> values(STW.size());
+    polar_table->interp_batch({STW.data(), TWS.data(), TWA.data()}, STW.size(), values.data(), ERROR, method);
+    for (size_t i = 0; i < STW.size(); ++i) {
+      DimensionPoint dimension_point(dimension_set, {STW[i], TWS[i], TWA[i]});
+      ASSERT_NEAR(polar_table->interp(dimension_point, ERROR, method), f(STW[i], TWS[i], TWA[i]), 1e-10);
+      ASSERT_DOUBLE_EQ(values[i], polar_table->interp(dimension_point, ERROR, method));
+    }
+  }
+
+  // Mixed derivatives of products of affine functions are reproduced, the slopes being stored alone
+  auto g = [](double STW, double TWS, double TWA) { return (STW + 1.) * (TWS - 2.) * (0.01 * TWA + 1.); };
+  size_t idx = 0;
+  for (const auto &dimension_point: polar_table->dimension_grid()->dimension_points()) {
+    polar_table->set_value(idx, g(dimension_point[0], dimension_point[1], dimension_point[2]));
+    idx++;
+  }
+  for (auto method: {CUBIC, PCHIP, AKIMA}) {
+    for (size_t i = 0; i < STW.size(); ++i) {
+      DimensionPoint dimension_point(dimension_set, {STW[i], TWS[i], TWA[i]});
+      ASSERT_NEAR(polar_table->interp(dimension_point, ERROR, method), g(STW[i], TWS[i], TWA[i]), 1e-10);
+    }
+  }
+  // Values and 3 slopes per node for each of the 3 cubic methods
+  ASSERT_LT(polar_table->memsize(), (1 + 3 * 3) * polar_table->size() * sizeof(double) + 4096);
+
+}
+
+TEST(interpolation, cubic_smoothness) {
+  auto X = make_dimension("X", "-", "X");
+  auto Y = make_dimension("Y", "-", "Y");
+  auto dimension_grid = make_dimension_grid(make_dimension_set({X, Y}));
+  dimension_grid->set_values("X", {0., 0.5, 1.2, 2., 2.5, 3.1});
+  dimension_grid->set_values("Y", {0., 1., 2.});
+
+  auto g = [](double x, double y) { return std::sin(x) * (1. + 0.3 * y); };
+  auto polar_table = make_polar_table_double("VAR", "-", "VAR", dimension_grid);
+  size_t idx = 0;
+  for (const auto &dimension_point: dimension_grid->dimension_points()) {
+    polar_table->set_value(idx, g(dimension_point[0], dimension_point[1]));
+    idx++;
+  }
+  auto dimension_set = dimension_grid->dimension_set();
+  auto interp = [&](double x, double y, INTERPOLATION_METHOD method) {
+    return polar_table->interp(DimensionPoint(dimension_set, {x, y}), ERROR, method);
+  };
+
+  // Left and right derivatives across the node x = 1.2 agree for cubic methods, not for LINEAR
+  double eps = 1e-6;
+  for (auto method: {CUBIC, PCHIP, AKIMA}) {
+    double left = (interp(1.2, 0.7, method) - interp(1.2 - eps, 0.7, method)) / eps;
+    double right = (interp(1.2 + eps, 0.7, method) - interp(1.2, 0.7, method)) / eps;
+    ASSERT_NEAR(left, right, 1e-4);
+  }
+  double left = (interp(1.2, 0.7, LINEAR) - interp(1.2 - eps, 0.7, LINEAR)) / eps;
+  double right = (interp(1.2 + eps, 0.7, LINEAR) - interp(1.2, 0.7, LINEAR)) / eps;
+  ASSERT_GT(std::abs(left - right), 0.1);
+
+  // Cubic spline is more accurate than multilinear on a smooth function
+  double error_linear = 0.;
+  double error_cubic = 0.;
+  for (double x = 0.3; x < 2.9; x += 0.1) {
+    error_linear = std::max(error_linear, std::abs(interp(x, 1.5, LINEAR) - g(x, 1.5)));
+    error_cubic = std::max(error_cubic, std::abs(interp(x, 1.5, CUBIC) - g(x, 1.5)));
+  }
+  ASSERT_LT(error_cubic, 0.2 * error_linear);
+
+  // PCHIP does not overshoot monotone data, where the cubic spline does
+  for (size_t i = 0; i < polar_table->size(); ++i) {
+    polar_table->set_value(i, dimension_grid->dimension_points()[i][0] < 1.5 ? 0. : 1.);
+  }
+  double min_pchip = 0., max_pchip = 1., min_cubic = 0., max_cubic = 1.;
+  for (double x = 0.; x <= 3.1; x += 0.01) {
+    min_pchip = std::min(min_pchip, interp(x, 1., PCHIP));
+    max_pchip = std::max(max_pchip, interp(x, 1., PCHIP));
+    min_cubic = std::min(min_cubic, interp(x, 1., CUBIC));
+    max_cubic = std::max(max_cubic, interp(x, 1., CUBIC));
+  }
+  ASSERT_EQ(min_pchip, 0.);
+  ASSERT_EQ(max_pchip, 1.);
+  ASSERT_TRUE(min_cubic < 0. || max_cubic > 1.);
+
+  // Per table method, slopes being computed again after values change
+  polar_table->set_interpolation_method(PCHIP);
+  double value;
+  ASSERT_EQ(polar_table->query(DimensionPoint(dimension_set, {1.4, 1.}), ERROR, value), IN_RANGE);
+  ASSERT_DOUBLE_EQ(value, interp(1.4, 1., PCHIP));
+  polar_table->multiply_by(2.);
+  ASSERT_DOUBLE_EQ(polar_table->interp(DimensionPoint(dimension_set, {1.4, 1.}), ERROR), 2. * value);
+
+  auto polar_table_int = make_polar_table_int("INT", "-", "INT", dimension_grid);
+  ASSERT_ANY_THROW(polar_table_int->set_interpolation_method(CUBIC));
+}
+
+TEST(interpolation, interp_with_gradient) {
+  // Exact gradient of affine functions, null along the singleton dimension, for compile time and runtime dimensions
+  for (size_t ndims = 1; ndims <= 8; ++ndims) {
+    auto polar_table = make_affine_polar_table(ndims);
+    auto dimension_set = polar_table->dimension_grid()->dimension_set();
+    std::vector<double> coords(ndims, 2.2);
+    if (ndims > 1) coords[1] = 0.5;
+    DimensionPoint dimension_point(dimension_set, coords);
+    for (auto method: {LINEAR, CUBIC, PCHIP, AKIMA}) {
+      if (method != LINEAR && ndims > POEM_MAX_SPLINE_DIMS) continue;
+      std::vector<double> gradient(ndims);
+      double value = polar_table->interp_with_gradient(dimension_point, gradient.data(), ERROR, method);
+      ASSERT_NEAR(value, polar_table->interp(dimension_point, ERROR, method), 1e-12);
+      for (size_t idim = 0; idim < ndims; ++idim) {
+        ASSERT_NEAR(gradient[idim], idim == 1 ? 0. : (double) (idim + 1), 1e-10);
+      }
+    }
+  }
+
+  // Analytic gradient of the interpolant agrees with its finite differences inside cells, single and batch
+  auto X = make_dimension("X", "-", "X");
+  auto Y = make_dimension("Y", "-", "Y");
+  auto dimension_grid = make_dimension_grid(make_dimension_set({X, Y}));
+  dimension_grid->set_values("X", {0., 0.5, 1.2, 2., 2.5, 3.1});
+  dimension_grid->set_values("Y", {0., 1., 2.});
+  auto polar_table = make_polar_table_double("VAR", "-", "VAR", dimension_grid);
+  size_t idx = 0;
+  for (const auto &dimension_point: dimension_grid->dimension_points()) {
+    polar_table->set_value(idx, std::sin(dimension_point[0]) * (1. + 0.3 * dimension_point[1] * dimension_point[1]));
+    idx++;
+  }
+  auto dimension_set = dimension_grid->dimension_set();
+
+  std::vector<double> x{0.2, 1.7, 2.8, 1.};
+  std::vector<double> y{0.3, 1.4, 1.9, 0.6};
+  double eps = 1e-6;
+  for (auto method: {LINEAR, CUBIC, PCHIP, AKIMA}) {
+    std::vector<double> values(x.size()), dx(x.size()), dy(x.size());
+    polar_table->interp_with_gradient_batch({x.data(), y.data()}, x.size(), values.data(), {dx.data(), dy.data()},
+                                            ERROR, method);
+    for (size_t i = 0; i < x.size(); ++i) {
+      auto interp = [&](double x_, double y_) {
+        return polar_table->interp(DimensionPoint(dimension_set, {x_, y_}), ERROR, method);
+      };
+      std::array<double, 2> gradient;
+      double value = polar_table->interp_with_gradient(DimensionPoint(dimension_set, {x[i], y[i]}), gradient.data(),
+                                                       ERROR, method);
+      ASSERT_NEAR(value, interp(x[i], y[i]), 1e-12);
+      ASSERT_NEAR(gradient[0], (interp(x[i] + eps, y[i]) - interp(x[i] - eps, y[i])) / (2. * eps), 1e-6);
+      ASSERT_NEAR(gradient[1], (interp(x[i], y[i] + eps) - interp(x[i], y[i] - eps)) / (2. * eps), 1e-6);
+      ASSERT_DOUBLE_EQ(values[i], value);
+      ASSERT_DOUBLE_EQ(dx[i], gradient[0]);
+      ASSERT_DOUBLE_EQ(dy[i], gradient[1]);
+    }
+  }
+
+  // Saturated coordinates have a null derivative, extrapolated ones keep the slope of the last cell
+  std::array<double, 2> gradient;
+  polar_table->interp_with_gradient(DimensionPoint(dimension_set, {4., 1.5}), gradient.data(), SATURATE);
+  ASSERT_EQ(gradient[0], 0.);
+  ASSERT_NE(gradient[1], 0.);
+  polar_table->interp_with_gradient(DimensionPoint(dimension_set, {4., 1.5}), gradient.data(), EXTRAPOLATE);
+  ASSERT_NEAR(gradient[0], (polar_table->interp(DimensionPoint(dimension_set, {3.1, 1.5}), ERROR) -
+                            polar_table->interp(DimensionPoint(dimension_set, {2.5, 1.5}), ERROR)) / 0.6, 1e-12);
+  ASSERT_ANY_THROW(polar_table->interp_with_gradient(DimensionPoint(dimension_set, {4., 1.5}), gradient.data(),
+                                                     ERROR));
+
+  // Derivative with respect to the raw coordinate on a symmetric dimension, mirrored on the negative side
+  auto TWA = make_dimension("TWA", "deg", "True Wind Angle", SYMMETRIC);
+  auto symmetric_grid = make_dimension_grid(make_dimension_set({TWA}));
+  symmetric_grid->set_values("TWA", {0., 45., 90., 180.});
+  auto symmetric_table = make_polar_table_double("VAR", "-", "VAR", symmetric_grid);
+  for (size_t i = 0; i < symmetric_table->size(); ++i) {
+    symmetric_table->set_value(i, 0.01 * symmetric_grid->values(0)[i]);
+  }
+  auto symmetric_set = symmetric_grid->dimension_set();
+  double derivative;
+  symmetric_table->interp_with_gradient(DimensionPoint(symmetric_set, {40.}), &derivative, ERROR);
+  ASSERT_NEAR(derivative, 0.01, 1e-12);
+  symmetric_table->interp_with_gradient(DimensionPoint(symmetric_set, {-40.}), &derivative, ERROR);
+  ASSERT_NEAR(derivative, -0.01, 1e-12);
+
+  auto polar_table_int = make_polar_table_int("INT", "-", "INT", dimension_grid);
+  ASSERT_ANY_THROW(polar_table_int->interp_with_gradient(DimensionPoint(dimension_set, {1., 1.}), gradient.data(),
+                                                         ERROR));
+}
+
+TEST(interpolation, query_cache) {
+  auto polar_table = make_trilinear_polar_table();
+  auto dimension_set = polar_table->dimension_grid()->dimension_set();
+  auto f = [](double STW, double TWS, double TWA) { return 2. * STW + 0.5 * TWS - 0.1 * TWA + 3.; };
+  auto interp = [&](double STW, double TWS, double TWA, OUT_OF_BOUND_METHOD oob_method = ERROR) {
+    return polar_table->interp(DimensionPoint(dimension_set, {STW, TWS, TWA}), oob_method);
+  };
+
+  ASSERT_ANY_THROW(polar_table->enable_cache(16, {{"Hs", 0.5}}));
+  ASSERT_ANY_THROW(polar_table->enable_cache(0));
+  polar_table->enable_cache(16, {{"STW", 0.5}, {"TWA", 1.}});
+  auto cache = polar_table->cache();
+
+  // Values are computed at the snapped coordinates, close coordinates hitting the same entry
+  ASSERT_DOUBLE_EQ(interp(1.3, 12.5, 33.2), f(1.5, 12.5, 33.));
+  ASSERT_DOUBLE_EQ(interp(1.4, 12.5, 32.9), f(1.5, 12.5, 33.));
+  ASSERT_EQ(cache->misses(), 1);
+  ASSERT_EQ(cache->hits(), 1);
+
+  // TWS has an exact key, the out of bound method is part of the key
+  interp(1.4, 12.6, 33.);
+  interp(1.4, 12.5, 33., SATURATE);
+  ASSERT_EQ(cache->misses(), 3);
+  ASSERT_EQ(cache->size(), 3);
+  ASSERT_ANY_THROW(interp(9., 12.5, 33.));
+  ASSERT_EQ(cache->size(), 3);
+
+  // Modifying the table clears the cache
+  polar_table->multiply_by(2.);
+  ASSERT_EQ(cache->size(), 0);
+  ASSERT_DOUBLE_EQ(interp(1.4, 12.5, 32.9), 2. * f(1.5, 12.5, 33.));
+
+  // Bounded size, with CLOCK eviction
+  cache->reset_counters();
+  for (size_t i = 0; i < 200; ++i) {
+    interp(0.01 * (double) i, 12.5, 33.);
+  }
+  ASSERT_LE(cache->size(), 16);
+  ASSERT_EQ(cache->hits() + cache->misses(), 200);
+
+  // Concurrent queries give the values at the snapped coordinates
+  std::vector<std::thread> threads;
+  std::atomic<bool> ok(true);
+  for (size_t ithread = 0; ithread < 4; ++ithread) {
+    threads.emplace_back([&, ithread]() {
+      for (size_t i = 0; i < 1000; ++i) {
+        // Working set of 8 keys, within the capacity
+        double STW = 0.1 * (double) ((i + ithread) % 8);
+        double TWA = 10. * (double) (i % 4);
+        if (std::abs(interp(STW, 10., TWA) - 2. * f(std::round(STW / 0.5) * 0.5, 10., TWA)) > 1e-12) ok = false;
+      }
+    });
+  }
+  for (auto &thread: threads) thread.join();
+  ASSERT_TRUE(ok);
+  ASSERT_GT(cache->hit_rate(), 0.5);
+
+  polar_table->disable_cache();
+  ASSERT_EQ(polar_table->cache(), nullptr);
+  ASSERT_DOUBLE_EQ(interp(1.3, 12.5, 33.2), 2. * f(1.3, 12.5, 33.2));
+
+  auto polar_table_int = make_polar_table_int("INT", "-", "INT", polar_table->dimension_grid());
+  ASSERT_ANY_THROW(polar_table_int->enable_cache(16));
+
+  // Fused query of a Polar
+  auto polar = make_polar("MPPP", MPPP, polar_table->dimension_grid());
+  polar->attach_polar_table(polar_table);
+  polar->attach_polar_table(polar_table_int);
+  auto query = polar->query({"VAR", "INT"});
+  query.enable_cache(8, {{"TWS", 5.}});
+  auto results = query.interp(DimensionPoint(dimension_set, {1.3, 12.4, 33.}), ERROR);
+  ASSERT_DOUBLE_EQ(results[0], 2. * f(1.3, 10., 33.));
+  ASSERT_EQ(results, query.interp(DimensionPoint(dimension_set, {1.3, 11.9, 33.}), ERROR));
+  ASSERT_EQ(query.cache()->hits(), 1);
+  ASSERT_EQ(query.cache()->misses(), 1);
+
+  // Modifying a PolarTable of the query clears its cache
+  polar_table->multiply_by(0.5);
+  results = query.interp(DimensionPoint(dimension_set, {1.3, 12.4, 33.}), ERROR);
+  ASSERT_DOUBLE_EQ(results[0], f(1.3, 10., 33.));
+  ASSERT_EQ(query.cache()->misses(), 2);
+  ASSERT_EQ(query.cache()->size(), 1);
+
+  // Coordinates in the grid are not snapped out of it
+  auto STW = make_dimension("STW", "kt", "Speed Through Water");
+  auto edge_grid = make_dimension_grid(make_dimension_set({STW}));
+  edge_grid->set_values("STW", {0., 10., 20., 29.7});
+  auto edge_table = make_polar_table_double("VAR", "-", "VAR", edge_grid);
+  for (size_t i = 0; i < 4; ++i) {
+    edge_table->set_value(i, 2. * edge_grid->values(0)[i]);
+  }
+  auto edge_set = edge_grid->dimension_set();
+  edge_table->enable_cache(16, {{"STW", 1.}});
+  ASSERT_DOUBLE_EQ(edge_table->interp(DimensionPoint(edge_set, {29.6}), ERROR), 2. * 29.7);
+  ASSERT_DOUBLE_EQ(edge_table->interp(DimensionPoint(edge_set, {29.6}), EXTRAPOLATE), 2. * 29.7);
+  ASSERT_DOUBLE_EQ(edge_table->interp(DimensionPoint(edge_set, {29.6}), SATURATE), 2. * 29.7);
+  // Out of the grid, the same quantized coordinate is another entry computed at the snapped coordinate
+  ASSERT_ANY_THROW(edge_table->interp(DimensionPoint(edge_set, {29.8}), ERROR));
+  ASSERT_DOUBLE_EQ(edge_table->interp(DimensionPoint(edge_set, {29.8}), EXTRAPOLATE), 2. * 30.);
+}
+
+TEST(interpolation, polar_curve) {
+  auto STW = make_dimension("STW", "kt", "Speed Through Water");
+  auto TWS = make_dimension("TWS", "kt", "True Wind Speed");
+  auto TWA = make_dimension("TWA", "deg", "True Wind Angle");
+  auto Hs = make_dimension("Hs", "m", "Waves Significant Height");
+  auto dimension_grid = make_dimension_grid(make_dimension_set({TWS, STW, TWA, Hs}));
+  dimension_grid->set_values("TWS", {0., 10., 20.});
+  dimension_grid->set_values("STW", {0., 1., 3., 3.5, 8.});
+  dimension_grid->set_values("TWA", mathutils::linspace(0., 180., 13));
+  dimension_grid->set_values("Hs", {0., 2., 5.});
+
+  auto polar = make_polar("MPPP", MPPP, dimension_grid);
+  auto power = polar->create_polar_table<double>("TOTAL_POWER", "kW", "Total power", POEM_DOUBLE);
+  auto leeway = polar->create_polar_table<double>("LEEWAY", "deg", "Leeway", POEM_DOUBLE);
+  auto status = polar->create_polar_table<int>("SOLVER_STATUS", "-", "Solver status", POEM_INT);
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(0., 1.);
+  for (size_t idx = 0; idx < power->size(); ++idx) {
+    power->set_value(idx, 1000. * distribution(generator));
+    leeway->set_value(idx, distribution(generator));
+    status->set_value(idx, (int) idx % 3);
+  }
+
+  std::vector<std::string> names = {"SOLVER_STATUS", "TOTAL_POWER", "LEEWAY"};
+  auto query = polar->query(names);
+  auto curve = polar->curve(names, "STW");
+  ASSERT_EQ(curve.size(), 3);
+  ASSERT_EQ(curve.free_dimension_index(), 1);
+  ASSERT_ANY_THROW(curve.interp(1., ERROR));
+  ASSERT_ANY_THROW(polar->curve(names, "WA"));
+
+  // Same results as the full query along the free dimension, for several environments
+  std::vector<double> stw = {0., 0.4, 2.1, 3.2, 3.25, 7.9, 8., 9., -1.};
+  for (const auto &environment: std::vector<std::array<double, 3>>{{12.5, 33., 1.}, {0., 180., 5.}, {19., 95., 0.}}) {
+    curve.bind({{"TWS", environment[0]}, {"TWA", environment[1]}, {"Hs", environment[2]}}, ERROR);
+    for (auto oob_method: {SATURATE, EXTRAPOLATE}) {
+      std::vector<std::vector<double>> results(names.size(), std::vector<double>(stw.size()));
+      curve.interp_batch(stw.data(), stw.size(), {results[0].data(), results[1].data(), results[2].data()},
+                         oob_method);
+      for (size_t i = 0; i < stw.size(); ++i) {
+        auto expected = query.interp(DimensionPoint(dimension_grid->dimension_set(),
+                                                    {environment[0], stw[i], environment[1], environment[2]}),
+                                     oob_method);
+        auto values = curve.interp(stw[i], oob_method);
+        ASSERT_EQ(values[0], expected[0]);
+        for (size_t itable = 1; itable < names.size(); ++itable) {
+          ASSERT_NEAR(values[itable], expected[itable], 1e-9);
+          ASSERT_EQ(results[itable][i], values[itable]);
+        }
+      }
+    }
+    ASSERT_ANY_THROW(curve.interp(9., ERROR));
+  }
+
+  ASSERT_ANY_THROW(curve.bind({{"TWS", 12.5}, {"TWA", 33.}}, ERROR));
+  ASSERT_ANY_THROW(curve.bind({{"TWS", 12.5}, {"TWA", 33.}, {"Hs", 1.}, {"STW", 1.}}, ERROR));
+  ASSERT_ANY_THROW(curve.bind({{"TWS", 25.}, {"TWA", 33.}, {"Hs", 1.}}, ERROR));
+  ASSERT_FALSE(curve.is_bound());
+
+  // Cubic tables do not collapse onto the nodes of the free dimension
+  leeway->set_interpolation_method(CUBIC);
+  ASSERT_THROW(curve.bind({{"TWS", 12.5}, {"TWA", 33.}, {"Hs", 1.}}, ERROR), PoemException);
+  ASSERT_FALSE(curve.is_bound());
+}
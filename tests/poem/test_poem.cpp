@@ -5,10 +5,13 @@
 #include <gtest/gtest.h>
 #include <netcdf>
 #include <fstream>
+#include <thread>
 
 #include <MathUtils/VectorGeneration.h>
+#include <hdf5.h>
 
 #include "poem/poem.h"
+#include "poem/ChunkReader.h"
 
 using namespace poem;
 
@@ -294,6 +297,180 @@ TEST(poem, PolarNode) {
 
   ASSERT_EQ(*vessel_, *vessel_2);
 
+  // Metadata read in a single traversal, then checked against every rule
+  {
+    netCDF::NcFile file("poem_testing_spec_v1.nc", netCDF::NcFile::read);
+    auto metadata = v1::read_metadata(file);
+    ASSERT_TRUE(v1::check(metadata).compliant());
+    ASSERT_EQ(metadata.attribute("VESSEL_NAME"), "vessel");
+    ASSERT_EQ(metadata.groups.size(), 2);
+  }
+
+  // Non compliant POEM_MODE and missing description, every violation being reported
+  to_netcdf(vessel, "vessel", "poem_testing_spec_v1_bad_mode.nc", false);
+  {
+    netCDF::NcFile file("poem_testing_spec_v1_bad_mode.nc", netCDF::NcFile::write);
+    file.getGroup("laden_load").getGroup("laden_one_engine").getGroup("MPPP").putAtt("POEM_MODE", "XXXX");
+    auto nc_var = file.getGroup("ballast_load").getGroup("ballast_one_engine").getGroup("MPPP").getVar("LEEWAY");
+    nc_del_att(nc_var.getParentGroup().getId(), nc_var.getId(), "description");
+  }
+  auto report = check_v1_report("poem_testing_spec_v1_bad_mode.nc");
+  ASSERT_FALSE(report.compliant());
+  ASSERT_EQ(report.violated_rules(), std::vector<int>({4, 5}));
+  for (const auto &violation: report.violations) {
+    if (violation.rule == 4) {
+      ASSERT_EQ(violation.group, "/laden_load/laden_one_engine/MPPP");
+      ASSERT_TRUE(violation.variable.empty());
+    } else {
+      ASSERT_EQ(violation.group, "/ballast_load/ballast_one_engine/MPPP");
+      ASSERT_EQ(violation.variable, "LEEWAY");
+    }
+  }
+  ASSERT_FALSE(check_v1("poem_testing_spec_v1_bad_mode.nc"));
+  ASSERT_THROW(load("poem_testing_spec_v1_bad_mode.nc", true, false), PoemException);
+
+  // Values read by parallel chunk decompression
+  auto vessel_chunks = load("poem_testing_spec_v1.nc", true, true, false, false, 4);
+  ASSERT_EQ(*vessel_chunks, *vessel_);
+
+  // Chunks made of STW x TWA planes, TOTAL_POWER being stored uncompressed
+  WriteOptions write_options;
+  write_options.polar_tables = StorageOptions::whole({"STW_dim", "TWA_dim"}, 1);
+  write_options.per_polar_table["TOTAL_POWER"] = StorageOptions::uncompressed();
+  to_netcdf(vessel, "vessel", "poem_testing_spec_v1_planes.nc", false, write_options);
+  {
+    netCDF::NcFile file("poem_testing_spec_v1_planes.nc", netCDF::NcFile::read);
+    auto MPPP_group = file.getGroup("ballast_load").getGroup("ballast_one_engine").getGroup("MPPP");
+    netCDF::NcVar::ChunkMode chunk_mode;
+    std::vector<size_t> chunk_lengths;
+    bool shuffle, deflate;
+    int deflate_level;
+
+    // Contiguous, without any filter
+    auto total_power = MPPP_group.getVar("TOTAL_POWER");
+    total_power.getChunkingParameters(chunk_mode, chunk_lengths);
+    ASSERT_EQ(chunk_mode, netCDF::NcVar::nc_CONTIGUOUS);
+    total_power.getCompressionParameters(shuffle, deflate, deflate_level);
+    ASSERT_FALSE(shuffle);
+    ASSERT_FALSE(deflate);
+
+    // Whole STW_dim x TWA_dim planes, deflate level 1 with shuffle
+    auto leeway = MPPP_group.getVar("LEEWAY");
+    leeway.getChunkingParameters(chunk_mode, chunk_lengths);
+    ASSERT_EQ(chunk_mode, netCDF::NcVar::nc_CHUNKED);
+    // Dimensions STW_dim, TWS_dim, TWA_dim, WA_dim, Hs_dim
+    ASSERT_EQ(chunk_lengths, std::vector<size_t>({13, 1, 13, 1, 1}));
+    leeway.getCompressionParameters(shuffle, deflate, deflate_level);
+    ASSERT_TRUE(shuffle);
+    ASSERT_TRUE(deflate);
+    ASSERT_EQ(deflate_level, 1);
+  }
+  ASSERT_EQ(*load("poem_testing_spec_v1_planes.nc"), *vessel_);
+  ASSERT_EQ(*load("poem_testing_spec_v1_planes.nc", true, true, false, false, 4), *vessel_);
+
+  // Snapshot of the tree, written back to netCDF
+  to_snapshot(vessel_, "poem_testing_spec_v1.poem");
+  auto vessel_snapshot = load_snapshot("poem_testing_spec_v1.poem");
+  ASSERT_EQ(*vessel_snapshot, *vessel_);
+  to_netcdf(vessel_snapshot, "vessel", "poem_testing_spec_v1_snapshot.nc");
+  ASSERT_EQ(*load("poem_testing_spec_v1_snapshot.nc"), *vessel_);
+
+  // Values fetched on first access
+  auto vessel_jit = load("poem_testing_spec_v1.nc", true, true, false, true);
+  auto total_power = vessel_jit->polar_node_from_path("vessel/ballast_load/ballast_one_engine/MPPP/TOTAL_POWER")
+      ->as_polar_table()->as_polar_table_double();
+  ASSERT_TRUE(total_power->has_jit_loader());
+  ASSERT_FALSE(total_power->is_loaded());
+  ASSERT_EQ(*vessel_jit, *vessel_);
+  ASSERT_TRUE(total_power->is_loaded());
+  total_power->jit_unload();
+  ASSERT_FALSE(total_power->is_loaded());
+  ASSERT_EQ(*vessel_jit, *vessel_);
+
+  // JIT queries serialized with concurrent writes and loads by netcdf_mutex
+  std::thread writer([&]() {
+    for (int i = 0; i < 4; ++i) {
+      to_netcdf(vessel_, "vessel", "poem_testing_spec_v1_concurrent.nc", false);
+      ASSERT_EQ(*load("poem_testing_spec_v1_concurrent.nc", true, false), *vessel_);
+    }
+  });
+  for (int i = 0; i < 20; ++i) {
+    total_power->jit_unload();
+    ASSERT_EQ(*total_power, *vessel_->polar_node_from_path("vessel/ballast_load/ballast_one_engine/MPPP/TOTAL_POWER")
+        ->as_polar_table()->as_polar_table_double());
+  }
+  writer.join();
+
+}
+
+TEST(poem, periodic_dimension_io) {
+  auto dimension_set = make_dimension_set({make_dimension("STW_dim", "kt", "Speed Through Water"),
+                                           make_dimension("TWS_dim", "kt", "True Wind Speed"),
+                                           make_dimension("TWA_dim", "deg", "True Wind Angle", SYMMETRIC),
+                                           make_dimension("WA_dim", "deg", "Mean Waves Angle", PERIODIC),
+                                           make_dimension("Hs_dim", "m", "Waves Significant Height")});
+  auto dimension_grid = make_dimension_grid(dimension_set);
+  dimension_grid->set_values("STW_dim", mathutils::linspace<double>(0, 20, 5));
+  dimension_grid->set_values("TWS_dim", mathutils::linspace<double>(0, 40, 3));
+  // Symmetric sampling not starting at 0
+  dimension_grid->set_values("TWA_dim", mathutils::linspace<double>(30, 180, 6));
+  // Closed periodic sampling, over the full circle
+  dimension_grid->set_values("WA_dim", mathutils::linspace<double>(0, 360, 9));
+  dimension_grid->set_values("Hs_dim", mathutils::linspace<double>(0, 4, 3));
+
+  auto polar_set = make_polar_set("vessel", "Vessel with periodic waves angle");
+  polar_set->create_polar(MPPP, dimension_grid);
+  auto polar = polar_set->polar(MPPP);
+  auto total_power = polar->create_polar_table<double>("TOTAL_POWER", "kW", "Total Power", POEM_DOUBLE);
+  polar->create_polar_table<double>("LEEWAY", "deg", "Leeway", POEM_DOUBLE)->fill_with(1.);
+  polar->create_polar_table<int>("SOLVER_STATUS", "-", "Solver Status", POEM_INT)->fill_with(0);
+  size_t idx = 0;
+  for (const auto &dimension_point: dimension_grid->dimension_points()) {
+    double WA = dimension_point[3] == 360. ? 0. : dimension_point[3];
+    total_power->set_value(idx++, 100. * dimension_point[0] + std::cos(WA * M_PI / 180.));
+  }
+
+  to_netcdf(polar_set, "vessel", "poem_testing_periodic.nc", false);
+  ASSERT_TRUE(check_v1("poem_testing_periodic.nc"));
+
+  // Loaded with spec checking
+  auto polar_set_ = load("poem_testing_periodic.nc", true, false);
+  ASSERT_EQ(*polar_set_, *std::static_pointer_cast<PolarNode>(polar_set));
+  auto dimension_set_ = polar_set_->as_polar_set()->polar(MPPP)->dimension_grid()->dimension_set();
+  ASSERT_EQ(dimension_set_->dimension("WA_dim")->periodicity(), PERIODIC);
+  ASSERT_EQ(dimension_set_->dimension("TWA_dim")->periodicity(), SYMMETRIC);
+
+  // Without periodicity, angles above 180 deg are not compliant
+  dimension_set = make_dimension_set({make_dimension("STW_dim", "kt", "Speed Through Water"),
+                                      make_dimension("TWS_dim", "kt", "True Wind Speed"),
+                                      make_dimension("TWA_dim", "deg", "True Wind Angle"),
+                                      make_dimension("WA_dim", "deg", "Mean Waves Angle"),
+                                      make_dimension("Hs_dim", "m", "Waves Significant Height")});
+  auto non_periodic_grid = make_dimension_grid(dimension_set);
+  for (size_t idim = 0; idim < dimension_set->size(); ++idim) {
+    non_periodic_grid->set_values(dimension_set->name(idim), dimension_grid->values(idim));
+  }
+  auto non_periodic_set = make_polar_set("vessel", "Vessel with non periodic waves angle");
+  non_periodic_set->create_polar(MPPP, non_periodic_grid);
+  for (const auto &name: {"TOTAL_POWER", "LEEWAY"}) {
+    non_periodic_set->polar(MPPP)->create_polar_table<double>(name, "-", name, POEM_DOUBLE)->fill_with(1.);
+  }
+  non_periodic_set->polar(MPPP)->create_polar_table<int>("SOLVER_STATUS", "-", "Solver Status", POEM_INT)
+      ->fill_with(0);
+  to_netcdf(non_periodic_set, "vessel", "poem_testing_non_periodic.nc", false);
+  auto report = check_v1_report("poem_testing_non_periodic.nc");
+  ASSERT_EQ(report.violated_rules(), std::vector<int>({6}));
+  ASSERT_EQ(report.violations.front().variable, "WA_dim");
+
+  // Symmetric values are mirrored about 0, not about their first value: they may not exceed half the period
+  {
+    netCDF::NcFile file("poem_testing_periodic.nc", netCDF::NcFile::write);
+    auto TWA = mathutils::linspace<double>(60, 210, 6);
+    file.getGroup("MPPP").getVar("TWA_dim").putVar(TWA.data());
+  }
+  auto symmetric_report = check_v1_report("poem_testing_periodic.nc");
+  ASSERT_EQ(symmetric_report.violated_rules(), std::vector<int>({6}));
+  ASSERT_EQ(symmetric_report.violations.front().variable, "TWA_dim");
 }
 
 TEST(poem, read_poem_v0_example) {
@@ -363,3 +540,677 @@ TEST(poem, read_poem_v0_example) {
 //  std::cout << layout.dump(2) << std::endl;
 //
 //}
+
+TEST(poem, velocity_polar) {
+  auto STW_dim = make_dimension("STW_dim", "kt", "Speed Through Water");
+  auto TWS_dim = make_dimension("TWS_dim", "kt", "True Wind Speed");
+  auto TWA_dim = make_dimension("TWA_dim", "deg", "True Wind Angle");
+  auto WA_dim = make_dimension("WA_dim", "deg", "Waves Angle");
+  auto Hs_dim = make_dimension("Hs_dim", "m", "Waves Significant Height");
+
+  auto dimension_grid = make_dimension_grid(make_dimension_set({STW_dim, TWS_dim, TWA_dim, WA_dim, Hs_dim}));
+  dimension_grid->set_values("STW_dim", mathutils::linspace<double>(8, 20, 13));
+  dimension_grid->set_values("TWS_dim", mathutils::linspace<double>(0, 40, 5));
+  dimension_grid->set_values("TWA_dim", mathutils::linspace<double>(0, 180, 5));
+  dimension_grid->set_values("WA_dim", mathutils::linspace<double>(0, 180, 3));
+  dimension_grid->set_values("Hs_dim", mathutils::linspace<double>(0, 8, 3));
+
+  auto power_polar = make_polar("MPPP", MPPP, dimension_grid);
+  auto total_power = power_polar->create_polar_table<double>("TOTAL_POWER", "kW", "Total Power", POEM_DOUBLE);
+  auto leeway = power_polar->create_polar_table<double>("LEEWAY", "deg", "Leeway", POEM_DOUBLE);
+  auto solver_status = power_polar->create_polar_table<int>("SOLVER_STATUS", "-", "Solver Status", POEM_INT);
+  size_t idx = 0;
+  for (const auto &dimension_point: dimension_grid->dimension_points()) {
+    double STW = dimension_point[0];
+    double Hs = dimension_point[4];
+    total_power->set_value(idx, 10. * STW * STW * STW * (1. + 0.02 * dimension_point[1]) * (1. + 0.1 * Hs));
+    leeway->set_value(idx, 0.1 * STW + 0.01 * dimension_point[2]);
+    // Highest speed not reached in the highest waves
+    solver_status->set_value(idx, Hs == 8. && STW == 20. ? 1 : 0);
+    idx++;
+  }
+
+  auto power_values = mathutils::linspace<double>(1000., 300000., 40);
+  auto velocity_polar = make_velocity_polar(*power_polar, power_values);
+  ASSERT_EQ(velocity_polar->mode(), MVPP);
+  ASSERT_EQ(velocity_polar->name(), "MVPP");
+  auto new_dimension_set = velocity_polar->dimension_grid()->dimension_set();
+  ASSERT_EQ(new_dimension_set->name(0), "Power_dim");
+  ASSERT_EQ(new_dimension_set->dimension(1), TWS_dim);
+
+  auto STW = velocity_polar->polar_table("STW")->as_polar_table_double();
+  auto new_leeway = velocity_polar->polar_table("LEEWAY")->as_polar_table_double();
+  auto new_solver_status = velocity_polar->polar_table("SOLVER_STATUS")->as_polar_table_int();
+
+  // The power polar gives back the power at the inverted speed, leeway being taken at that speed
+  auto dimension_set = dimension_grid->dimension_set();
+  size_t n_success = 0, n_below = 0, n_above = 0;
+  idx = 0;
+  for (const auto &dimension_point: velocity_polar->dimension_grid()->dimension_points()) {
+    double power = dimension_point[0];
+    DimensionPoint power_point(dimension_set, {STW->data()[idx], dimension_point[1], dimension_point[2],
+                                               dimension_point[3], dimension_point[4]});
+    switch (new_solver_status->data()[idx]) {
+      case INVERSION_SUCCESS:
+        ASSERT_NEAR(total_power->interp(power_point, ERROR), power, 1e-9 * power);
+        ASSERT_NEAR(leeway->interp(power_point, ERROR), new_leeway->data()[idx], 1e-12);
+        if (dimension_point[4] == 8.) ASSERT_LE(STW->data()[idx], 19.);
+        n_success++;
+        break;
+      case POWER_BELOW_RANGE:
+        ASSERT_EQ(STW->data()[idx], 8.);
+        ASSERT_LT(power, total_power->interp(power_point, ERROR));
+        n_below++;
+        break;
+      case POWER_ABOVE_RANGE:
+        ASSERT_EQ(STW->data()[idx], dimension_point[4] == 8. ? 19. : 20.);
+        ASSERT_GT(power, total_power->interp(power_point, ERROR));
+        n_above++;
+        break;
+      default:
+        FAIL();
+    }
+    idx++;
+  }
+  ASSERT_GT(n_success, 0);
+  ASSERT_GT(n_below, 0);
+  ASSERT_GT(n_above, 0);
+
+  // Same result whatever the number of threads
+  auto velocity_polar_1 = make_velocity_polar(*power_polar, power_values, 1);
+  for (const auto &name: {"STW", "LEEWAY"}) {
+    const auto &values = velocity_polar->polar_table(name)->as_polar_table_double()->values();
+    ASSERT_EQ(velocity_polar_1->polar_table(name)->as_polar_table_double()->values(), values);
+  }
+  ASSERT_EQ(velocity_polar_1->polar_table("SOLVER_STATUS")->as_polar_table_int()->values(),
+            new_solver_status->values());
+
+  auto hybrid_polar = make_polar("HPPP", HPPP, dimension_grid);
+  hybrid_polar->attach_polar_table(total_power->copy());
+  hybrid_polar->attach_polar_table(leeway->copy());
+  ASSERT_ANY_THROW(make_velocity_polar(*hybrid_polar, power_values));
+  hybrid_polar->attach_polar_table(solver_status->copy());
+  ASSERT_EQ(make_velocity_polar(*hybrid_polar, power_values)->mode(), HVPP);
+  ASSERT_ANY_THROW(make_velocity_polar(*velocity_polar, power_values));
+}
+
+TEST(poem, polar_set_query) {
+  auto STW_dim = make_dimension("STW_dim", "kt", "Speed Through Water");
+  auto TWS_dim = make_dimension("TWS_dim", "kt", "True Wind Speed");
+  auto TWA_dim = make_dimension("TWA_dim", "deg", "True Wind Angle", SYMMETRIC);
+  auto WA_dim = make_dimension("WA_dim", "deg", "Waves Angle");
+  auto Hs_dim = make_dimension("Hs_dim", "m", "Waves Significant Height");
+
+  auto dimension_grid = make_dimension_grid(make_dimension_set({STW_dim, TWS_dim, TWA_dim, WA_dim, Hs_dim}));
+  dimension_grid->set_values("STW_dim", mathutils::linspace<double>(4, 16, 13));
+  dimension_grid->set_values("TWS_dim", mathutils::linspace<double>(0, 40, 5));
+  dimension_grid->set_values("TWA_dim", mathutils::linspace<double>(0, 180, 7));
+  dimension_grid->set_values("WA_dim", mathutils::linspace<double>(0, 180, 3));
+  dimension_grid->set_values("Hs_dim", mathutils::linspace<double>(0, 4, 3));
+
+  // Wind assistance lowers the power of the hybrid mode, except upwind where it does not converge
+  auto make_power_polar = [&](POLAR_MODE mode, double wind_factor) {
+    auto polar = make_polar(polar_mode_to_string(mode), mode, dimension_grid);
+    auto total_power = polar->create_polar_table<double>("TOTAL_POWER", "kW", "Total Power", POEM_DOUBLE);
+    auto leeway = polar->create_polar_table<double>("LEEWAY", "deg", "Leeway", POEM_DOUBLE);
+    auto solver_status = polar->create_polar_table<int>("SOLVER_STATUS", "-", "Solver Status", POEM_INT);
+    size_t idx = 0;
+    for (const auto &dimension_point: dimension_grid->dimension_points()) {
+      double STW = dimension_point[0];
+      double assistance = wind_factor * dimension_point[1] * std::sin(M_PI * dimension_point[2] / 180.);
+      total_power->set_value(idx, 10. * STW * STW * STW * (1. + 0.1 * dimension_point[4]) + 100. - assistance);
+      leeway->set_value(idx, 0.);
+      solver_status->set_value(idx, wind_factor > 0. && dimension_point[2] == 0. ? 1 : 0);
+      idx++;
+    }
+    return polar;
+  };
+  auto MPPP_polar = make_power_polar(MPPP, 0.);
+  auto HPPP_polar = make_power_polar(HPPP, 15.);
+
+  auto environment_grid = make_dimension_grid(make_dimension_set({TWS_dim, TWA_dim, WA_dim, Hs_dim}));
+  for (const auto &name: {"TWS_dim", "TWA_dim", "WA_dim", "Hs_dim"}) {
+    environment_grid->set_values(name, dimension_grid->values(name));
+  }
+  auto VPP_polar = make_polar("VPP", VPP, environment_grid);
+  auto VPP_STW = VPP_polar->create_polar_table<double>("STW", "kt", "Speed Through Water", POEM_DOUBLE);
+  auto VPP_leeway = VPP_polar->create_polar_table<double>("LEEWAY", "deg", "Leeway", POEM_DOUBLE);
+  auto VPP_solver_status = VPP_polar->create_polar_table<int>("SOLVER_STATUS", "-", "Solver Status", POEM_INT);
+  size_t idx = 0;
+  for (const auto &dimension_point: environment_grid->dimension_points()) {
+    VPP_STW->set_value(idx, 0.3 * dimension_point[0] * std::sin(M_PI * dimension_point[1] / 180.));
+    VPP_leeway->set_value(idx, 0.);
+    VPP_solver_status->set_value(idx, dimension_point[0] == 0. ? 1 : 0);
+    idx++;
+  }
+
+  auto polar_set = make_polar_set("polar_set", "");
+  polar_set->attach_polar(MPPP_polar);
+  polar_set->attach_polar(HPPP_polar);
+  auto power_values = mathutils::linspace<double>(0., 45000., 31);
+  polar_set->attach_polar(make_velocity_polar(*MPPP_polar, power_values));
+  polar_set->attach_polar(make_velocity_polar(*HPPP_polar, power_values));
+  polar_set->attach_polar(VPP_polar);
+
+  // Failed nodes as a double table: its multilinear interpolation is not null where a corner contributing to the
+  // interpolated values has failed
+  for (auto mode: {MPPP, HPPP, MVPP, HVPP, VPP}) {
+    auto polar = polar_set->polar(mode);
+    auto status = polar->polar_table("SOLVER_STATUS")->as_polar_table_int();
+    auto failed = polar->create_polar_table<double>("FAILED", "-", "Failed nodes", POEM_DOUBLE);
+    for (size_t i = 0; i < status->size(); ++i) {
+      failed->set_value(i, status->values()[i] != 0 ? 1. : 0.);
+    }
+  }
+
+  PolarSetQuery query(*polar_set);
+  ASSERT_EQ(query.environment_dimension_names(), std::vector<std::string>({"TWS_dim", "TWA_dim", "WA_dim", "Hs_dim"}));
+  ASSERT_EQ(query.speed_modes(), std::vector<POLAR_MODE>({MPPP, HPPP, VPP}));
+  ASSERT_EQ(query.power_modes(), std::vector<POLAR_MODE>({MVPP, HVPP, VPP}));
+
+  // Random environments, TWA given over the full circle
+  const size_t n_points = 1000;
+  std::vector<std::vector<double>> environment(4, std::vector<double>(n_points));
+  std::vector<double> STW(n_points), power(n_points);
+  std::srand(0);
+  auto random = [](double min, double max) { return min + (max - min) * std::rand() / RAND_MAX; };
+  for (size_t i = 0; i < n_points; ++i) {
+    environment[0][i] = random(0., 40.);
+    environment[1][i] = random(-180., 180.);
+    environment[2][i] = random(0., 180.);
+    environment[3][i] = random(0., 4.);
+    STW[i] = random(4., 16.);
+    power[i] = random(0., 45000.);
+  }
+  std::vector<const double *> environment_ptrs;
+  for (const auto &coords: environment) environment_ptrs.push_back(coords.data());
+
+  // Reference from the fused query of each Polar
+  auto reference = [&](POLAR_MODE mode, double target, size_t i, const std::string &name) {
+    auto polar = polar_set->polar(mode);
+    std::vector<double> coords;
+    if (mode != VPP) coords.push_back(target);
+    for (const auto &coords_: environment) coords.push_back(coords_[i]);
+    auto results = polar->interp(DimensionPoint(polar->dimension_grid()->dimension_set(), coords),
+                                 {name, "FAILED"}, ERROR);
+    return results[1] == 0. ? results[0] : NAN;
+  };
+
+  std::vector<int> modes(n_points);
+  std::vector<double> powers(n_points);
+  query.select_at_speed(environment_ptrs, STW.data(), n_points, modes.data(), powers.data(), ERROR);
+  size_t n_MPPP = 0, n_HPPP = 0, n_VPP = 0;
+  for (size_t i = 0; i < n_points; ++i) {
+    double MPPP_power = reference(MPPP, STW[i], i, "TOTAL_POWER");
+    double HPPP_power = reference(HPPP, STW[i], i, "TOTAL_POWER");
+    double VPP_STW_ = reference(VPP, STW[i], i, "STW");
+    if (VPP_STW_ >= STW[i]) {
+      ASSERT_EQ(modes[i], VPP);
+      ASSERT_EQ(powers[i], 0.);
+      n_VPP++;
+    } else if (HPPP_power < MPPP_power) {
+      ASSERT_EQ(modes[i], HPPP);
+      ASSERT_DOUBLE_EQ(powers[i], HPPP_power);
+      n_HPPP++;
+    } else {
+      ASSERT_EQ(modes[i], MPPP);
+      ASSERT_DOUBLE_EQ(powers[i], MPPP_power);
+      n_MPPP++;
+    }
+  }
+  ASSERT_GT(n_MPPP, 0);
+  ASSERT_GT(n_HPPP, 0);
+  ASSERT_GT(n_VPP, 0);
+
+  std::vector<double> STWs(n_points);
+  query.select_at_power(environment_ptrs, power.data(), n_points, modes.data(), STWs.data(), ERROR, 0);
+  for (size_t i = 0; i < n_points; ++i) {
+    double best = NAN;
+    int best_mode = NO_FEASIBLE_MODE;
+    for (auto mode: {MVPP, HVPP, VPP}) {
+      double STW_ = reference(mode, power[i], i, "STW");
+      if (!std::isnan(STW_) && (best_mode == NO_FEASIBLE_MODE || STW_ > best)) {
+        best = STW_;
+        best_mode = mode;
+      }
+    }
+    ASSERT_EQ(modes[i], best_mode);
+    if (best_mode == NO_FEASIBLE_MODE) {
+      ASSERT_TRUE(std::isnan(STWs[i]));
+    } else {
+      ASSERT_DOUBLE_EQ(STWs[i], best);
+    }
+  }
+
+  // A failed node contributing to the interpolated value masks the mode, even if the nearest node converged
+  auto HPPP_status = HPPP_polar->polar_table("SOLVER_STATUS")->as_polar_table_int();
+  idx = 0;
+  for (const auto &dimension_point: dimension_grid->dimension_points()) {
+    if (dimension_point[2] == 60.) HPPP_status->set_value(idx, 1);
+    idx++;
+  }
+  std::vector<double> environment_point = {20., 40., 90., 2.};
+  std::vector<const double *> environment_point_ptrs;
+  for (const auto &coord: environment_point) environment_point_ptrs.push_back(&coord);
+  double target_STW = 10.;
+  query.select_at_speed(environment_point_ptrs, &target_STW, 1, modes.data(), powers.data(), ERROR);
+  ASSERT_EQ(modes[0], MPPP);
+  // On the converged node, the failed neighbour has a null weight
+  environment_point[1] = 30.;
+  query.select_at_speed(environment_point_ptrs, &target_STW, 1, modes.data(), powers.data(), ERROR);
+  ASSERT_EQ(modes[0], HPPP);
+
+  // Only multilinear interpolation of the values is supported
+  HPPP_polar->polar_table("TOTAL_POWER")->set_interpolation_method(AKIMA);
+  ASSERT_THROW(query.select_at_speed(environment_point_ptrs, &target_STW, 1, modes.data(), powers.data(), ERROR),
+               PoemException);
+  HPPP_polar->polar_table("TOTAL_POWER")->set_interpolation_method(LINEAR);
+
+  // Out of bound target
+  double high_STW = 30.;
+  ASSERT_ANY_THROW(query.select_at_speed(environment_ptrs, &high_STW, 1, modes.data(), powers.data(), ERROR));
+  ASSERT_ANY_THROW(query.select_at_speed({environment_ptrs[0]}, STW.data(), 1, modes.data(), powers.data(), ERROR));
+}
+
+TEST(poem, vmg_envelope) {
+  auto TWS_dim = make_dimension("TWS_dim", "kt", "True Wind Speed");
+  auto TWA_dim = make_dimension("TWA_dim", "deg", "True Wind Angle", SYMMETRIC);
+  auto WA_dim = make_dimension("WA_dim", "deg", "Waves Angle");
+  auto Hs_dim = make_dimension("Hs_dim", "m", "Waves Significant Height");
+
+  auto dimension_grid = make_dimension_grid(make_dimension_set({TWS_dim, TWA_dim, WA_dim, Hs_dim}));
+  dimension_grid->set_values("TWS_dim", mathutils::linspace<double>(0, 30, 4));
+  dimension_grid->set_values("TWA_dim", mathutils::linspace<double>(0, 180, 19));
+  dimension_grid->set_values("WA_dim", mathutils::linspace<double>(0, 180, 3));
+  dimension_grid->set_values("Hs_dim", mathutils::linspace<double>(0, 4, 3));
+
+  auto polar = make_polar("VPP", VPP, dimension_grid);
+  auto STW = polar->create_polar_table<double>("STW", "kt", "Speed Through Water", POEM_DOUBLE);
+  auto solver_status = polar->create_polar_table<int>("SOLVER_STATUS", "-", "Solver Status", POEM_INT);
+  size_t idx = 0;
+  for (const auto &dimension_point: dimension_grid->dimension_points()) {
+    double TWA = dimension_point[1];
+    STW->set_value(idx, 0.4 * dimension_point[0] * std::sin(M_PI * TWA / 180.) * (1. - 0.05 * dimension_point[3]));
+    // No convergence head to wind and dead downwind in strong wind
+    solver_status->set_value(idx, TWA == 0. || (TWA == 180. && dimension_point[0] == 30.) ? 1 : 0);
+    idx++;
+  }
+
+  ASSERT_FALSE(polar->is_vmg_envelope_up_to_date());
+  polar->update_vmg_envelope();
+  ASSERT_TRUE(polar->is_vmg_envelope_up_to_date());
+
+  // Brute force sweep of the interpolated STW along TWA between valid nodes
+  auto check = [&]() {
+    auto upwind_VMG = polar->polar_table("UPWIND_VMG")->as_polar_table_double();
+    auto upwind_TWA = polar->polar_table("UPWIND_TWA")->as_polar_table_double();
+    auto downwind_VMG = polar->polar_table("DOWNWIND_VMG")->as_polar_table_double();
+    auto downwind_STW = polar->polar_table("DOWNWIND_STW")->as_polar_table_double();
+    for (double TWS: {0., 10., 20., 30.}) {
+      for (double Hs: {0., 2.}) {
+        double max_upwind = 0., max_downwind = 0.;
+        for (double TWA = 10.; TWA <= 180.; TWA += 0.01) {
+          if (TWS == 30. && TWA > 170.) break;
+          double STW_ = STW->interp(DimensionPoint(dimension_grid->dimension_set(), {TWS, TWA, 90., Hs}), ERROR);
+          max_upwind = std::max(max_upwind, STW_ * std::cos(M_PI * TWA / 180.));
+          max_downwind = std::max(max_downwind, -STW_ * std::cos(M_PI * TWA / 180.));
+        }
+
+        for (double TWA: {0., 45., 180.}) {
+          DimensionPoint point(dimension_grid->dimension_set(), {TWS, TWA, 90., Hs});
+          ASSERT_NEAR(upwind_VMG->interp(point, ERROR), max_upwind, 1e-6);
+          ASSERT_NEAR(downwind_VMG->interp(point, ERROR), max_downwind, 1e-6);
+          if (TWS > 0.) {
+            double TWA_ = upwind_TWA->interp(point, ERROR);
+            ASSERT_GT(TWA_, 10.);
+            ASSERT_LT(TWA_, 90.);
+            double STW_ = STW->interp(DimensionPoint(dimension_grid->dimension_set(), {TWS, TWA_, 90., Hs}), ERROR);
+            ASSERT_NEAR(STW_ * std::cos(M_PI * TWA_ / 180.), max_upwind, 1e-6);
+            ASSERT_GT(downwind_STW->interp(point, ERROR), 0.);
+          }
+        }
+      }
+    }
+  };
+  check();
+
+  // Invalidated by a modification of the source table, and by parallel or sequential computations alike
+  STW->multiply_by(1.1);
+  ASSERT_FALSE(polar->is_vmg_envelope_up_to_date());
+  polar->update_vmg_envelope(1);
+  ASSERT_TRUE(polar->is_vmg_envelope_up_to_date());
+  check();
+
+  // Invalidated by a modification of the envelope
+  polar->polar_table("UPWIND_VMG")->as_polar_table_double()->set_value(0, 0.);
+  ASSERT_FALSE(polar->is_vmg_envelope_up_to_date());
+  polar->update_vmg_envelope();
+  check();
+
+  // Units of the envelope taken from STW and TWA_dim, which must be in deg
+  ASSERT_EQ(polar->polar_table("UPWIND_VMG")->unit(), "kt");
+  ASSERT_EQ(polar->polar_table("DOWNWIND_TWA")->unit(), "deg");
+  auto SI_polar = make_polar("VPP", VPP, dimension_grid);
+  SI_polar->create_polar_table<double>("STW", "m/s", "Speed Through Water", POEM_DOUBLE);
+  SI_polar->update_vmg_envelope();
+  ASSERT_EQ(SI_polar->polar_table("UPWIND_VMG")->unit(), "m/s");
+  ASSERT_EQ(SI_polar->polar_table("UPWIND_STW")->unit(), "m/s");
+
+  auto TWA_rad_dim = make_dimension("TWA_dim", "rad", "True Wind Angle");
+  auto rad_grid = make_dimension_grid(make_dimension_set({TWS_dim, TWA_rad_dim}));
+  rad_grid->set_values("TWS_dim", {0., 10.});
+  rad_grid->set_values("TWA_dim", {0., 1., 2., 3.});
+  auto rad_polar = make_polar("VPP", VPP, rad_grid);
+  rad_polar->create_polar_table<double>("STW", "kt", "Speed Through Water", POEM_DOUBLE);
+  ASSERT_ANY_THROW(rad_polar->update_vmg_envelope());
+
+  auto power_polar = make_polar("MPPP", MPPP, dimension_grid);
+  ASSERT_ANY_THROW(power_polar->update_vmg_envelope());
+}
+
+TEST(poem, chunk_reader) {
+  const std::string filename = "poem_testing_chunks.h5";
+  const hsize_t dims[2] = {40, 50};
+  std::vector<double> source(dims[0] * dims[1]);
+  std::vector<int> source_int(source.size());
+  for (size_t i = 0; i < source.size(); ++i) {
+    source[i] = 0.5 * (double) i - 100.;
+    source_int[i] = (int) i - 100;
+  }
+
+  // Variables written with the HDF5 C API, edge chunks overlapping the end of the variables
+  const hsize_t chunk_dims[2] = {7, 9};
+  hid_t file = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  hid_t space = H5Screate_simple(2, dims, nullptr);
+  auto write = [&](const char *name, hid_t file_type, hid_t memory_type, const void *values, auto &&set_storage) {
+    hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    set_storage(dcpl);
+    hid_t dataset = H5Dcreate2(file, name, file_type, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    ASSERT_GE(H5Dwrite(dataset, memory_type, H5S_ALL, H5S_ALL, H5P_DEFAULT, values), 0);
+    H5Dclose(dataset);
+    H5Pclose(dcpl);
+  };
+  auto shuffle_deflate = [&](hid_t dcpl) {
+    H5Pset_chunk(dcpl, 2, chunk_dims);
+    H5Pset_shuffle(dcpl);
+    H5Pset_deflate(dcpl, 5);
+  };
+  write("DOUBLE", H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE, source.data(), shuffle_deflate);
+  write("INT", H5T_NATIVE_INT, H5T_NATIVE_INT, source_int.data(), [&](hid_t dcpl) {
+    H5Pset_chunk(dcpl, 2, chunk_dims);
+    H5Pset_deflate(dcpl, 1);
+  });
+  // Variables left to the fallback: contiguous layout, non native type, unsupported filter
+  write("CONTIGUOUS", H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE, source.data(), [](hid_t dcpl) {
+    H5Pset_layout(dcpl, H5D_CONTIGUOUS);
+  });
+  write("BIG_ENDIAN", H5T_IEEE_F64BE, H5T_NATIVE_DOUBLE, source.data(), shuffle_deflate);
+  write("CHECKSUM", H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE, source.data(), [&](hid_t dcpl) {
+    shuffle_deflate(dcpl);
+    H5Pset_fletcher32(dcpl);
+  });
+  H5Sclose(space);
+  H5Fclose(file);
+
+  auto read = [&](size_t batch_size) {
+    const std::vector<std::string> names = {"DOUBLE", "CONTIGUOUS", "BIG_ENDIAN", "CHECKSUM", "MISSING"};
+    std::vector<std::vector<double>> values(names.size(), std::vector<double>(source.size(), 0.));
+    std::vector<int> values_int(source.size(), 0);
+    std::vector<std::string> fallbacks;
+
+    ChunkReader chunk_reader(filename, 4, batch_size);
+    for (size_t i = 0; i < names.size(); ++i) {
+      chunk_reader.schedule("/" + names[i], values[i].data(), source.size(), [&, i]() {
+        fallbacks.push_back(names[i]);
+      });
+    }
+    chunk_reader.schedule("/INT", values_int.data(), source.size(), [&]() { fallbacks.push_back("INT"); });
+    chunk_reader.read();
+
+    ASSERT_EQ(values[0], source);
+    ASSERT_EQ(values_int, source_int);
+    ASSERT_EQ(fallbacks, std::vector<std::string>({"CONTIGUOUS", "BIG_ENDIAN", "CHECKSUM", "MISSING"}));
+  };
+
+  // Every chunk in one batch, then batches of a few chunks decoded while the next ones are read
+  read(ChunkReader::default_batch_size);
+  read(256);
+  read(1);
+}
+
+TEST(poem, jit_load) {
+  auto STW_dim = make_dimension("STW_dim", "kt", "Speed Through Water");
+  auto TWA_dim = make_dimension("TWA_dim", "deg", "True Wind Angle");
+  auto dimension_grid = make_dimension_grid(make_dimension_set({STW_dim, TWA_dim}));
+  dimension_grid->set_values("STW_dim", mathutils::linspace<double>(0, 20, 21));
+  dimension_grid->set_values("TWA_dim", mathutils::linspace<double>(0, 180, 13));
+
+  auto polar_table = make_polar_table_double("TOTAL_POWER", "kW", "Total Power", dimension_grid);
+  size_t idx = 0;
+  for (const auto &dimension_point: dimension_grid->dimension_points()) {
+    polar_table->set_value(idx++, dimension_point[0] * dimension_point[0] + dimension_point[1]);
+  }
+  auto source = polar_table->values();
+  DimensionPoint point(dimension_grid->dimension_set(), {10.5, 95.});
+  double expected = polar_table->interp(point, ERROR);
+  // Tables without loader are not tracked
+  ASSERT_EQ(polar_table->last_access(), 0);
+
+  // In memory loader standing for a file, counting the fetches
+  std::atomic<int> n_loads(0);
+  polar_table->set_jit_loader([&](double *values) {
+    n_loads++;
+    std::copy(source.begin(), source.end(), values);
+  });
+  ASSERT_TRUE(polar_table->has_jit_loader());
+  ASSERT_FALSE(polar_table->is_loaded());
+  ASSERT_EQ(polar_table->memsize(), sizeof(PolarTable<double>));
+  size_t version = polar_table->version();
+
+  // Fetched once by concurrent first queries
+  std::vector<std::thread> threads;
+  for (int ithread = 0; ithread < 4; ++ithread) {
+    threads.emplace_back([&]() { ASSERT_EQ(polar_table->interp(point, ERROR), expected); });
+  }
+  for (auto &thread: threads) thread.join();
+  ASSERT_EQ(n_loads, 1);
+  ASSERT_TRUE(polar_table->is_loaded());
+  ASSERT_GT(polar_table->memsize(), source.size() * sizeof(double));
+
+  polar_table->jit_unload();
+  ASSERT_FALSE(polar_table->is_loaded());
+  ASSERT_EQ(std::as_const(*polar_table).values(), source);
+  ASSERT_EQ(n_loads, 2);
+  // Loading is not a modification
+  ASSERT_EQ(polar_table->version(), version);
+
+  // Warming up does not fetch values not resident
+  polar_table->jit_unload();
+  polar_table->warm_up();
+  ASSERT_FALSE(polar_table->is_loaded());
+  ASSERT_EQ(n_loads, 2);
+
+  // Views and reductions keep the table pinned against concurrent evictions
+  std::atomic<bool> stop(false);
+  std::thread evicter([&]() {
+    while (!stop) polar_table->try_evict();
+  });
+  double source_max = *std::max_element(source.begin(), source.end());
+  for (int i = 0; i < 1000; ++i) {
+    auto values = polar_table->view();
+    EXPECT_EQ(values[values.size() - 1], source.back());
+    EXPECT_EQ(polar_table->max(), source_max);
+    EXPECT_TRUE(*polar_table == *polar_table);
+  }
+  stop = true;
+  evicter.join();
+
+  // Detached from the loader once modified
+  int n_loads_before = n_loads;
+  polar_table->jit_unload();
+  polar_table->multiply_by(2.);
+  ASSERT_EQ(n_loads, n_loads_before + 1);
+  ASSERT_FALSE(polar_table->has_jit_loader());
+  polar_table->jit_unload();
+  ASSERT_TRUE(polar_table->is_loaded());
+  ASSERT_EQ(polar_table->interp(point, ERROR), 2. * expected);
+}
+
+TEST(poem, memory_budget) {
+  auto STW_dim = make_dimension("STW_dim", "kt", "Speed Through Water");
+  auto TWA_dim = make_dimension("TWA_dim", "deg", "True Wind Angle");
+  auto dimension_grid = make_dimension_grid(make_dimension_set({STW_dim, TWA_dim}));
+  dimension_grid->set_values("STW_dim", mathutils::linspace<double>(0, 20, 21));
+  dimension_grid->set_values("TWA_dim", mathutils::linspace<double>(0, 180, 13));
+
+  auto polar = make_polar("MPPP", MPPP, dimension_grid);
+  std::vector<std::shared_ptr<PolarTable<double>>> polar_tables;
+  std::vector<std::vector<double>> sources;
+  std::vector<std::atomic<int>> n_loads(3);
+  for (int itable = 0; itable < 3; ++itable) {
+    auto polar_table = polar->create_polar_table<double>("TABLE_" + std::to_string(itable), "-", "Table",
+                                                         POEM_DOUBLE);
+    size_t idx = 0;
+    for (const auto &dimension_point: dimension_grid->dimension_points()) {
+      polar_table->set_value(idx++, (itable + 1) * dimension_point[0] + dimension_point[1]);
+    }
+    sources.push_back(std::as_const(*polar_table).values());
+    // In memory loaders standing for a file, counting the fetches
+    polar_table->set_jit_loader([&, itable](double *values) {
+      n_loads[itable]++;
+      std::copy(sources[itable].begin(), sources[itable].end(), values);
+    });
+    polar_tables.push_back(polar_table);
+  }
+
+  auto &memory_manager = MemoryManager::instance();
+  memory_manager.track(polar, "memory_budget_test");
+  DimensionPoint point(dimension_grid->dimension_set(), {10.5, 95.});
+  auto query = [&](int itable) {
+    ASSERT_EQ(polar_tables[itable]->interp(point, ERROR), (itable + 1) * 10.5 + 95.);
+  };
+
+  // Room for two loaded tables
+  size_t unloaded_size = polar_tables[0]->memsize();
+  query(0);
+  size_t loaded_size = polar_tables[0]->memsize();
+  ASSERT_GT(loaded_size, unloaded_size);
+  memory_manager.set_budget(dimension_grid->memsize() + 2 * loaded_size + unloaded_size);
+
+  // The least recently queried table is evicted
+  query(1);
+  query(2);
+  ASSERT_FALSE(polar_tables[0]->is_loaded());
+  ASSERT_TRUE(polar_tables[1]->is_loaded());
+  ASSERT_TRUE(polar_tables[2]->is_loaded());
+  ASSERT_LE(memory_manager.resident_size(), memory_manager.budget());
+
+  query(0);
+  ASSERT_TRUE(polar_tables[0]->is_loaded());
+  ASSERT_FALSE(polar_tables[1]->is_loaded());
+  ASSERT_EQ(n_loads[0], 2);
+
+  auto statistics = memory_manager.statistics().at("memory_budget_test");
+  ASSERT_EQ(statistics.n_tables, 3);
+  ASSERT_EQ(statistics.n_resident, 2);
+  ASSERT_EQ(statistics.n_loads, 4);
+  ASSERT_EQ(statistics.n_reloads, 1);
+  ASSERT_EQ(statistics.n_evictions, 2);
+  ASSERT_EQ(statistics.resident_size, memory_manager.resident_size());
+
+  // Concurrent queries under a budget of one table, evictions never happening under a running query
+  memory_manager.set_budget(dimension_grid->memsize() + loaded_size + 2 * unloaded_size);
+  std::vector<std::thread> threads;
+  for (int ithread = 0; ithread < 4; ++ithread) {
+    threads.emplace_back([&, ithread]() {
+      for (int i = 0; i < 200; ++i) query((ithread + i) % 3);
+    });
+  }
+  for (auto &thread: threads) thread.join();
+
+  memory_manager.set_budget(0);
+  memory_manager.reset_statistics();
+}
+
+TEST(poem, snapshot) {
+  auto STW_dim = make_dimension("STW_dim", "kt", "Speed Through Water");
+  auto TWA_dim = make_dimension("TWA_dim", "deg", "True Wind Angle", SYMMETRIC);
+  auto dimension_grid = make_dimension_grid(make_dimension_set({STW_dim, TWA_dim}));
+  dimension_grid->set_values("STW_dim", mathutils::linspace<double>(0, 20, 21));
+  dimension_grid->set_values("TWA_dim", mathutils::linspace<double>(0, 180, 13));
+
+  auto vessel = make_polar_node("vessel", "my vessel");
+  vessel->attributes().add_attribute("VESSEL_NAME", "vessel");
+  auto polar_set = make_polar_set("ballast", "Ballast load case");
+  vessel->add_child(polar_set);
+  auto polar = polar_set->create_polar(MPPP, dimension_grid);
+  auto total_power = polar->create_polar_table<double>("TOTAL_POWER", "kW", "Total Power", POEM_DOUBLE);
+  auto leeway = polar->create_polar_table<double>("LEEWAY", "deg", "Leeway", POEM_DOUBLE);
+  auto solver_status = polar->create_polar_table<int>("SOLVER_STATUS", "-", "Solver Status", POEM_INT);
+  size_t idx = 0;
+  for (const auto &dimension_point: dimension_grid->dimension_points()) {
+    total_power->set_value(idx, dimension_point[0] * dimension_point[0] + dimension_point[1]);
+    leeway->set_value(idx, 0.1 * dimension_point[1]);
+    solver_status->set_value(idx, (int) (idx % 3));
+    idx++;
+  }
+  total_power->set_interpolation_method(CUBIC);
+  total_power->attributes().add_attribute("source", "towing tank");
+  // Packed tables are written contiguously
+  polar->pack();
+
+  to_snapshot(vessel, "snapshot.poem");
+  auto vessel_ = load_snapshot("snapshot.poem", true);
+
+  std::vector<std::shared_ptr<PolarTableBase>> polar_tables, polar_tables_;
+  vessel->polar_tables(polar_tables);
+  vessel_->polar_tables(polar_tables_);
+  ASSERT_EQ(polar_tables.size(), polar_tables_.size());
+  for (size_t i = 0; i < polar_tables.size(); ++i) {
+    ASSERT_EQ(polar_tables[i]->full_name(), polar_tables_[i]->full_name());
+    ASSERT_EQ(*polar_tables[i], *polar_tables_[i]);
+    ASSERT_EQ(polar_tables[i]->unit(), polar_tables_[i]->unit());
+    ASSERT_EQ(polar_tables[i]->description(), polar_tables_[i]->description());
+    ASSERT_EQ(polar_tables[i]->attributes(), polar_tables_[i]->attributes());
+    ASSERT_EQ(polar_tables[i]->interpolation_method(), polar_tables_[i]->interpolation_method());
+  }
+  ASSERT_EQ(*vessel_, *vessel);
+  ASSERT_EQ(vessel_->polar_node_from_path("vessel/ballast")->description(), "Ballast load case");
+  auto polar_ = vessel_->polar_node_from_path("vessel/ballast/MPPP")->as_polar();
+  ASSERT_EQ(polar_->mode(), MPPP);
+  ASSERT_EQ(polar_->dimension_grid()->dimension_set()->dimension("TWA_dim")->periodicity(), SYMMETRIC);
+  // Tables of a Polar still share its DimensionGrid
+  ASSERT_EQ(polar_->polar_table("LEEWAY")->dimension_grid(), polar_->dimension_grid());
+
+  // Values read in place from the mapping, which outlives the tree root
+  auto total_power_ = polar_->polar_table("TOTAL_POWER")->as_polar_table_double();
+  vessel_.reset();
+  polar_.reset();
+  ASSERT_TRUE(total_power_->is_packed());
+  ASSERT_EQ(total_power_->stride(), 1);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(total_power_->data()) % 64, 0);
+  DimensionPoint point(dimension_grid->dimension_set(), {10.5, 275.});
+  DimensionPoint point_(total_power_->dimension_grid()->dimension_set(), {10.5, 275.});
+  ASSERT_EQ(total_power_->interp(point_, ERROR), total_power->interp(point, ERROR));
+
+  // Same content, same hash
+  to_snapshot(load_snapshot("snapshot.poem"), "snapshot_.poem");
+  ASSERT_EQ(snapshot_hash("snapshot_.poem"), snapshot_hash("snapshot.poem"));
+
+  // Modified in memory only
+  total_power_->multiply_by(2.);
+  ASSERT_FALSE(total_power_->is_packed());
+  ASSERT_EQ(total_power_->interp(point_, ERROR), 2. * total_power->interp(point, ERROR));
+  ASSERT_EQ(snapshot_hash("snapshot.poem"), snapshot_hash("snapshot_.poem"));
+
+  // Corrupted values, only detected by the hash
+  {
+    std::fstream file("snapshot_.poem", std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(-100, std::ios::end);
+    file.put('x');
+  }
+  ASSERT_NO_THROW(load_snapshot("snapshot_.poem"));
+  ASSERT_THROW(load_snapshot("snapshot_.poem", true), PoemException);
+  std::ofstream("not_a_snapshot.poem") << std::string(100, 'x');
+  ASSERT_THROW(load_snapshot("not_a_snapshot.poem"), PoemException);
+}